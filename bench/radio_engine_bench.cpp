@@ -0,0 +1,519 @@
+// Headless benchmark for RadioEngine. Generates a synthetic library, runs the engine with MCI
+// stubbed out, and prints one JSON object per line so runs can be diffed across releases:
+//
+//   {"bench":"scan_cold","files":10000,"threads":1,"iterations":5,"mean_ms":...,"p50_ms":...,
+//    "p95_ms":...,"max_ms":...}
+//
+// Usage: RadioSFSEBench [--files N[,N...]] [--iterations N] [--threads N] [--work-dir PATH]
+
+#include "logger.h"
+#include "radio_engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t kFilesPerFolder = 100;
+constexpr std::size_t kLookupsPerIteration = 10000;
+constexpr std::size_t kShuffleStepsPerIteration = 10000;
+constexpr std::size_t kCommandsPerThread = 200;
+constexpr std::uint64_t kBenchDeviceIdBase = 0x0001'0000'0000ULL;
+constexpr std::uint32_t kMciInvalidDeviceName = 263;
+constexpr std::uint32_t kStubTrackLengthMs = 180000;
+constexpr std::size_t kStallChecksPerIteration = 10000;
+// Longer than the engine's stall timeout, sampled once a second like a slow safety poll.
+constexpr auto kStallFreezeWindow = std::chrono::seconds(60);
+
+struct Options
+{
+    std::vector<std::size_t> fileCounts{ 1000, 10000, 100000 };
+    std::size_t iterations{ 5 };
+    std::size_t threads{ 4 };
+    std::filesystem::path workDir{ std::filesystem::temp_directory_path() / "RadioSFSEBench" };
+};
+
+// Stand-in for winmm: every alias answers like a device that opened and plays instantly.
+struct StubDevice
+{
+    bool playing{ false };
+    std::chrono::steady_clock::time_point startedAt{};
+};
+
+std::mutex g_stubMutex;
+std::unordered_map<std::wstring, StubDevice> g_stubDevices;
+
+std::vector<std::wstring> splitCommand(const wchar_t* command)
+{
+    std::vector<std::wstring> tokens;
+    std::wstring current;
+    bool quoted = false;
+    for (const wchar_t* c = command; *c != L'\0'; ++c) {
+        if (*c == L'"') {
+            quoted = !quoted;
+        } else if (*c == L' ' && !quoted) {
+            if (!current.empty()) {
+                tokens.push_back(std::move(current));
+                current.clear();
+            }
+        } else {
+            current.push_back(*c);
+        }
+    }
+    if (!current.empty()) {
+        tokens.push_back(std::move(current));
+    }
+    return tokens;
+}
+
+void writeOutput(wchar_t* output, std::uint32_t outputSize, const std::wstring& text)
+{
+    if (output == nullptr || outputSize == 0) {
+        return;
+    }
+    const std::size_t count = std::min<std::size_t>(text.size(), outputSize - 1);
+    std::copy_n(text.begin(), count, output);
+    output[count] = L'\0';
+}
+
+std::uint32_t stubMciSendString(const wchar_t* command, wchar_t* output, std::uint32_t outputSize, void*)
+{
+    const std::vector<std::wstring> tokens = splitCommand(command);
+    if (tokens.size() < 2) {
+        return kMciInvalidDeviceName;
+    }
+
+    std::lock_guard<std::mutex> lock(g_stubMutex);
+    const std::wstring& verb = tokens[0];
+    if (verb == L"open") {
+        const auto aliasIt = std::find(tokens.begin(), tokens.end(), L"alias");
+        if (aliasIt == tokens.end() || aliasIt + 1 == tokens.end()) {
+            return kMciInvalidDeviceName;
+        }
+        g_stubDevices[*(aliasIt + 1)] = StubDevice{};
+        return 0;
+    }
+
+    const auto deviceIt = g_stubDevices.find(tokens[1]);
+    if (deviceIt == g_stubDevices.end()) {
+        return kMciInvalidDeviceName;
+    }
+    StubDevice& device = deviceIt->second;
+    if (verb == L"close") {
+        g_stubDevices.erase(deviceIt);
+    } else if (verb == L"play") {
+        device.playing = true;
+        device.startedAt = std::chrono::steady_clock::now();
+    } else if (verb == L"stop" || verb == L"pause") {
+        device.playing = false;
+    } else if (verb == L"status" && tokens.size() >= 3) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - device.startedAt);
+        if (tokens[2] == L"mode") {
+            writeOutput(output, outputSize, device.playing ? L"playing" : L"stopped");
+        } else if (tokens[2] == L"length") {
+            writeOutput(output, outputSize, std::to_wstring(kStubTrackLengthMs));
+        } else if (tokens[2] == L"position") {
+            const auto position = device.playing ? std::min<long long>(elapsed.count(), kStubTrackLengthMs) : 0;
+            writeOutput(output, outputSize, std::to_wstring(position));
+        } else {
+            writeOutput(output, outputSize, L"0");
+        }
+    }
+    return 0;
+}
+
+std::uint32_t stubMciDeviceId(const wchar_t*)
+{
+    // No device ids means no MM_MCINOTIFY matching; the engine falls back to its safety poll.
+    return 0;
+}
+
+struct Timing
+{
+    std::vector<double> samplesMs;
+
+    template <typename Body>
+    void measure(Body&& body)
+    {
+        const auto startedAt = std::chrono::steady_clock::now();
+        body();
+        samplesMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startedAt).count());
+    }
+};
+
+void printResult(std::string_view bench, std::size_t files, std::size_t threads, Timing timing)
+{
+    std::vector<double>& samples = timing.samplesMs;
+    if (samples.empty()) {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (const double sample : samples) {
+        total += sample;
+    }
+    const auto at = [&samples](double fraction) {
+        const auto index = static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(index, samples.size() - 1)];
+    };
+    std::printf(
+        "{\"bench\":\"%.*s\",\"files\":%zu,\"threads\":%zu,\"iterations\":%zu,"
+        "\"mean_ms\":%.4f,\"p50_ms\":%.4f,\"p95_ms\":%.4f,\"max_ms\":%.4f}\n",
+        static_cast<int>(bench.size()),
+        bench.data(),
+        files,
+        threads,
+        samples.size(),
+        total / static_cast<double>(samples.size()),
+        at(0.50),
+        at(0.95),
+        samples.back());
+    std::fflush(stdout);
+}
+
+// Half the files go to Playlists, half to Stations; every station folder carries one transition
+// and one ad so the prefix split is exercised.
+void generateLibrary(const std::filesystem::path& root, std::size_t fileCount)
+{
+    const std::filesystem::path marker = root / ".bench_files";
+    {
+        std::ifstream in(marker);
+        std::size_t existing = 0;
+        if (in >> existing && existing == fileCount) {
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    std::size_t written = 0;
+    for (std::size_t folder = 0; written < fileCount; ++folder) {
+        const bool station = (folder % 2) == 1;
+        const std::filesystem::path directory =
+            root / (station ? "Stations" : "Playlists") / ((station ? "Station " : "Playlist ") + std::to_string(folder));
+        std::filesystem::create_directories(directory);
+        for (std::size_t i = 0; i < kFilesPerFolder && written < fileCount; ++i, ++written) {
+            std::string name = "Track " + std::to_string(i) + ".mp3";
+            if (station && i == 0) {
+                name = "transition_" + std::to_string(folder) + ".mp3";
+            } else if (station && i == 1) {
+                name = "ad_" + std::to_string(folder) + ".mp3";
+            }
+            std::ofstream(directory / name, std::ios::binary).put('\0');
+        }
+    }
+    std::ofstream(marker) << fileCount;
+}
+
+void writeConfig(const std::filesystem::path& runDir, const std::filesystem::path& radioRoot)
+{
+    const std::filesystem::path configDir = runDir / "Data" / "SFSE" / "Plugins";
+    std::filesystem::create_directories(configDir);
+    std::ofstream out(configDir / "RadioSFSE.ini", std::ios::trunc);
+    const std::u8string rootUtf8 = radioRoot.u8string();
+    out << "root_path=" << std::string(rootUtf8.begin(), rootUtf8.end()) << "\n"
+        << "log_level=error\n"
+        << "audio_backend=mci\n"
+        << "transition_prefix=transition_\n"
+        << "ad_prefix=ad_\n"
+        << "auto_rescan_on_change_playlist=false\n"
+        << "watch_library=false\n"
+        << "library_analysis_threads=0\n"
+        << "fx_cache_mb=0\n"
+        << "stats_log_minutes=0\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--files") {
+            options.fileCounts.clear();
+            std::size_t start = 0;
+            while (start <= value.size()) {
+                const std::size_t comma = std::min(value.find(',', start), value.size());
+                options.fileCounts.push_back(std::stoul(value.substr(start, comma - start)));
+                start = comma + 1;
+            }
+        } else if (arg == "--iterations") {
+            options.iterations = std::max<std::size_t>(1, std::stoul(value));
+        } else if (arg == "--threads") {
+            options.threads = std::max<std::size_t>(1, std::stoul(value));
+        } else if (arg == "--work-dir") {
+            options.workDir = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+// Friend of RadioEngine: drives the private *Locked entry points the public API only reaches
+// through the worker queue.
+class RadioEngineBench
+{
+public:
+    static inline bool failed = false;
+
+    static void run(const Options& options, std::size_t fileCount)
+    {
+        const std::filesystem::path runDir = options.workDir / std::to_string(fileCount);
+        const std::filesystem::path radioRoot = runDir / "Radio";
+        generateLibrary(radioRoot, fileCount);
+        writeConfig(runDir, radioRoot);
+        std::error_code ec;
+        std::filesystem::remove(radioRoot / "RadioSFSE.library.json", ec);
+        std::filesystem::remove(radioRoot / "RadioSFSE.session.json", ec);
+        std::filesystem::current_path(runDir);
+
+        Logger logger;
+        RadioEngine engine(logger);
+        engine.setPlaybackHooks(RadioEngine::PlaybackHooks{ &stubMciSendString, &stubMciDeviceId });
+        Timing startup;
+        startup.measure([&]() { (void)engine.initialize(); });
+        printResult("initialize", fileCount, 1, startup);
+
+        benchScan(engine, options, fileCount);
+        benchLookup(engine, options, fileCount);
+        benchShuffle(engine, options, fileCount);
+        benchCommands(engine, options, fileCount);
+        benchSession(engine, options, fileCount);
+        if (!benchStreamStall(engine, options, fileCount)) {
+            failed = true;
+        }
+
+        engine.shutdown();
+        std::filesystem::current_path(options.workDir);
+    }
+
+private:
+    static void benchScan(RadioEngine& engine, const Options& options, std::size_t fileCount)
+    {
+        Timing cold;
+        Timing warm;
+        for (std::size_t i = 0; i < options.iterations; ++i) {
+            std::lock_guard<std::mutex> lock(engine.mutex_);
+            std::error_code ec;
+            std::filesystem::remove(engine.libraryIndexPathLocked(), ec);
+            engine.libraryIndex_.clear();
+            cold.measure([&]() { (void)engine.scanLibraryLocked(); });
+            warm.measure([&]() { (void)engine.scanLibraryLocked(); });
+        }
+        printResult("scan_cold", fileCount, 1, cold);
+        printResult("scan_warm", fileCount, 1, warm);
+    }
+
+    static void benchLookup(RadioEngine& engine, const Options& options, std::size_t fileCount)
+    {
+        std::lock_guard<std::mutex> lock(engine.mutex_);
+        std::vector<std::string> names;
+        for (const auto& [key, channel] : engine.channels_) {
+            names.push_back(channel.displayName);
+            names.push_back(key);
+        }
+        names.push_back("no such channel");
+
+        Timing timing;
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < options.iterations; ++i) {
+            timing.measure([&]() {
+                for (std::size_t n = 0; n < kLookupsPerIteration; ++n) {
+                    found += engine.lookupChannelLocked(names[n % names.size()]) != nullptr ? 1 : 0;
+                }
+            });
+        }
+        printResult("lookup_channel_x10000", fileCount, 1, timing);
+        if (found == 0) {
+            std::fprintf(stderr, "lookup: no channel matched\n");
+        }
+    }
+
+    static void benchShuffle(RadioEngine& engine, const Options& options, std::size_t fileCount)
+    {
+        std::lock_guard<std::mutex> lock(engine.mutex_);
+        const RadioEngine::ChannelEntry* largest = nullptr;
+        for (const auto& [key, channel] : engine.channels_) {
+            if (largest == nullptr || channel.songs.size() > largest->songs.size()) {
+                largest = &channel;
+            }
+        }
+        if (largest == nullptr || largest->songs.empty()) {
+            return;
+        }
+
+        engine.resetShuffleOrderLocked();
+        engine.songIndex_ = 0;
+        Timing timing;
+        for (std::size_t i = 0; i < options.iterations; ++i) {
+            timing.measure([&]() {
+                for (std::size_t n = 0; n < kShuffleStepsPerIteration; ++n) {
+                    if (const auto next = engine.advanceShuffleSongLocked(*largest); next.has_value()) {
+                        engine.songIndex_ = *next;
+                    }
+                }
+            });
+        }
+        engine.resetShuffleOrderLocked();
+        printResult("shuffle_advance_x10000", fileCount, 1, timing);
+    }
+
+    // Each caller thread drives its own device, so every command also pays for switchToDeviceLocked.
+    static void benchCommands(RadioEngine& engine, const Options& options, std::size_t fileCount)
+    {
+        std::string channelName;
+        {
+            std::lock_guard<std::mutex> lock(engine.mutex_);
+            if (!engine.channels_.empty()) {
+                channelName = engine.channels_.begin()->second.displayName;
+            }
+        }
+
+        std::vector<Timing> setVolume(options.threads);
+        std::vector<Timing> changePlaylist(options.threads);
+        std::vector<Timing> playStop(options.threads);
+        std::vector<std::thread> callers;
+        for (std::size_t t = 0; t < options.threads; ++t) {
+            callers.emplace_back([&, t]() {
+                const std::uint64_t deviceId = kBenchDeviceIdBase | t;
+                for (std::size_t n = 0; n < kCommandsPerThread; ++n) {
+                    const float volume = static_cast<float>(20 + (n % 80));
+                    setVolume[t].measure([&]() { (void)engine.setVolume(volume, deviceId); });
+                    if (!channelName.empty() && (n % 10) == 0) {
+                        changePlaylist[t].measure([&]() { (void)engine.changePlaylist(channelName, deviceId); });
+                        playStop[t].measure([&]() {
+                            (void)engine.play(deviceId);
+                            (void)engine.stop(deviceId);
+                        });
+                    }
+                }
+            });
+        }
+        for (auto& caller : callers) {
+            caller.join();
+        }
+
+        const auto merge = [](std::vector<Timing>& perThread) {
+            Timing merged;
+            for (auto& timing : perThread) {
+                merged.samplesMs.insert(merged.samplesMs.end(), timing.samplesMs.begin(), timing.samplesMs.end());
+            }
+            return merged;
+        };
+        printResult("cmd_set_volume", fileCount, options.threads, merge(setVolume));
+        printResult("cmd_change_playlist", fileCount, options.threads, merge(changePlaylist));
+        printResult("cmd_play_stop", fileCount, options.threads, merge(playStop));
+    }
+
+    static void benchSession(RadioEngine& engine, const Options& options, std::size_t fileCount)
+    {
+        Timing save;
+        Timing load;
+        for (std::size_t i = 0; i < options.iterations; ++i) {
+            // A changed volume keeps the writer from skipping an unchanged payload.
+            (void)engine.setVolume(static_cast<float>(30 + i), kBenchDeviceIdBase);
+            save.measure([&]() { engine.savePersistentSession(); });
+            std::lock_guard<std::mutex> lock(engine.mutex_);
+            load.measure([&]() { (void)engine.loadPersistentSessionLocked(); });
+        }
+        printResult("session_save", fileCount, 1, save);
+        printResult("session_load", fileCount, 1, load);
+    }
+
+    // A stream whose player position freezes must be reported stalled (and then reconnect) before
+    // kStallFreezeWindow is up, while one that keeps moving never is.
+    static bool benchStreamStall(RadioEngine& engine, const Options& options, std::size_t fileCount)
+    {
+        const auto started = std::chrono::steady_clock::now();
+        const auto freezeVerdict = [&started]() {
+            RadioEngine::StreamStallWatch watch;
+            std::uint64_t positionMs = 0;
+            for (auto t = std::chrono::seconds(0); t <= std::chrono::seconds(30); t += std::chrono::seconds(1)) {
+                positionMs += 1000;
+                if (RadioEngine::streamStalled(watch, positionMs, started + t, started)) {
+                    return std::chrono::seconds(-1);
+                }
+            }
+            const auto frozenAt = started + std::chrono::seconds(30);
+            for (auto t = std::chrono::seconds(1); t <= kStallFreezeWindow; t += std::chrono::seconds(1)) {
+                if (RadioEngine::streamStalled(watch, positionMs, frozenAt + t, started)) {
+                    return t;
+                }
+            }
+            return std::chrono::seconds(0);
+        };
+
+        const auto stalledAfter = freezeVerdict();
+        if (stalledAfter <= std::chrono::seconds(0)) {
+            std::fprintf(
+                stderr,
+                stalledAfter < std::chrono::seconds(0) ? "stream stall: moving position reported stalled\n"
+                                                       : "stream stall: frozen position never reported stalled\n");
+            return false;
+        }
+
+        {
+            // The stall verdict ends the track, which sends a stream down the background reconnect.
+            std::lock_guard<std::mutex> lock(engine.mutex_);
+            engine.beginStreamReconnectLocked("http://bench.invalid/stream");
+            const bool reconnecting = engine.streamReconnect_ != nullptr && engine.state_ == RadioEngine::PlaybackState::Playing &&
+                                      engine.backend_ == RadioEngine::PlaybackBackend::MediaFoundationStream;
+            engine.cancelStreamReconnectLocked();
+            engine.backend_ = RadioEngine::PlaybackBackend::None;
+            engine.state_ = RadioEngine::PlaybackState::Stopped;
+            if (!reconnecting) {
+                std::fprintf(stderr, "stream stall: no background reconnect after the stall\n");
+                return false;
+            }
+        }
+
+        Timing timing;
+        for (std::size_t i = 0; i < options.iterations; ++i) {
+            timing.measure([&]() {
+                RadioEngine::StreamStallWatch watch;
+                for (std::size_t n = 0; n < kStallChecksPerIteration; ++n) {
+                    (void)RadioEngine::streamStalled(watch, n / 4, started + std::chrono::milliseconds(n * 250), started);
+                }
+            });
+        }
+        printResult("stream_stall_check_x10000", fileCount, 1, timing);
+        return true;
+    }
+};
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: RadioSFSEBench [--files N[,N...]] [--iterations N] [--threads N] [--work-dir PATH]\n");
+        return 2;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.workDir, ec);
+    if (ec) {
+        std::fprintf(stderr, "cannot create work dir: %s\n", options.workDir.string().c_str());
+        return 1;
+    }
+    options.workDir = std::filesystem::absolute(options.workDir);
+
+    for (const std::size_t fileCount : options.fileCounts) {
+        RadioEngineBench::run(options, fileCount);
+    }
+    return RadioEngineBench::failed ? 1 : 0;
+}
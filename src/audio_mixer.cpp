@@ -0,0 +1,662 @@
+#include "audio_mixer.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <windows.h>
+#include <mfapi.h>
+#include <mferror.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#include <propvarutil.h>
+#include <xaudio2.h>
+#include <wrl/client.h>
+
+namespace
+{
+constexpr std::size_t kVoiceBufferCount = 6;
+constexpr long kMaxQueuedBuffers = 4;
+constexpr DWORD kFeederWaitMs = 20;
+constexpr auto kMixerTaskTimeout = std::chrono::seconds(5);
+constexpr auto kSeekFlushTimeout = std::chrono::milliseconds(200);
+
+std::string formatMixerHresult(const HRESULT hr)
+{
+    char buffer[32]{};
+    std::snprintf(buffer, sizeof(buffer), "0x%08X", static_cast<unsigned int>(hr));
+    return std::string(buffer);
+}
+
+std::string mixerPathText(const std::filesystem::path& path)
+{
+    const std::u8string text = path.u8string();
+    return std::string(text.begin(), text.end());
+}
+
+// Buffer/stream completion only touches atomics and the feeder event; XAudio2 forbids blocking here.
+class VoiceCallback final : public IXAudio2VoiceCallback
+{
+public:
+    VoiceCallback(HANDLE feederEvent, const std::function<void()>* voiceEnded) :
+        feederEvent_(feederEvent),
+        voiceEnded_(voiceEnded)
+    {
+    }
+
+    void STDMETHODCALLTYPE OnBufferEnd(void*) override
+    {
+        queued.fetch_sub(1, std::memory_order_acq_rel);
+        SetEvent(feederEvent_);
+    }
+
+    void STDMETHODCALLTYPE OnStreamEnd() override
+    {
+        ended.store(true, std::memory_order_release);
+        if (voiceEnded_ != nullptr && *voiceEnded_) {
+            (*voiceEnded_)();
+        }
+    }
+
+    void STDMETHODCALLTYPE OnVoiceError(void*, HRESULT) override
+    {
+        ended.store(true, std::memory_order_release);
+        if (voiceEnded_ != nullptr && *voiceEnded_) {
+            (*voiceEnded_)();
+        }
+    }
+
+    void STDMETHODCALLTYPE OnVoiceProcessingPassStart(UINT32) override {}
+    void STDMETHODCALLTYPE OnVoiceProcessingPassEnd() override {}
+    void STDMETHODCALLTYPE OnBufferStart(void*) override {}
+    void STDMETHODCALLTYPE OnLoopEnd(void*) override {}
+
+    std::atomic<long> queued{ 0 };
+    std::atomic<bool> ended{ false };
+
+private:
+    HANDLE feederEvent_{ nullptr };
+    const std::function<void()>* voiceEnded_{ nullptr };
+};
+}
+
+struct AudioMixer::Graph
+{
+    bool comInitialized{ false };
+    bool mfInitialized{ false };
+    Microsoft::WRL::ComPtr<IXAudio2> engine{};
+    IXAudio2MasteringVoice* master{ nullptr };
+    UINT32 masterChannels{ 2 };
+    HANDLE feederEvent{ nullptr };
+};
+
+struct AudioMixer::Voice
+{
+    // Guards `source` against teardown while another thread adjusts level or reads position.
+    std::mutex mutex{};
+    IXAudio2SourceVoice* source{ nullptr };
+    std::unique_ptr<VoiceCallback> callback{};
+    Microsoft::WRL::ComPtr<IMFSourceReader> reader{};
+    std::array<std::vector<BYTE>, kVoiceBufferCount> buffers{};
+    std::size_t nextBuffer{ 0 };
+    UINT32 channels{ 0 };
+    UINT32 sampleRate{ 0 };
+    std::uint64_t durationMs{ 0 };
+    std::uint64_t basePositionMs{ 0 };
+    UINT64 baseSamplesPlayed{ 0 };
+    std::atomic<bool> readerDrained{ false };
+    bool started{ false };
+};
+
+AudioMixer::AudioMixer(Logger& logger) :
+    logger_(logger)
+{
+}
+
+AudioMixer::~AudioMixer()
+{
+    shutdown();
+}
+
+bool AudioMixer::initialize(std::function<void()> voiceEnded)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) {
+            return true;
+        }
+        stop_ = false;
+    }
+
+    voiceEnded_ = std::move(voiceEnded);
+    graph_ = std::make_unique<Graph>();
+    graph_->feederEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (graph_->feederEvent == nullptr) {
+        logger_.warn("Native audio mixer disabled: CreateEvent failed.");
+        graph_.reset();
+        return false;
+    }
+
+    std::promise<bool> started;
+    auto startedFuture = started.get_future();
+    thread_ = std::thread([this, ready = std::move(started)]() mutable {
+        threadMain(ready);
+    });
+
+    if (!startedFuture.get()) {
+        thread_.join();
+        CloseHandle(graph_->feederEvent);
+        graph_.reset();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = true;
+    logger_.info([&]() { return "Native audio mixer started. Output channels: " + std::to_string(graph_->masterChannels); });
+    return true;
+}
+
+void AudioMixer::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        stop_ = true;
+    }
+    SetEvent(graph_->feederEvent);
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    CloseHandle(graph_->feederEvent);
+    graph_.reset();
+    logger_.info("Native audio mixer stopped.");
+}
+
+bool AudioMixer::ready() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void AudioMixer::threadMain(std::promise<bool>& started)
+{
+    const HRESULT coHr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    graph_->comInitialized = SUCCEEDED(coHr);
+    if (FAILED(coHr) && coHr != RPC_E_CHANGED_MODE) {
+        logger_.warn([&]() { return "Native audio mixer: CoInitializeEx failed: " + formatMixerHresult(coHr); });
+        started.set_value(false);
+        return;
+    }
+
+    const HRESULT mfHr = MFStartup(MF_VERSION, MFSTARTUP_LITE);
+    graph_->mfInitialized = SUCCEEDED(mfHr);
+    HRESULT hr = mfHr;
+    if (SUCCEEDED(hr)) {
+        hr = XAudio2Create(graph_->engine.GetAddressOf(), 0, XAUDIO2_DEFAULT_PROCESSOR);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = graph_->engine->CreateMasteringVoice(&graph_->master);
+    }
+    if (SUCCEEDED(hr)) {
+        XAUDIO2_VOICE_DETAILS details{};
+        graph_->master->GetVoiceDetails(&details);
+        graph_->masterChannels = std::max<UINT32>(1, details.InputChannels);
+    }
+
+    if (FAILED(hr)) {
+        logger_.warn([&]() { return "Native audio mixer: output graph could not be created: " + formatMixerHresult(hr); });
+        graph_->engine.Reset();
+        if (graph_->mfInitialized) {
+            (void)MFShutdown();
+        }
+        if (graph_->comInitialized) {
+            CoUninitialize();
+        }
+        started.set_value(false);
+        return;
+    }
+    started.set_value(true);
+
+    for (;;) {
+        std::deque<std::function<void()>> tasks;
+        std::vector<std::shared_ptr<Voice>> voices;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_) {
+                break;
+            }
+            tasks.swap(tasks_);
+            voices.reserve(voices_.size());
+            for (const auto& [voiceId, voice] : voices_) {
+                voices.push_back(voice);
+            }
+        }
+
+        for (auto& task : tasks) {
+            task();
+        }
+        for (const auto& voice : voices) {
+            fillVoice(*voice);
+        }
+
+        // Buffer ends, tasks and shutdown all set the event; the timeout only backs up the voices' refills.
+        (void)WaitForSingleObject(graph_->feederEvent, voices.empty() ? INFINITE : kFeederWaitMs);
+    }
+
+    std::unordered_map<VoiceId, std::shared_ptr<Voice>> remaining;
+    std::deque<std::function<void()>> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        remaining.swap(voices_);
+        abandoned.swap(tasks_);
+    }
+    // Queued tasks complete promises that callers may still be waiting on.
+    for (auto& task : abandoned) {
+        task();
+    }
+    for (auto& [voiceId, voice] : remaining) {
+        destroyVoice(*voice);
+    }
+
+    if (graph_->master != nullptr) {
+        graph_->master->DestroyVoice();
+        graph_->master = nullptr;
+    }
+    graph_->engine.Reset();
+    if (graph_->mfInitialized) {
+        (void)MFShutdown();
+    }
+    if (graph_->comInitialized) {
+        CoUninitialize();
+    }
+}
+
+bool AudioMixer::runOnMixerThread(const std::function<bool()>& task)
+{
+    auto done = std::make_shared<std::promise<bool>>();
+    auto result = done->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        tasks_.push_back([task, done]() {
+            done->set_value(task());
+        });
+    }
+    SetEvent(graph_->feederEvent);
+
+    if (result.wait_for(kMixerTaskTimeout) != std::future_status::ready) {
+        logger_.warn("Native audio mixer task timed out.");
+        return false;
+    }
+    return result.get();
+}
+
+std::shared_ptr<AudioMixer::Voice> AudioMixer::findVoice(VoiceId voiceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = voices_.find(voiceId);
+    return it != voices_.end() ? it->second : nullptr;
+}
+
+AudioMixer::VoiceId AudioMixer::open(const std::filesystem::path& path, std::uint64_t startMs)
+{
+    // Everything the task touches is copied in: a timed-out wait returns while the task may still run.
+    auto voice = std::make_shared<Voice>();
+    const bool opened = runOnMixerThread([this, path, startMs, voice]() {
+        Microsoft::WRL::ComPtr<IMFSourceReader> reader;
+        HRESULT hr = MFCreateSourceReaderFromURL(path.wstring().c_str(), nullptr, reader.GetAddressOf());
+        if (FAILED(hr)) {
+            logger_.warn([&]() { return "Native mixer could not open " + mixerPathText(path) + ": " + formatMixerHresult(hr); });
+            return false;
+        }
+
+        (void)reader->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_ALL_STREAMS), FALSE);
+        (void)reader->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), TRUE);
+
+        Microsoft::WRL::ComPtr<IMFMediaType> requested;
+        hr = MFCreateMediaType(requested.GetAddressOf());
+        if (SUCCEEDED(hr)) {
+            (void)requested->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio);
+            (void)requested->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_Float);
+            hr = reader->SetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), nullptr, requested.Get());
+        }
+
+        Microsoft::WRL::ComPtr<IMFMediaType> actual;
+        if (SUCCEEDED(hr)) {
+            hr = reader->GetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), actual.GetAddressOf());
+        }
+        WAVEFORMATEX* format = nullptr;
+        UINT32 formatSize = 0;
+        if (SUCCEEDED(hr)) {
+            hr = MFCreateWaveFormatExFromMFMediaType(actual.Get(), &format, &formatSize);
+        }
+        if (FAILED(hr) || format == nullptr) {
+            logger_.warn([&]() { return "Native mixer could not negotiate PCM for " + mixerPathText(path) + ": " + formatMixerHresult(hr); });
+            return false;
+        }
+
+        voice->channels = format->nChannels;
+        voice->sampleRate = format->nSamplesPerSec;
+        voice->callback = std::make_unique<VoiceCallback>(graph_->feederEvent, &voiceEnded_);
+        hr = graph_->engine->CreateSourceVoice(&voice->source, format, 0, XAUDIO2_DEFAULT_FREQ_RATIO, voice->callback.get());
+        CoTaskMemFree(format);
+        if (FAILED(hr)) {
+            logger_.warn([&]() { return "Native mixer could not create a source voice: " + formatMixerHresult(hr); });
+            voice->source = nullptr;
+            return false;
+        }
+        // Silent until the engine writes its first fade sample.
+        (void)voice->source->SetVolume(0.0F);
+
+        PROPVARIANT duration{};
+        PropVariantInit(&duration);
+        if (SUCCEEDED(reader->GetPresentationAttribute(static_cast<DWORD>(MF_SOURCE_READER_MEDIASOURCE), MF_PD_DURATION, &duration)) &&
+            duration.vt == VT_UI8) {
+            voice->durationMs = duration.uhVal.QuadPart / 10000;
+        }
+        PropVariantClear(&duration);
+
+        voice->reader = std::move(reader);
+        if (startMs > 0) {
+            PROPVARIANT position{};
+            PropVariantInit(&position);
+            position.vt = VT_I8;
+            position.hVal.QuadPart = static_cast<LONGLONG>(startMs) * 10000;
+            if (SUCCEEDED(voice->reader->SetCurrentPosition(GUID_NULL, position))) {
+                voice->basePositionMs = startMs;
+            }
+            PropVariantClear(&position);
+        }
+
+        if (!primeVoice(*voice)) {
+            destroyVoice(*voice);
+            return false;
+        }
+        return true;
+    });
+
+    if (!opened) {
+        // A timed-out open may still create its source voice; tear it down right behind it, without waiting.
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                return 0;
+            }
+            tasks_.push_back([this, voice]() {
+                destroyVoice(*voice);
+            });
+        }
+        SetEvent(graph_->feederEvent);
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const VoiceId voiceId = nextVoiceId_++;
+    voices_.emplace(voiceId, std::move(voice));
+    return voiceId;
+}
+
+bool AudioMixer::start(VoiceId voiceId)
+{
+    const auto voice = findVoice(voiceId);
+    if (!voice) {
+        return false;
+    }
+    std::lock_guard<std::mutex> voiceLock(voice->mutex);
+    if (voice->source == nullptr || FAILED(voice->source->Start(0))) {
+        return false;
+    }
+    voice->started = true;
+    return true;
+}
+
+bool AudioMixer::pause(VoiceId voiceId)
+{
+    const auto voice = findVoice(voiceId);
+    if (!voice) {
+        return false;
+    }
+    std::lock_guard<std::mutex> voiceLock(voice->mutex);
+    if (voice->source == nullptr || FAILED(voice->source->Stop(0))) {
+        return false;
+    }
+    voice->started = false;
+    return true;
+}
+
+void AudioMixer::close(VoiceId voiceId)
+{
+    std::shared_ptr<Voice> voice;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = voices_.find(voiceId);
+        if (it == voices_.end()) {
+            return;
+        }
+        voice = std::move(it->second);
+        voices_.erase(it);
+    }
+
+    (void)runOnMixerThread([this, voice]() {
+        destroyVoice(*voice);
+        return true;
+    });
+}
+
+bool AudioMixer::seek(VoiceId voiceId, std::uint64_t positionMs)
+{
+    const auto voice = findVoice(voiceId);
+    if (!voice) {
+        return false;
+    }
+
+    return runOnMixerThread([this, voice, positionMs]() {
+        std::lock_guard<std::mutex> voiceLock(voice->mutex);
+        if (voice->source == nullptr || !voice->reader) {
+            return false;
+        }
+
+        const bool wasStarted = voice->started;
+        (void)voice->source->Stop(0);
+        (void)voice->source->FlushSourceBuffers();
+        // Flushed buffers report OnBufferEnd asynchronously; their memory must not be refilled before then.
+        // Each one sets the feeder event, which this waits on; it is set again afterwards so a task or
+        // shutdown signal taken here still wakes the loop.
+        const auto flushDeadline = std::chrono::steady_clock::now() + kSeekFlushTimeout;
+        bool tookSignal = false;
+        while (voice->callback->queued.load(std::memory_order_acquire) > 0) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= flushDeadline) {
+                break;
+            }
+            const auto remainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(flushDeadline - now).count() + 1;
+            tookSignal = WaitForSingleObject(graph_->feederEvent, static_cast<DWORD>(remainingMs)) == WAIT_OBJECT_0 || tookSignal;
+        }
+        if (tookSignal) {
+            SetEvent(graph_->feederEvent);
+        }
+
+        PROPVARIANT position{};
+        PropVariantInit(&position);
+        position.vt = VT_I8;
+        position.hVal.QuadPart = static_cast<LONGLONG>(positionMs) * 10000;
+        const HRESULT hr = voice->reader->SetCurrentPosition(GUID_NULL, position);
+        PropVariantClear(&position);
+        if (FAILED(hr)) {
+            return false;
+        }
+
+        XAUDIO2_VOICE_STATE state{};
+        voice->source->GetState(&state, 0);
+        voice->baseSamplesPlayed = state.SamplesPlayed;
+        voice->basePositionMs = positionMs;
+        voice->readerDrained = false;
+        voice->callback->ended.store(false, std::memory_order_release);
+        if (!primeVoice(*voice)) {
+            return false;
+        }
+        if (wasStarted) {
+            (void)voice->source->Start(0);
+        }
+        return true;
+    });
+}
+
+bool AudioMixer::setLevelPan(VoiceId voiceId, float level, float pan)
+{
+    const auto voice = findVoice(voiceId);
+    if (!voice || !graph_) {
+        return false;
+    }
+
+    const UINT32 destinationChannels = graph_->masterChannels;
+    std::lock_guard<std::mutex> voiceLock(voice->mutex);
+    if (voice->source == nullptr || voice->channels == 0) {
+        return false;
+    }
+
+    // Same equal-power curve as the MCI left/right path; even source channels feed left, odd feed right.
+    const double angle = (std::clamp(static_cast<double>(pan), -1.0, 1.0) + 1.0) * (std::acos(-1.0) / 4.0);
+    const float clampedLevel = std::clamp(level, 0.0F, 1.0F);
+    const float leftGain = static_cast<float>(std::cos(angle)) * clampedLevel;
+    const float rightGain = static_cast<float>(std::sin(angle)) * clampedLevel;
+
+    std::vector<float> matrix(static_cast<std::size_t>(voice->channels) * destinationChannels, 0.0F);
+    for (UINT32 source = 0; source < voice->channels; ++source) {
+        if (destinationChannels == 1) {
+            matrix[source] = clampedLevel;
+            continue;
+        }
+        if (voice->channels == 1) {
+            matrix[source] = leftGain;
+            matrix[voice->channels + source] = rightGain;
+            continue;
+        }
+        const UINT32 destination = source % 2;
+        matrix[(voice->channels * destination) + source] = destination == 0 ? leftGain : rightGain;
+    }
+
+    if (FAILED(voice->source->SetOutputMatrix(nullptr, voice->channels, destinationChannels, matrix.data()))) {
+        return false;
+    }
+    return SUCCEEDED(voice->source->SetVolume(1.0F));
+}
+
+std::optional<std::uint64_t> AudioMixer::positionMs(VoiceId voiceId)
+{
+    const auto voice = findVoice(voiceId);
+    if (!voice) {
+        return std::nullopt;
+    }
+    std::lock_guard<std::mutex> voiceLock(voice->mutex);
+    if (voice->source == nullptr || voice->sampleRate == 0) {
+        return std::nullopt;
+    }
+
+    XAUDIO2_VOICE_STATE state{};
+    voice->source->GetState(&state, 0);
+    const UINT64 played = state.SamplesPlayed >= voice->baseSamplesPlayed ? state.SamplesPlayed - voice->baseSamplesPlayed : 0;
+    return voice->basePositionMs + ((played * 1000) / voice->sampleRate);
+}
+
+std::optional<std::uint64_t> AudioMixer::durationMs(VoiceId voiceId)
+{
+    const auto voice = findVoice(voiceId);
+    if (!voice || voice->durationMs == 0) {
+        return std::nullopt;
+    }
+    return voice->durationMs;
+}
+
+bool AudioMixer::finished(VoiceId voiceId)
+{
+    const auto voice = findVoice(voiceId);
+    if (!voice || !voice->callback) {
+        return true;
+    }
+    if (voice->callback->ended.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    // Discontinuity() on an already empty queue may never raise OnStreamEnd.
+    std::lock_guard<std::mutex> voiceLock(voice->mutex);
+    return voice->readerDrained && voice->callback->queued.load(std::memory_order_acquire) <= 0;
+}
+
+bool AudioMixer::primeVoice(Voice& voice)
+{
+    fillVoice(voice);
+    return voice.readerDrained || voice.callback->queued.load(std::memory_order_acquire) > 0;
+}
+
+void AudioMixer::fillVoice(Voice& voice)
+{
+    if (voice.source == nullptr || !voice.reader || voice.readerDrained || !voice.callback) {
+        return;
+    }
+
+    while (voice.callback->queued.load(std::memory_order_acquire) < kMaxQueuedBuffers) {
+        DWORD flags = 0;
+        Microsoft::WRL::ComPtr<IMFSample> sample;
+        const HRESULT hr = voice.reader->ReadSample(
+            static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), 0, nullptr, &flags, nullptr, sample.GetAddressOf());
+        if (FAILED(hr) || (flags & MF_SOURCE_READERF_ENDOFSTREAM) != 0) {
+            voice.readerDrained = true;
+            (void)voice.source->Discontinuity();
+            return;
+        }
+        if (!sample) {
+            continue;
+        }
+
+        Microsoft::WRL::ComPtr<IMFMediaBuffer> mediaBuffer;
+        if (FAILED(sample->ConvertToContiguousBuffer(mediaBuffer.GetAddressOf()))) {
+            continue;
+        }
+        BYTE* data = nullptr;
+        DWORD length = 0;
+        if (FAILED(mediaBuffer->Lock(&data, nullptr, &length))) {
+            continue;
+        }
+        std::vector<BYTE>& storage = voice.buffers[voice.nextBuffer];
+        storage.assign(data, data + length);
+        (void)mediaBuffer->Unlock();
+        if (storage.empty()) {
+            continue;
+        }
+
+        XAUDIO2_BUFFER buffer{};
+        buffer.AudioBytes = static_cast<UINT32>(storage.size());
+        buffer.pAudioData = storage.data();
+        voice.callback->queued.fetch_add(1, std::memory_order_acq_rel);
+        if (FAILED(voice.source->SubmitSourceBuffer(&buffer))) {
+            voice.callback->queued.fetch_sub(1, std::memory_order_acq_rel);
+            voice.readerDrained = true;
+            return;
+        }
+        voice.nextBuffer = (voice.nextBuffer + 1) % voice.buffers.size();
+    }
+}
+
+void AudioMixer::destroyVoice(Voice& voice)
+{
+    std::lock_guard<std::mutex> voiceLock(voice.mutex);
+    if (voice.source != nullptr) {
+        (void)voice.source->Stop(0);
+        // DestroyVoice waits for in-flight callbacks, so the callback object stays alive until it returns.
+        voice.source->DestroyVoice();
+        voice.source = nullptr;
+    }
+    voice.reader.Reset();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "logger.h"
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+// Native playback path for local files: Media Foundation Source Readers decode to float PCM and one
+// XAudio2 graph renders every voice. Gain and equal-power pan go through the voice output matrix,
+// so fades never round-trip through MCI strings and the output device stays open across tracks.
+//
+// Decoding, voice creation and teardown run on the mixer's own MTA thread; level/pan, start/pause
+// and position queries are direct XAudio2 calls and are safe from any thread.
+class AudioMixer
+{
+public:
+    using VoiceId = std::uint64_t;
+
+    explicit AudioMixer(Logger& logger);
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    // voiceEnded is invoked from the XAudio2 callback thread when a voice plays out; it must not block.
+    bool initialize(std::function<void()> voiceEnded);
+    void shutdown();
+    bool ready() const;
+
+    // Opens a voice paused at startMs with silent output; returns 0 when the file cannot be decoded.
+    VoiceId open(const std::filesystem::path& path, std::uint64_t startMs);
+    bool start(VoiceId voiceId);
+    bool pause(VoiceId voiceId);
+    void close(VoiceId voiceId);
+    bool seek(VoiceId voiceId, std::uint64_t positionMs);
+    bool setLevelPan(VoiceId voiceId, float level, float pan);
+    std::optional<std::uint64_t> positionMs(VoiceId voiceId);
+    std::optional<std::uint64_t> durationMs(VoiceId voiceId);
+    bool finished(VoiceId voiceId);
+
+private:
+    struct Graph;
+    struct Voice;
+
+    void threadMain(std::promise<bool>& started);
+    bool runOnMixerThread(const std::function<bool()>& task);
+    std::shared_ptr<Voice> findVoice(VoiceId voiceId);
+    void fillVoice(Voice& voice);
+    bool primeVoice(Voice& voice);
+    void destroyVoice(Voice& voice);
+
+    Logger& logger_;
+    std::function<void()> voiceEnded_{};
+    std::unique_ptr<Graph> graph_{};
+    std::thread thread_{};
+
+    mutable std::mutex mutex_;
+    bool running_{ false };
+    bool stop_{ false };
+    std::deque<std::function<void()>> tasks_{};
+    std::unordered_map<VoiceId, std::shared_ptr<Voice>> voices_{};
+    VoiceId nextVoiceId_{ 1 };
+};
@@ -0,0 +1,253 @@
+#include "fx_cache.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <windows.h>
+#include <mfapi.h>
+#include <mferror.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#include <wrl/client.h>
+
+namespace
+{
+long long fxWriteTimeValue(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const auto writeTime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return 0;
+    }
+    return static_cast<long long>(writeTime.time_since_epoch().count());
+}
+
+void appendBytes(std::vector<std::uint8_t>& out, const void* data, std::size_t size)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void appendU32(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    const std::uint8_t bytes[4] = {
+        static_cast<std::uint8_t>(value & 0xFF),
+        static_cast<std::uint8_t>((value >> 8) & 0xFF),
+        static_cast<std::uint8_t>((value >> 16) & 0xFF),
+        static_cast<std::uint8_t>((value >> 24) & 0xFF),
+    };
+    appendBytes(out, bytes, sizeof(bytes));
+}
+}
+
+FxCache::FxCache(Logger& logger) :
+    logger_(logger)
+{
+    thread_ = std::thread(&FxCache::threadMain, this);
+}
+
+FxCache::~FxCache()
+{
+    shutdown();
+}
+
+void FxCache::load(std::vector<std::filesystem::path> files, std::size_t budgetBytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = Request{ std::move(files), budgetBytes };
+    }
+    cv_.notify_all();
+}
+
+void FxCache::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+FxCache::Clip FxCache::find(const std::filesystem::path& path) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = clips_.find(path);
+    return it != clips_.end() ? it->second.clip : nullptr;
+}
+
+void FxCache::threadMain()
+{
+    (void)SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+    const HRESULT coHr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    const bool comInitialized = SUCCEEDED(coHr);
+    const bool mfInitialized = SUCCEEDED(MFStartup(MF_VERSION, MFSTARTUP_LITE));
+    if (!mfInitialized) {
+        logger_.warn("FX cache: Media Foundation unavailable; FX play through MCI.");
+    }
+
+    for (;;) {
+        Request request;
+        std::map<std::filesystem::path, Entry> previous;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() {
+                return stop_ || pending_.has_value();
+            });
+            if (stop_) {
+                break;
+            }
+            request = std::move(*pending_);
+            pending_.reset();
+            previous = clips_;
+        }
+        if (!mfInitialized) {
+            continue;
+        }
+
+        std::map<std::filesystem::path, Entry> next;
+        std::size_t usedBytes = 0;
+        std::size_t decodedCount = 0;
+        bool superseded = false;
+        for (const auto& file : request.files) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                superseded = stop_ || pending_.has_value();
+            }
+            if (superseded) {
+                break;
+            }
+            if (next.contains(file) || usedBytes >= request.budgetBytes) {
+                continue;
+            }
+
+            Entry entry;
+            entry.writeTime = fxWriteTimeValue(file);
+            const auto previousIt = previous.find(file);
+            if (previousIt != previous.end() && previousIt->second.writeTime == entry.writeTime) {
+                entry.clip = previousIt->second.clip;
+            } else {
+                entry.clip = decodeToWave(file, request.budgetBytes - usedBytes);
+                ++decodedCount;
+            }
+            if (!entry.clip || entry.clip->size() > request.budgetBytes - usedBytes) {
+                continue;
+            }
+            usedBytes += entry.clip->size();
+            next.emplace(file, std::move(entry));
+        }
+        if (superseded) {
+            continue;
+        }
+
+        const std::size_t cachedCount = next.size();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            clips_ = std::move(next);
+        }
+        logger_.info([&]() {
+            return "FX cache: " + std::to_string(cachedCount) + " of " + std::to_string(request.files.size()) +
+                   " clip(s) in memory (" + std::to_string(usedBytes / 1024) + " KB, " +
+                   std::to_string(decodedCount) + " decoded).";
+        });
+    }
+
+    if (mfInitialized) {
+        (void)MFShutdown();
+    }
+    if (comInitialized) {
+        CoUninitialize();
+    }
+}
+
+FxCache::Clip FxCache::decodeToWave(const std::filesystem::path& path, std::size_t maxBytes)
+{
+    Microsoft::WRL::ComPtr<IMFSourceReader> reader;
+    HRESULT hr = MFCreateSourceReaderFromURL(path.wstring().c_str(), nullptr, reader.GetAddressOf());
+    if (FAILED(hr)) {
+        return nullptr;
+    }
+    (void)reader->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_ALL_STREAMS), FALSE);
+    (void)reader->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), TRUE);
+
+    // PlaySound only needs plain PCM; 16-bit keeps clips at half the size of float.
+    Microsoft::WRL::ComPtr<IMFMediaType> requested;
+    hr = MFCreateMediaType(requested.GetAddressOf());
+    if (SUCCEEDED(hr)) {
+        (void)requested->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio);
+        (void)requested->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_PCM);
+        (void)requested->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, 16);
+        hr = reader->SetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), nullptr, requested.Get());
+    }
+    Microsoft::WRL::ComPtr<IMFMediaType> actual;
+    if (SUCCEEDED(hr)) {
+        hr = reader->GetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), actual.GetAddressOf());
+    }
+    WAVEFORMATEX* format = nullptr;
+    UINT32 formatSize = 0;
+    if (SUCCEEDED(hr)) {
+        hr = MFCreateWaveFormatExFromMFMediaType(actual.Get(), &format, &formatSize);
+    }
+    if (FAILED(hr) || format == nullptr) {
+        return nullptr;
+    }
+
+    std::vector<std::uint8_t> pcm;
+    bool complete = false;
+    for (;;) {
+        DWORD flags = 0;
+        Microsoft::WRL::ComPtr<IMFSample> sample;
+        hr = reader->ReadSample(
+            static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), 0, nullptr, &flags, nullptr, sample.GetAddressOf());
+        if (FAILED(hr)) {
+            break;
+        }
+        if ((flags & MF_SOURCE_READERF_ENDOFSTREAM) != 0) {
+            complete = true;
+            break;
+        }
+        if (!sample) {
+            continue;
+        }
+
+        Microsoft::WRL::ComPtr<IMFMediaBuffer> buffer;
+        if (FAILED(sample->ConvertToContiguousBuffer(buffer.GetAddressOf()))) {
+            continue;
+        }
+        BYTE* data = nullptr;
+        DWORD length = 0;
+        if (FAILED(buffer->Lock(&data, nullptr, &length))) {
+            continue;
+        }
+        appendBytes(pcm, data, length);
+        (void)buffer->Unlock();
+        if (pcm.size() > maxBytes) {
+            break;
+        }
+    }
+
+    std::vector<std::uint8_t> wave;
+    if (complete && !pcm.empty()) {
+        const std::size_t headerBytes = 12 + 8 + formatSize + 8;
+        wave.reserve(headerBytes + pcm.size());
+        appendBytes(wave, "RIFF", 4);
+        appendU32(wave, static_cast<std::uint32_t>(headerBytes - 8 + pcm.size()));
+        appendBytes(wave, "WAVE", 4);
+        appendBytes(wave, "fmt ", 4);
+        appendU32(wave, formatSize);
+        appendBytes(wave, format, formatSize);
+        appendBytes(wave, "data", 4);
+        appendU32(wave, static_cast<std::uint32_t>(pcm.size()));
+        appendBytes(wave, pcm.data(), pcm.size());
+    }
+    CoTaskMemFree(format);
+
+    if (wave.empty() || wave.size() > maxBytes) {
+        return nullptr;
+    }
+    return std::make_shared<const std::vector<std::uint8_t>>(std::move(wave));
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "logger.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Clips from Radio/FX decoded once into complete in-memory WAV images (16-bit PCM), so playFx can
+// hand them straight to PlaySound(SND_MEMORY) instead of cold-opening an MCI device per trigger.
+// Decoding runs on the cache's own thread; lookups are safe from any thread.
+class FxCache
+{
+public:
+    // A RIFF/WAVE image; holders keep it alive while PlaySound reads from it.
+    using Clip = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+    explicit FxCache(Logger& logger);
+    ~FxCache();
+
+    FxCache(const FxCache&) = delete;
+    FxCache& operator=(const FxCache&) = delete;
+
+    // Decodes the files in the background, reusing clips whose file is unchanged, and swaps the set
+    // in when done. Files that would take the total past budgetBytes are left uncached.
+    void load(std::vector<std::filesystem::path> files, std::size_t budgetBytes);
+    void shutdown();
+
+    Clip find(const std::filesystem::path& path) const;
+
+private:
+    struct Entry
+    {
+        long long writeTime{ 0 };
+        Clip clip;
+    };
+
+    struct Request
+    {
+        std::vector<std::filesystem::path> files;
+        std::size_t budgetBytes{ 0 };
+    };
+
+    void threadMain();
+    static Clip decodeToWave(const std::filesystem::path& path, std::size_t maxBytes);
+
+    Logger& logger_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::filesystem::path, Entry> clips_;
+    std::optional<Request> pending_;
+    bool stop_{ false };
+    std::thread thread_;
+};
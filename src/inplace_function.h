@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Move-only callable with inline storage. A callable larger than Capacity is rejected at compile
+// time, so storing one never allocates. Used for worker queue commands, which are built on every
+// Papyrus native call.
+template <typename Signature, std::size_t Capacity = 64>
+class InplaceFunction;
+
+template <typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+public:
+    InplaceFunction() noexcept = default;
+    InplaceFunction(std::nullptr_t) noexcept {}
+
+    template <
+        typename F,
+        typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction> &&
+                                    std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    InplaceFunction(F&& callable)
+    {
+        using Stored = std::decay_t<F>;
+        static_assert(sizeof(Stored) <= Capacity, "Callable does not fit InplaceFunction storage.");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t), "Callable is over-aligned for InplaceFunction.");
+        ::new (static_cast<void*>(storage_)) Stored(std::forward<F>(callable));
+        ops_ = &kOps<Stored>;
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    ~InplaceFunction()
+    {
+        reset();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return ops_ != nullptr;
+    }
+
+    R operator()(Args... args)
+    {
+        return ops_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+    void reset() noexcept
+    {
+        if (ops_ != nullptr) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*relocate)(void* target, void* source) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename Stored>
+    static constexpr Ops kOps{
+        [](void* storage, Args&&... args) -> R {
+            return (*static_cast<Stored*>(storage))(std::forward<Args>(args)...);
+        },
+        [](void* target, void* source) noexcept {
+            ::new (target) Stored(std::move(*static_cast<Stored*>(source)));
+            static_cast<Stored*>(source)->~Stored();
+        },
+        [](void* storage) noexcept {
+            static_cast<Stored*>(storage)->~Stored();
+        },
+    };
+
+    void moveFrom(InplaceFunction& other) noexcept
+    {
+        if (other.ops_ != nullptr) {
+            other.ops_->relocate(storage_, other.storage_);
+            ops_ = std::exchange(other.ops_, nullptr);
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity]{};
+    const Ops* ops_{ nullptr };
+};
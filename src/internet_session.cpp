@@ -0,0 +1,283 @@
+#include "internet_session.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include <windows.h>
+#include <wininet.h>
+
+namespace
+{
+constexpr DWORD kWaitSliceMs = 25;
+constexpr DWORD kCloseWaitMs = 2000;
+constexpr std::size_t kReadChunkBytes = 8192;
+
+// Per-request state shared with WinINet's callback thread. It must outlive the request handle: the
+// owner frees it only after INTERNET_STATUS_HANDLE_CLOSING, the last callback made for a handle.
+struct PendingRequest
+{
+    PendingRequest() :
+        completed(CreateEventW(nullptr, FALSE, FALSE, nullptr)),
+        closed(CreateEventW(nullptr, TRUE, FALSE, nullptr))
+    {
+    }
+
+    ~PendingRequest()
+    {
+        if (completed != nullptr) {
+            CloseHandle(completed);
+        }
+        if (closed != nullptr) {
+            CloseHandle(closed);
+        }
+    }
+
+    PendingRequest(const PendingRequest&) = delete;
+    PendingRequest& operator=(const PendingRequest&) = delete;
+
+    HANDLE completed{ nullptr };
+    HANDLE closed{ nullptr };
+    std::atomic<HINTERNET> handle{ nullptr };
+    bool operationPending{ false };
+    DWORD error{ ERROR_SUCCESS };
+    // Async reads complete into these after InternetReadFile has returned.
+    DWORD bytesRead{ 0 };
+    std::array<char, kReadChunkBytes> buffer{};
+};
+
+enum class WaitOutcome
+{
+    Completed,
+    Failed,
+    Cancelled
+};
+
+void CALLBACK onInternetStatus(HINTERNET, DWORD_PTR context, DWORD status, LPVOID info, DWORD)
+{
+    auto* pending = reinterpret_cast<PendingRequest*>(context);
+    if (pending == nullptr) {
+        return;
+    }
+
+    switch (status) {
+    case INTERNET_STATUS_HANDLE_CREATED:
+        pending->handle.store(
+            reinterpret_cast<HINTERNET>(static_cast<const INTERNET_ASYNC_RESULT*>(info)->dwResult),
+            std::memory_order_release);
+        break;
+    case INTERNET_STATUS_REQUEST_COMPLETE:
+        pending->error = static_cast<const INTERNET_ASYNC_RESULT*>(info)->dwError;
+        SetEvent(pending->completed);
+        break;
+    case INTERNET_STATUS_HANDLE_CLOSING:
+        SetEvent(pending->closed);
+        break;
+    default:
+        break;
+    }
+}
+
+// Waits for the operation that just returned ERROR_IO_PENDING. Cancelled means the caller gave up;
+// the operation is still in flight until the request handle is closed.
+WaitOutcome waitForCompletion(PendingRequest& pending, DWORD timeoutMs, const std::function<bool()>& shouldAbort)
+{
+    pending.operationPending = true;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        if (WaitForSingleObject(pending.completed, kWaitSliceMs) == WAIT_OBJECT_0) {
+            pending.operationPending = false;
+            return pending.error == ERROR_SUCCESS ? WaitOutcome::Completed : WaitOutcome::Failed;
+        }
+        if ((shouldAbort && shouldAbort()) || std::chrono::steady_clock::now() >= deadline) {
+            return WaitOutcome::Cancelled;
+        }
+    }
+}
+
+// Closing the handle cancels any pending operation. The state is freed once WinINet confirms; if it
+// never does, it is leaked rather than handed back while a callback may still touch it.
+void closeRequest(std::unique_ptr<PendingRequest> pending)
+{
+    HINTERNET handle = pending->handle.load(std::memory_order_acquire);
+    if (handle == nullptr && pending->operationPending &&
+        WaitForSingleObject(pending->completed, kCloseWaitMs) == WAIT_OBJECT_0) {
+        pending->operationPending = false;
+        handle = pending->handle.load(std::memory_order_acquire);
+    }
+
+    if (handle == nullptr) {
+        if (pending->operationPending) {
+            (void)pending.release();
+        }
+        return;
+    }
+
+    InternetCloseHandle(handle);
+    if (WaitForSingleObject(pending->closed, kCloseWaitMs) != WAIT_OBJECT_0) {
+        (void)pending.release();
+    }
+}
+
+std::string trimAscii(std::string value)
+{
+    const auto isSpace = [](unsigned char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    };
+    while (!value.empty() && isSpace(static_cast<unsigned char>(value.back()))) {
+        value.pop_back();
+    }
+    const auto first = std::find_if(value.begin(), value.end(), [&isSpace](char c) {
+        return !isSpace(static_cast<unsigned char>(c));
+    });
+    value.erase(value.begin(), first);
+    return value;
+}
+
+std::string queryContentType(HINTERNET request)
+{
+    DWORD headerSize = 0;
+    (void)HttpQueryInfoA(request, HTTP_QUERY_CONTENT_TYPE, nullptr, &headerSize, nullptr);
+    if (headerSize == 0 || GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+        return {};
+    }
+
+    std::string contentType(static_cast<std::size_t>(headerSize), '\0');
+    if (!HttpQueryInfoA(request, HTTP_QUERY_CONTENT_TYPE, contentType.data(), &headerSize, nullptr)) {
+        return {};
+    }
+    if (headerSize > 0 && contentType[headerSize - 1] == '\0') {
+        --headerSize;
+    }
+    contentType.resize(static_cast<std::size_t>(headerSize));
+    return trimAscii(std::move(contentType));
+}
+
+std::string queryFinalUrl(HINTERNET request)
+{
+    DWORD urlSize = 0;
+    (void)InternetQueryOptionA(request, INTERNET_OPTION_URL, nullptr, &urlSize);
+    if (urlSize == 0 || GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+        return {};
+    }
+
+    std::string finalUrl(static_cast<std::size_t>(urlSize), '\0');
+    if (!InternetQueryOptionA(request, INTERNET_OPTION_URL, finalUrl.data(), &urlSize)) {
+        return {};
+    }
+    if (urlSize > 0 && finalUrl[urlSize - 1] == '\0') {
+        --urlSize;
+    }
+    finalUrl.resize(static_cast<std::size_t>(urlSize));
+    return trimAscii(std::move(finalUrl));
+}
+}
+
+std::shared_ptr<InternetSession> InternetSession::open(const char* userAgent)
+{
+    HINTERNET handle = InternetOpenA(userAgent, INTERNET_OPEN_TYPE_PRECONFIG, nullptr, nullptr, INTERNET_FLAG_ASYNC);
+    if (handle == nullptr) {
+        return nullptr;
+    }
+    if (InternetSetStatusCallbackA(handle, &onInternetStatus) == INTERNET_INVALID_STATUS_CALLBACK) {
+        InternetCloseHandle(handle);
+        return nullptr;
+    }
+    return std::shared_ptr<InternetSession>(new InternetSession(handle));
+}
+
+InternetSession::InternetSession(void* handle) :
+    handle_(handle)
+{
+}
+
+InternetSession::~InternetSession()
+{
+    if (handle_ != nullptr) {
+        InternetCloseHandle(static_cast<HINTERNET>(handle_));
+    }
+}
+
+InternetSession::Response InternetSession::get(
+    const std::string& url,
+    const Request& request,
+    const std::function<bool()>& shouldAbort) const
+{
+    Response response{};
+    if (shouldAbort && shouldAbort()) {
+        return response;
+    }
+
+    auto pending = std::make_unique<PendingRequest>();
+    if (pending->completed == nullptr || pending->closed == nullptr) {
+        return response;
+    }
+
+    // Keep-alive lets WinINet park the connection in the session pool once the body is fully read;
+    // requests cut short (cap, rejection, abort) close theirs instead.
+    const DWORD flags =
+        INTERNET_FLAG_RELOAD | INTERNET_FLAG_NO_CACHE_WRITE | INTERNET_FLAG_NO_COOKIES | INTERNET_FLAG_KEEP_CONNECTION;
+    HINTERNET handle = InternetOpenUrlA(
+        static_cast<HINTERNET>(handle_),
+        url.c_str(),
+        nullptr,
+        0,
+        flags,
+        reinterpret_cast<DWORD_PTR>(pending.get()));
+    if (handle != nullptr) {
+        pending->handle.store(handle, std::memory_order_release);
+    } else if (GetLastError() != ERROR_IO_PENDING ||
+               waitForCompletion(*pending, request.timeoutMs, shouldAbort) != WaitOutcome::Completed) {
+        closeRequest(std::move(pending));
+        return response;
+    }
+
+    handle = pending->handle.load(std::memory_order_acquire);
+    if (handle == nullptr) {
+        closeRequest(std::move(pending));
+        return response;
+    }
+
+    response.connected = true;
+    DWORD statusCode = 0;
+    DWORD statusSize = sizeof(statusCode);
+    if (HttpQueryInfoA(handle, HTTP_QUERY_STATUS_CODE | HTTP_QUERY_FLAG_NUMBER, &statusCode, &statusSize, nullptr)) {
+        response.statusCode = statusCode;
+    }
+    response.contentType = queryContentType(handle);
+    response.finalUrl = queryFinalUrl(handle);
+
+    bool sniffed = false;
+    while (response.body.size() < request.maxBodyBytes) {
+        if (shouldAbort && shouldAbort()) {
+            break;
+        }
+
+        const std::size_t wanted = std::min(pending->buffer.size(), request.maxBodyBytes - response.body.size());
+        pending->bytesRead = 0;
+        if (!InternetReadFile(handle, pending->buffer.data(), static_cast<DWORD>(wanted), &pending->bytesRead) &&
+            (GetLastError() != ERROR_IO_PENDING ||
+             waitForCompletion(*pending, request.timeoutMs, shouldAbort) != WaitOutcome::Completed)) {
+            break;
+        }
+        if (pending->bytesRead == 0) {
+            break;
+        }
+
+        response.body.append(pending->buffer.data(), static_cast<std::size_t>(pending->bytesRead));
+        if (!sniffed) {
+            sniffed = true;
+            if (request.acceptBody && !request.acceptBody(response.contentType, response.body)) {
+                response.rejected = true;
+                break;
+            }
+        }
+        if (response.body.size() >= request.maxBodyBytes) {
+            response.truncated = true;
+        }
+    }
+
+    closeRequest(std::move(pending));
+    return response;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// One asynchronous WinINet session shared by every HTTP request the engine makes (playlist
+// resolves, stream probes). WinINet keeps idle connections per host inside the session, so a
+// resolver chain that walks pls -> m3u on the same server reuses one TCP/TLS connection instead of
+// handshaking again. Each step of a request waits in short slices, so shouldAbort or the request
+// timeout cancels it promptly by closing the request handle.
+class InternetSession
+{
+public:
+    struct Request
+    {
+        // Longest wait for any single step (connect + headers, or one read).
+        std::uint32_t timeoutMs{ 3500 };
+        // The body is cut at this many bytes; 0 skips the body entirely.
+        std::size_t maxBodyBytes{ 0 };
+        // Called once with the content type and the first chunk of the body. Returning false stops
+        // the download there and marks the response rejected; the head stays in the body.
+        std::function<bool(const std::string& contentType, std::string_view head)> acceptBody;
+    };
+
+    struct Response
+    {
+        bool connected{ false };
+        std::uint32_t statusCode{ 0 };
+        std::string contentType;
+        std::string finalUrl;
+        std::string body;
+        bool truncated{ false };
+        bool rejected{ false };
+    };
+
+    // Returns null when WinINet cannot open an async session.
+    static std::shared_ptr<InternetSession> open(const char* userAgent);
+
+    ~InternetSession();
+
+    InternetSession(const InternetSession&) = delete;
+    InternetSession& operator=(const InternetSession&) = delete;
+
+    // Thread-safe; any number of requests may run concurrently on one session.
+    Response get(const std::string& url, const Request& request, const std::function<bool()>& shouldAbort) const;
+
+private:
+    explicit InternetSession(void* handle);
+
+    void* handle_{ nullptr };  // HINTERNET
+};
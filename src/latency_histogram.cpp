@@ -0,0 +1,89 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+namespace
+{
+constexpr std::uint64_t kFirstBucketUs = 128;
+
+std::string formatMilliseconds(std::uint64_t microseconds)
+{
+    char buffer[32]{};
+    std::snprintf(buffer, sizeof(buffer), "%.2fms", static_cast<double>(microseconds) / 1000.0);
+    return buffer;
+}
+}
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration elapsed)
+{
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    const std::uint64_t value = micros > 0 ? static_cast<std::uint64_t>(micros) : 0;
+
+    std::size_t bucket = 0;
+    if (value >= kFirstBucketUs) {
+        bucket = static_cast<std::size_t>(std::bit_width(value / kFirstBucketUs));
+        if (bucket >= kBucketCount) {
+            bucket = kBucketCount - 1;
+        }
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    totalUs_.fetch_add(value, std::memory_order_relaxed);
+
+    std::uint64_t previousMax = maxUs_.load(std::memory_order_relaxed);
+    while (value > previousMax &&
+           !maxUs_.compare_exchange_weak(previousMax, value, std::memory_order_relaxed, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Summary LatencyHistogram::summarize() const
+{
+    // Fields are read one by one, so a summary taken mid-record may be off by that one sample.
+    std::array<std::uint64_t, kBucketCount> counts{};
+    std::uint64_t bucketed = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        bucketed += counts[i];
+    }
+
+    Summary summary;
+    summary.count = bucketed;
+    summary.maxUs = maxUs_.load(std::memory_order_relaxed);
+    if (bucketed == 0) {
+        return summary;
+    }
+    summary.meanUs = totalUs_.load(std::memory_order_relaxed) / bucketed;
+
+    const auto percentile = [&](std::uint64_t rank) {
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return i + 1 == kBucketCount ? summary.maxUs : std::min(bucketUpperBoundUs(i), summary.maxUs);
+            }
+        }
+        return summary.maxUs;
+    };
+    summary.p50Us = percentile((bucketed + 1) / 2);
+    summary.p95Us = percentile((bucketed * 95 + 99) / 100);
+    return summary;
+}
+
+std::string LatencyHistogram::describe() const
+{
+    const Summary summary = summarize();
+    if (summary.count == 0) {
+        return "n=0";
+    }
+    return "n=" + std::to_string(summary.count) +
+           " mean=" + formatMilliseconds(summary.meanUs) +
+           " p50<=" + formatMilliseconds(summary.p50Us) +
+           " p95<=" + formatMilliseconds(summary.p95Us) +
+           " max=" + formatMilliseconds(summary.maxUs);
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBoundUs(std::size_t bucket)
+{
+    return kFirstBucketUs << bucket;
+}
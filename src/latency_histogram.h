@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Fixed power-of-two buckets over microseconds: bucket 0 holds samples under 128 us, each next one
+// doubles the bound, and the last is open-ended (about 2 s and up). Recording is a handful of
+// relaxed atomic adds, so any thread may record while another summarizes.
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t kBucketCount = 16;
+
+    struct Summary
+    {
+        std::uint64_t count{ 0 };
+        std::uint64_t meanUs{ 0 };
+        // Upper bounds of the buckets holding the 50th and 95th percentile samples.
+        std::uint64_t p50Us{ 0 };
+        std::uint64_t p95Us{ 0 };
+        std::uint64_t maxUs{ 0 };
+    };
+
+    void record(std::chrono::steady_clock::duration elapsed);
+    Summary summarize() const;
+
+    // "n=12 mean=0.41ms p50<=0.51ms p95<=2.05ms max=3.10ms", or "n=0".
+    std::string describe() const;
+
+private:
+    static std::uint64_t bucketUpperBoundUs(std::size_t bucket);
+
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+    std::atomic<std::uint64_t> totalUs_{ 0 };
+    std::atomic<std::uint64_t> maxUs_{ 0 };
+};
@@ -0,0 +1,377 @@
+#include "library_analyzer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <set>
+#include <utility>
+
+#include <windows.h>
+#include <mfapi.h>
+#include <mferror.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#include <wrl/client.h>
+
+namespace
+{
+constexpr std::size_t kResultBatch = 32;
+constexpr double kAbsoluteGateLufs = -70.0;
+constexpr double kRelativeGateLu = -10.0;
+
+struct Biquad
+{
+    double b0{ 1.0 };
+    double b1{ 0.0 };
+    double b2{ 0.0 };
+    double a1{ 0.0 };
+    double a2{ 0.0 };
+};
+
+// BS.1770 K-weighting (high shelf + RLB high-pass) and gated integration. The filter coefficients
+// are derived for the file's own sample rate instead of the 48 kHz table in the spec.
+class LoudnessMeter
+{
+public:
+    LoudnessMeter(UINT32 sampleRate, UINT32 channels) :
+        channels_(std::max<UINT32>(1, channels)),
+        subBlockFrames_(std::max<std::size_t>(1, sampleRate / 10)),
+        state_(static_cast<std::size_t>(channels_) * 4, 0.0)
+    {
+        const double pi = std::acos(-1.0);
+        const double rate = static_cast<double>(std::max<UINT32>(1, sampleRate));
+
+        {
+            const double f0 = 1681.974450955533;
+            const double gainDb = 3.999843853973347;
+            const double q = 0.7071752369554196;
+            const double k = std::tan(pi * f0 / rate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + (k / q) + (k * k);
+            shelf_.b0 = (vh + (vb * k / q) + (k * k)) / a0;
+            shelf_.b1 = 2.0 * ((k * k) - vh) / a0;
+            shelf_.b2 = (vh - (vb * k / q) + (k * k)) / a0;
+            shelf_.a1 = 2.0 * ((k * k) - 1.0) / a0;
+            shelf_.a2 = (1.0 - (k / q) + (k * k)) / a0;
+        }
+        {
+            const double f0 = 38.13547087602444;
+            const double q = 0.5003270373238773;
+            const double k = std::tan(pi * f0 / rate);
+            const double a0 = 1.0 + (k / q) + (k * k);
+            highPass_.b0 = 1.0;
+            highPass_.b1 = -2.0;
+            highPass_.b2 = 1.0;
+            highPass_.a1 = 2.0 * ((k * k) - 1.0) / a0;
+            highPass_.a2 = (1.0 - (k / q) + (k * k)) / a0;
+        }
+    }
+
+    void add(const float* samples, std::size_t frames)
+    {
+        for (std::size_t frame = 0; frame < frames; ++frame) {
+            for (UINT32 channel = 0; channel < channels_; ++channel) {
+                double* z = &state_[static_cast<std::size_t>(channel) * 4];
+                const double input = static_cast<double>(samples[(frame * channels_) + channel]);
+                const double shelved = (shelf_.b0 * input) + z[0];
+                z[0] = (shelf_.b1 * input) - (shelf_.a1 * shelved) + z[1];
+                z[1] = (shelf_.b2 * input) - (shelf_.a2 * shelved);
+                const double weighted = (highPass_.b0 * shelved) + z[2];
+                z[2] = (highPass_.b1 * shelved) - (highPass_.a1 * weighted) + z[3];
+                z[3] = (highPass_.b2 * shelved) - (highPass_.a2 * weighted);
+                subBlockEnergy_ += weighted * weighted;
+            }
+            if (++subBlockFill_ == subBlockFrames_) {
+                closeSubBlock();
+            }
+        }
+    }
+
+    // Integrated loudness over 400 ms blocks with 75% overlap, absolute then relative gate.
+    std::optional<double> integratedLufs() const
+    {
+        const auto lufsOf = [](double energy) {
+            return -0.691 + (10.0 * std::log10(energy));
+        };
+
+        std::vector<double> blocks;
+        if (subBlocks_.size() >= 4) {
+            blocks.reserve(subBlocks_.size() - 3);
+            for (std::size_t i = 3; i < subBlocks_.size(); ++i) {
+                blocks.push_back((subBlocks_[i - 3] + subBlocks_[i - 2] + subBlocks_[i - 1] + subBlocks_[i]) / 4.0);
+            }
+        }
+
+        const auto gatedMean = [&blocks, &lufsOf](double thresholdLufs) -> std::optional<double> {
+            double sum = 0.0;
+            std::size_t count = 0;
+            for (const double energy : blocks) {
+                if (energy > 0.0 && lufsOf(energy) > thresholdLufs) {
+                    sum += energy;
+                    ++count;
+                }
+            }
+            if (count == 0) {
+                return std::nullopt;
+            }
+            return sum / static_cast<double>(count);
+        };
+
+        const auto absoluteMean = gatedMean(kAbsoluteGateLufs);
+        if (!absoluteMean.has_value()) {
+            return std::nullopt;
+        }
+        const auto relativeMean = gatedMean(std::max(kAbsoluteGateLufs, lufsOf(*absoluteMean) + kRelativeGateLu));
+        if (!relativeMean.has_value()) {
+            return std::nullopt;
+        }
+        return lufsOf(*relativeMean);
+    }
+
+private:
+    void closeSubBlock()
+    {
+        subBlocks_.push_back(subBlockEnergy_ / static_cast<double>(subBlockFrames_));
+        subBlockEnergy_ = 0.0;
+        subBlockFill_ = 0;
+    }
+
+    UINT32 channels_{ 1 };
+    std::size_t subBlockFrames_{ 1 };
+    Biquad shelf_{};
+    Biquad highPass_{};
+    std::vector<double> state_;
+    // Channel-summed mean square of each 100 ms step; four of them make one gating block.
+    std::vector<double> subBlocks_;
+    double subBlockEnergy_{ 0.0 };
+    std::size_t subBlockFill_{ 0 };
+};
+
+long long fileWriteTimeValue(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const auto writeTime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return 0;
+    }
+    return static_cast<long long>(writeTime.time_since_epoch().count());
+}
+}
+
+LibraryAnalyzer::LibraryAnalyzer(Logger& logger) :
+    logger_(logger)
+{
+}
+
+LibraryAnalyzer::~LibraryAnalyzer()
+{
+    shutdown();
+}
+
+void LibraryAnalyzer::start(std::size_t threadCount, std::function<void()> resultsReady)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!threads_.empty()) {
+        return;
+    }
+
+    stop_.store(false, std::memory_order_release);
+    resultsReady_ = std::move(resultsReady);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        threads_.emplace_back(&LibraryAnalyzer::threadMain, this);
+    }
+}
+
+void LibraryAnalyzer::shutdown()
+{
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_.store(true, std::memory_order_release);
+        threads.swap(threads_);
+        jobs_.clear();
+        nextJob_ = 0;
+    }
+    cv_.notify_all();
+
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+void LibraryAnalyzer::submit(std::vector<Job> jobs)
+{
+    if (jobs.empty()) {
+        return;
+    }
+
+    // A file queued again replaces its pending job, so a rescan never decodes the same file twice.
+    std::set<std::pair<std::string, std::string>> resubmitted;
+    for (const auto& job : jobs) {
+        resubmitted.emplace(job.indexKey, job.fileName);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Job> pending;
+        pending.reserve(jobs_.size() - nextJob_ + jobs.size());
+        for (std::size_t i = nextJob_; i < jobs_.size(); ++i) {
+            if (!resubmitted.contains({ jobs_[i].indexKey, jobs_[i].fileName })) {
+                pending.push_back(std::move(jobs_[i]));
+            }
+        }
+        std::move(jobs.begin(), jobs.end(), std::back_inserter(pending));
+        jobs_ = std::move(pending);
+        nextJob_ = 0;
+    }
+    cv_.notify_all();
+}
+
+std::vector<LibraryAnalyzer::Result> LibraryAnalyzer::takeResults()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::exchange(results_, {});
+}
+
+bool LibraryAnalyzer::idle() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return busy_ == 0 && nextJob_ >= jobs_.size();
+}
+
+void LibraryAnalyzer::threadMain()
+{
+    // Background mode lowers both CPU and I/O priority for as long as the thread lives.
+    (void)SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+    const HRESULT coHr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    const bool comInitialized = SUCCEEDED(coHr);
+    const bool mfInitialized = SUCCEEDED(MFStartup(MF_VERSION, MFSTARTUP_LITE));
+    if (!mfInitialized) {
+        logger_.warn("Library analysis: Media Foundation unavailable; analysis thread exits.");
+    }
+
+    while (mfInitialized) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() {
+                return stop_.load(std::memory_order_acquire) || nextJob_ < jobs_.size();
+            });
+            if (stop_.load(std::memory_order_acquire)) {
+                break;
+            }
+            job = std::move(jobs_[nextJob_++]);
+            ++busy_;
+        }
+
+        std::optional<Result> result;
+        const long long writeTime = fileWriteTimeValue(job.path);
+        if (writeTime != 0 && writeTime != job.cachedWriteTime) {
+            result = Result{ std::move(job.indexKey), std::move(job.fileName), analyzeFile(job.path, writeTime, stop_) };
+        }
+
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busy_;
+            if (result.has_value() && !stop_.load(std::memory_order_acquire)) {
+                results_.push_back(std::move(*result));
+            }
+            const bool nowIdle = busy_ == 0 && nextJob_ >= jobs_.size();
+            notify = !stop_.load(std::memory_order_acquire) && (results_.size() >= kResultBatch || nowIdle);
+        }
+        if (notify && resultsReady_) {
+            resultsReady_();
+        }
+    }
+
+    if (mfInitialized) {
+        (void)MFShutdown();
+    }
+    if (comInitialized) {
+        CoUninitialize();
+    }
+}
+
+TrackAnalysis LibraryAnalyzer::analyzeFile(const std::filesystem::path& path, long long writeTime, const std::atomic<bool>& stop)
+{
+    TrackAnalysis analysis;
+    analysis.fileWriteTime = writeTime;
+
+    Microsoft::WRL::ComPtr<IMFSourceReader> reader;
+    HRESULT hr = MFCreateSourceReaderFromURL(path.wstring().c_str(), nullptr, reader.GetAddressOf());
+    if (FAILED(hr)) {
+        return analysis;
+    }
+    (void)reader->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_ALL_STREAMS), FALSE);
+    (void)reader->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), TRUE);
+
+    Microsoft::WRL::ComPtr<IMFMediaType> requested;
+    hr = MFCreateMediaType(requested.GetAddressOf());
+    if (SUCCEEDED(hr)) {
+        (void)requested->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio);
+        (void)requested->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_Float);
+        hr = reader->SetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), nullptr, requested.Get());
+    }
+    Microsoft::WRL::ComPtr<IMFMediaType> actual;
+    if (SUCCEEDED(hr)) {
+        hr = reader->GetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), actual.GetAddressOf());
+    }
+    UINT32 channels = 0;
+    UINT32 sampleRate = 0;
+    if (SUCCEEDED(hr)) {
+        hr = actual->GetUINT32(MF_MT_AUDIO_NUM_CHANNELS, &channels);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = actual->GetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, &sampleRate);
+    }
+    if (FAILED(hr) || channels == 0 || sampleRate == 0) {
+        return analysis;
+    }
+
+    // Counting decoded frames gives the exact length even for VBR MP3s without a Xing/VBRI header,
+    // where the container estimate (and MCI's "status length") can be off by seconds.
+    LoudnessMeter meter(sampleRate, channels);
+    std::uint64_t frames = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        DWORD flags = 0;
+        Microsoft::WRL::ComPtr<IMFSample> sample;
+        hr = reader->ReadSample(
+            static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), 0, nullptr, &flags, nullptr, sample.GetAddressOf());
+        if (FAILED(hr) || (flags & MF_SOURCE_READERF_ENDOFSTREAM) != 0) {
+            break;
+        }
+        if (!sample) {
+            continue;
+        }
+
+        Microsoft::WRL::ComPtr<IMFMediaBuffer> buffer;
+        if (FAILED(sample->ConvertToContiguousBuffer(buffer.GetAddressOf()))) {
+            continue;
+        }
+        BYTE* data = nullptr;
+        DWORD length = 0;
+        if (FAILED(buffer->Lock(&data, nullptr, &length))) {
+            continue;
+        }
+        const std::size_t sampleFrames = length / (sizeof(float) * channels);
+        meter.add(reinterpret_cast<const float*>(data), sampleFrames);
+        (void)buffer->Unlock();
+        frames += sampleFrames;
+    }
+    if (stop.load(std::memory_order_relaxed) || FAILED(hr)) {
+        return analysis;
+    }
+
+    analysis.durationMs = (frames * 1000) / sampleRate;
+    const auto loudness = meter.integratedLufs();
+    if (loudness.has_value()) {
+        analysis.loudnessLufs = static_cast<float>(*loudness);
+        analysis.hasLoudness = true;
+    }
+    return analysis;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What one decode pass learned about a library file. fileWriteTime is the file's write time when it
+// was measured; a different value on disk means the entry is stale.
+struct TrackAnalysis
+{
+    long long fileWriteTime{ 0 };
+    std::uint64_t durationMs{ 0 };
+    // ITU-R BS.1770 integrated loudness. hasLoudness is false for undecodable or silent files.
+    float loudnessLufs{ 0.0F };
+    bool hasLoudness{ false };
+};
+
+// Low-priority pool that decodes library files through Media Foundation and measures exact length
+// and integrated loudness. Threads run in background mode (CPU and I/O), so they yield to the game
+// and to playback. Files whose write time matches the cached entry are skipped without decoding.
+class LibraryAnalyzer
+{
+public:
+    struct Job
+    {
+        std::string indexKey;
+        std::string fileName;  // UTF-8, as stored in the library index
+        std::filesystem::path path;
+        long long cachedWriteTime{ 0 };  // 0 when nothing is cached
+    };
+
+    struct Result
+    {
+        std::string indexKey;
+        std::string fileName;
+        TrackAnalysis analysis;
+    };
+
+    explicit LibraryAnalyzer(Logger& logger);
+    ~LibraryAnalyzer();
+
+    LibraryAnalyzer(const LibraryAnalyzer&) = delete;
+    LibraryAnalyzer& operator=(const LibraryAnalyzer&) = delete;
+
+    // resultsReady is called from a pool thread, never with the pool's lock held, whenever a batch
+    // of results is waiting or the pool has just gone idle.
+    void start(std::size_t threadCount, std::function<void()> resultsReady);
+    void shutdown();
+
+    // Adds to the jobs not yet picked up; a pending job for the same file is replaced. Jobs already
+    // decoding finish and still report.
+    void submit(std::vector<Job> jobs);
+    std::vector<Result> takeResults();
+    bool idle() const;
+
+private:
+    void threadMain();
+    static TrackAnalysis analyzeFile(const std::filesystem::path& path, long long writeTime, const std::atomic<bool>& stop);
+
+    Logger& logger_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Job> jobs_;
+    std::size_t nextJob_{ 0 };
+    std::size_t busy_{ 0 };
+    std::vector<Result> results_;
+    std::atomic<bool> stop_{ false };
+    std::vector<std::thread> threads_;
+    std::function<void()> resultsReady_;
+};
@@ -0,0 +1,219 @@
+#include "library_watcher.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+#include <string>
+#include <utility>
+
+#include <windows.h>
+
+namespace
+{
+// 64 KB is the largest buffer ReadDirectoryChangesW accepts for network shares as well.
+constexpr std::size_t kNotifyBufferBytes = 64 * 1024;
+constexpr DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+// A copy that never pauses still gets reported this often.
+constexpr auto kMaxBatchDelay = std::chrono::seconds(10);
+
+std::wstring lowerWide(std::wstring text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](wchar_t c) {
+        return static_cast<wchar_t>(std::towlower(c));
+    });
+    return text;
+}
+}
+
+std::unique_ptr<LibraryWatcher> LibraryWatcher::start(
+    Logger& logger,
+    const std::filesystem::path& radioRootPath,
+    std::chrono::milliseconds debounce,
+    Callback callback)
+{
+    HANDLE directory = CreateFileW(
+        radioRootPath.wstring().c_str(),
+        FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+        nullptr);
+    if (directory == INVALID_HANDLE_VALUE) {
+        logger.warn("Library watcher: cannot open radio root (error " + std::to_string(GetLastError()) + ").");
+        return nullptr;
+    }
+
+    HANDLE stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (stopEvent == nullptr) {
+        CloseHandle(directory);
+        return nullptr;
+    }
+
+    return std::unique_ptr<LibraryWatcher>(new LibraryWatcher(logger, directory, stopEvent, debounce, std::move(callback)));
+}
+
+LibraryWatcher::LibraryWatcher(
+    Logger& logger,
+    void* directory,
+    void* stopEvent,
+    std::chrono::milliseconds debounce,
+    Callback callback) :
+    logger_(logger),
+    directory_(directory),
+    stopEvent_(stopEvent),
+    debounce_(debounce),
+    callback_(std::move(callback))
+{
+    thread_ = std::thread(&LibraryWatcher::threadMain, this);
+}
+
+LibraryWatcher::~LibraryWatcher()
+{
+    shutdown();
+    CloseHandle(static_cast<HANDLE>(stopEvent_));
+    CloseHandle(static_cast<HANDLE>(directory_));
+}
+
+void LibraryWatcher::shutdown()
+{
+    (void)SetEvent(static_cast<HANDLE>(stopEvent_));
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void LibraryWatcher::threadMain()
+{
+    (void)SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    const HANDLE directory = static_cast<HANDLE>(directory_);
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (overlapped.hEvent == nullptr) {
+        logger_.warn("Library watcher: cannot create the notification event.");
+        return;
+    }
+    const HANDLE waitHandles[2] = { overlapped.hEvent, static_cast<HANDLE>(stopEvent_) };
+
+    std::vector<DWORD> buffer(kNotifyBufferBytes / sizeof(DWORD));
+    bool readPending = false;
+    Changes pending;
+    bool havePending = false;
+    std::chrono::steady_clock::time_point firstChange{};
+    std::chrono::steady_clock::time_point lastChange{};
+
+    for (;;) {
+        if (!readPending) {
+            if (!ReadDirectoryChangesW(
+                    directory,
+                    buffer.data(),
+                    static_cast<DWORD>(buffer.size() * sizeof(DWORD)),
+                    TRUE,
+                    kNotifyFilter,
+                    nullptr,
+                    &overlapped,
+                    nullptr)) {
+                logger_.warn("Library watcher: ReadDirectoryChangesW failed (error " + std::to_string(GetLastError()) +
+                             "); live library updates stop.");
+                break;
+            }
+            readPending = true;
+        }
+
+        DWORD timeoutMs = INFINITE;
+        if (havePending) {
+            const auto deadline = std::min(lastChange + debounce_, firstChange + kMaxBatchDelay);
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            timeoutMs = remaining.count() > 0 ? static_cast<DWORD>(remaining.count()) : 0;
+        }
+
+        const DWORD wait = WaitForMultipleObjects(2, waitHandles, FALSE, timeoutMs);
+        if (wait == WAIT_OBJECT_0 + 1) {
+            break;
+        }
+        if (wait == WAIT_TIMEOUT) {
+            logger_.info([&]() {
+                return "Library watcher: " + std::to_string(pending.sources.size()) + " source folder(s) changed" +
+                       (pending.rescanAll ? ", full rescan needed." : ".");
+            });
+            callback_(std::exchange(pending, Changes{}));
+            havePending = false;
+            continue;
+        }
+        if (wait != WAIT_OBJECT_0) {
+            logger_.warn("Library watcher: wait failed; live library updates stop.");
+            break;
+        }
+
+        readPending = false;
+        DWORD bytes = 0;
+        if (GetOverlappedResult(directory, &overlapped, &bytes, FALSE)) {
+            // Zero bytes means the system buffer overflowed and the individual changes are lost.
+            if (bytes == 0) {
+                pending.rescanAll = true;
+            } else {
+                collectChanges(buffer, bytes, pending);
+            }
+        } else if (GetLastError() == ERROR_NOTIFY_ENUM_DIR) {
+            pending.rescanAll = true;
+        } else {
+            logger_.warn("Library watcher: change notification failed (error " + std::to_string(GetLastError()) +
+                         "); live library updates stop.");
+            break;
+        }
+
+        if (!pending.rescanAll && pending.sources.empty()) {
+            continue;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (!havePending) {
+            firstChange = now;
+            havePending = true;
+        }
+        lastChange = now;
+    }
+
+    if (readPending) {
+        DWORD bytes = 0;
+        (void)CancelIoEx(directory, &overlapped);
+        (void)GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+    }
+    CloseHandle(overlapped.hEvent);
+}
+
+void LibraryWatcher::collectChanges(const std::vector<unsigned long>& buffer, unsigned long bytes, Changes& changes)
+{
+    const auto* base = reinterpret_cast<const std::uint8_t*>(buffer.data());
+    std::size_t offset = 0;
+    for (;;) {
+        if (offset + sizeof(FILE_NOTIFY_INFORMATION) > bytes) {
+            break;
+        }
+        const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(base + offset);
+        const std::filesystem::path relative(std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+
+        auto part = relative.begin();
+        if (part != relative.end()) {
+            const std::filesystem::path category = *part;
+            const std::wstring categoryLower = lowerWide(category.wstring());
+            ++part;
+            if (categoryLower == L"fx") {
+                changes.sources.insert(category);
+            } else if (categoryLower == L"playlists" || categoryLower == L"stations") {
+                // The category folder itself was created, removed or renamed. Its write time also
+                // moves whenever a source folder is added below it, which the child entry covers.
+                if (part == relative.end()) {
+                    changes.rescanAll = changes.rescanAll || info->Action != FILE_ACTION_MODIFIED;
+                } else {
+                    changes.sources.insert(category / *part);
+                }
+            }
+        }
+
+        if (info->NextEntryOffset == 0) {
+            break;
+        }
+        offset += info->NextEntryOffset;
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "logger.h"
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Watches the radio root with overlapped ReadDirectoryChangesW and reports which source folders
+// changed once a burst of notifications has settled, so copying 500 files into a playlist ends as
+// one report for that playlist instead of 500 rescans. Only Playlists/<source>, Stations/<source>
+// and FX are reported; everything else under the root is ignored.
+class LibraryWatcher
+{
+public:
+    struct Changes
+    {
+        // Relative to the radio root and cut to the source folder: "Playlists/Rock", "FX".
+        std::set<std::filesystem::path> sources;
+        // The notification buffer overflowed or a category folder itself changed; only a full
+        // rescan can tell what happened.
+        bool rescanAll{ false };
+    };
+
+    // Runs on the watcher thread.
+    using Callback = std::function<void(Changes changes)>;
+
+    // Returns null when the root cannot be opened for change notifications.
+    static std::unique_ptr<LibraryWatcher> start(
+        Logger& logger,
+        const std::filesystem::path& radioRootPath,
+        std::chrono::milliseconds debounce,
+        Callback callback);
+
+    ~LibraryWatcher();
+
+    LibraryWatcher(const LibraryWatcher&) = delete;
+    LibraryWatcher& operator=(const LibraryWatcher&) = delete;
+
+    // Stops and joins the watcher thread. Must not be called while holding a lock the callback takes.
+    void shutdown();
+
+private:
+    LibraryWatcher(Logger& logger, void* directory, void* stopEvent, std::chrono::milliseconds debounce, Callback callback);
+
+    void threadMain();
+    static void collectChanges(const std::vector<unsigned long>& buffer, unsigned long bytes, Changes& changes);
+
+    Logger& logger_;
+    void* directory_{ nullptr };  // HANDLE
+    void* stopEvent_{ nullptr };  // HANDLE
+    std::chrono::milliseconds debounce_;
+    Callback callback_;
+    std::thread thread_;
+};
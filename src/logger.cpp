@@ -1,10 +1,7 @@
 #include "logger.h"
 
-#include <chrono>
 #include <cctype>
-#include <ctime>
-#include <iomanip>
-#include <sstream>
+#include <cstdio>
 #include <algorithm>
 
 #include <shlobj.h>
@@ -23,38 +20,97 @@ std::string toLowerAscii(std::string value)
     });
     return value;
 }
+
+const char* levelLabel(Logger::Level level)
+{
+    switch (level) {
+    case Logger::Level::Info:
+        return "INFO";
+    case Logger::Level::Warn:
+        return "WARN";
+    case Logger::Level::Error:
+        return "ERROR";
+    }
+    return "INFO";
+}
 }
 
-bool Logger::initialize()
+Logger::Logger()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    // Vyukov bounded queue: slot i starts out writable by the producer that claims position i.
+    for (std::size_t i = 0; i < kRingCapacity; ++i) {
+        ring_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger()
+{
+    // Static destruction runs in DLL_PROCESS_DETACH under the loader lock, where a join can deadlock.
+    // On process exit the writer is already terminated; any other unload has called shutdown() first.
+    if (writer_.joinable()) {
+        writer_.detach();
+    }
+    drainForProcessExit();
+}
 
-    logPath_ = resolveLogPath();
-    std::error_code ec;
-    std::filesystem::create_directories(logPath_.parent_path(), ec);
+bool Logger::initialize()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
 
-    stream_.open(logPath_, std::ios::out | std::ios::app);
-    if (!stream_.is_open()) {
-        logPath_ = fallbackLogPath();
+        logPath_ = resolveLogPath();
+        std::error_code ec;
         std::filesystem::create_directories(logPath_.parent_path(), ec);
+
         stream_.open(logPath_, std::ios::out | std::ios::app);
+        if (!stream_.is_open()) {
+            logPath_ = fallbackLogPath();
+            std::filesystem::create_directories(logPath_.parent_path(), ec);
+            stream_.open(logPath_, std::ios::out | std::ios::app);
+        }
+
+        if (!stream_.is_open()) {
+            return false;
+        }
     }
 
-    if (!stream_.is_open()) {
-        return false;
+    if (!writer_.joinable()) {
+        stopWriter_.store(false, std::memory_order_release);
+        writer_ = std::thread(&Logger::writerMain, this);
     }
+    accepting_.store(true, std::memory_order_release);
 
-    if (static_cast<int>(Level::Info) >= static_cast<int>(minimumLevel_)) {
-        stream_ << '[' << timestamp() << "] [INFO] Logger initialized.\n";
+    info("Logger initialized.");
+    return true;
+}
+
+void Logger::shutdown()
+{
+    accepting_.store(false, std::memory_order_release);
+    if (writer_.joinable()) {
+        stopWriter_.store(true, std::memory_order_release);
+        published_.fetch_add(1, std::memory_order_release);
+        published_.notify_one();
+        writer_.join();
+    }
+    drainForProcessExit();
+}
+
+void Logger::drainForProcessExit()
+{
+    accepting_.store(false, std::memory_order_release);
+
+    // Write out what a writer terminated by process exit left in the ring. If it died holding the
+    // lock, the stream is not safe to touch.
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (lock.owns_lock() && drainLocked() > 0) {
         stream_.flush();
     }
-    return true;
 }
 
 void Logger::setLevel(Level level)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    minimumLevel_ = level;
+    minimumLevel_.store(level, std::memory_order_relaxed);
 }
 
 bool Logger::setLevelFromString(const std::string& levelText)
@@ -77,23 +133,49 @@ bool Logger::setLevelFromString(const std::string& levelText)
 
 Logger::Level Logger::level() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return minimumLevel_;
+    return minimumLevel_.load(std::memory_order_relaxed);
 }
 
-void Logger::info(const std::string& message)
+void Logger::info(const char* message)
 {
-    write(Level::Info, "INFO", message);
+    if (isEnabled(Level::Info)) {
+        push(Level::Info, message);
+    }
 }
 
-void Logger::warn(const std::string& message)
+void Logger::info(std::string message)
 {
-    write(Level::Warn, "WARN", message);
+    if (isEnabled(Level::Info)) {
+        push(Level::Info, std::move(message));
+    }
 }
 
-void Logger::error(const std::string& message)
+void Logger::warn(const char* message)
 {
-    write(Level::Error, "ERROR", message);
+    if (isEnabled(Level::Warn)) {
+        push(Level::Warn, message);
+    }
+}
+
+void Logger::warn(std::string message)
+{
+    if (isEnabled(Level::Warn)) {
+        push(Level::Warn, std::move(message));
+    }
+}
+
+void Logger::error(const char* message)
+{
+    if (isEnabled(Level::Error)) {
+        push(Level::Error, message);
+    }
+}
+
+void Logger::error(std::string message)
+{
+    if (isEnabled(Level::Error)) {
+        push(Level::Error, std::move(message));
+    }
 }
 
 std::filesystem::path Logger::path() const
@@ -102,18 +184,93 @@ std::filesystem::path Logger::path() const
     return logPath_;
 }
 
-void Logger::write(Level level, const char* levelLabel, const std::string& message)
+void Logger::push(Level level, std::string message)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!stream_.is_open()) {
+    if (!accepting_.load(std::memory_order_acquire)) {
         return;
     }
-    if (static_cast<int>(level) < static_cast<int>(minimumLevel_)) {
+
+    const auto now = std::chrono::system_clock::now();
+    if (level != Level::Info) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        (void)drainLocked();
+        writeLineLocked(level, now, message);
+        stream_.flush();
         return;
     }
 
-    stream_ << '[' << timestamp() << "] [" << levelLabel << "] " << message << '\n';
-    stream_.flush();
+    std::size_t position = enqueuePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Entry& entry = ring_[position % kRingCapacity];
+        const std::size_t sequence = entry.sequence.load(std::memory_order_acquire);
+        const auto lag = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+        if (lag == 0) {
+            if (enqueuePos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                entry.level = level;
+                entry.time = now;
+                entry.message = std::move(message);
+                entry.sequence.store(position + 1, std::memory_order_release);
+                published_.fetch_add(1, std::memory_order_release);
+                published_.notify_one();
+                return;
+            }
+        } else if (lag < 0) {
+            // Ring full: the line is dropped and counted.
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::writerMain()
+{
+    for (;;) {
+        const std::uint32_t seen = published_.load(std::memory_order_acquire);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (drainLocked() > 0) {
+                stream_.flush();
+            }
+        }
+        if (stopWriter_.load(std::memory_order_acquire)) {
+            break;
+        }
+        published_.wait(seen, std::memory_order_acquire);
+    }
+}
+
+std::size_t Logger::drainLocked()
+{
+    std::size_t written = 0;
+    for (;;) {
+        Entry& entry = ring_[dequeuePos_ % kRingCapacity];
+        if (entry.sequence.load(std::memory_order_acquire) != dequeuePos_ + 1) {
+            break;
+        }
+
+        writeLineLocked(entry.level, entry.time, entry.message);
+        entry.message.clear();
+        entry.sequence.store(dequeuePos_ + kRingCapacity, std::memory_order_release);
+        ++dequeuePos_;
+        ++written;
+    }
+
+    const std::uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0 && stream_.is_open()) {
+        stream_ << '[' << timestampFor(std::chrono::system_clock::now()) << "] [WARN] "
+                << dropped << " log lines dropped (log buffer full).\n";
+        ++written;
+    }
+    return written;
+}
+
+void Logger::writeLineLocked(Level level, std::chrono::system_clock::time_point time, const std::string& message)
+{
+    if (stream_.is_open()) {
+        stream_ << '[' << timestampFor(time) << "] [" << levelLabel(level) << "] " << message << '\n';
+    }
 }
 
 std::filesystem::path Logger::resolveLogPath() const
@@ -133,11 +290,14 @@ std::filesystem::path Logger::resolveLogPath() const
     return base / "My Games" / "Starfield" / "SFSE" / "Logs" / "RadioSFSE.log";
 }
 
-std::string Logger::timestamp()
+const std::string& Logger::timestampFor(std::chrono::system_clock::time_point time)
 {
+    // Under mutex_ only. Lines arrive in bursts within the same second, so format once per second.
     using Clock = std::chrono::system_clock;
-    const auto now = Clock::now();
-    const std::time_t tt = Clock::to_time_t(now);
+    const std::time_t tt = Clock::to_time_t(time);
+    if (tt == cachedSecond_) {
+        return cachedTimestamp_;
+    }
 
     std::tm tm{};
 #ifdef _WIN32
@@ -146,7 +306,18 @@ std::string Logger::timestamp()
     localtime_r(&tt, &tm);
 #endif
 
-    std::ostringstream out;
-    out << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return out.str();
+    char buffer[32]{};
+    std::snprintf(
+        buffer,
+        sizeof(buffer),
+        "%04d-%02d-%02d %02d:%02d:%02d",
+        tm.tm_year + 1900,
+        tm.tm_mon + 1,
+        tm.tm_mday,
+        tm.tm_hour,
+        tm.tm_min,
+        tm.tm_sec);
+    cachedSecond_ = tt;
+    cachedTimestamp_ = buffer;
+    return cachedTimestamp_;
 }
@@ -1,10 +1,22 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <ctime>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 
+// Producers push info lines into a bounded lock-free ring; a writer thread drains it, stamps each
+// line and flushes once per batch. Warnings and errors are written and flushed by the caller, after
+// whatever is queued, so they survive a crash. Callers that build a message should use the lazy
+// overloads (or isEnabled) so filtered levels cost one atomic load.
 class Logger
 {
 public:
@@ -15,23 +27,85 @@ public:
         Error = 2
     };
 
+    Logger();
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
     bool initialize();
+    // Stops and joins the writer; never call it from DllMain.
+    void shutdown();
+    // Writes out what is left in the ring without touching the writer, for DLL_PROCESS_DETACH at exit.
+    void drainForProcessExit();
     void setLevel(Level level);
     bool setLevelFromString(const std::string& levelText);
     Level level() const;
-    void info(const std::string& message);
-    void warn(const std::string& message);
-    void error(const std::string& message);
+
+    bool isEnabled(Level level) const
+    {
+        return static_cast<int>(level) >= static_cast<int>(minimumLevel_.load(std::memory_order_relaxed));
+    }
+
+    void info(const char* message);
+    void info(std::string message);
+    void warn(const char* message);
+    void warn(std::string message);
+    void error(const char* message);
+    void error(std::string message);
+
+    template <typename MakeMessage>
+        requires std::invocable<MakeMessage&>
+    void info(MakeMessage&& makeMessage)
+    {
+        if (isEnabled(Level::Info)) {
+            push(Level::Info, std::string(makeMessage()));
+        }
+    }
+
+    template <typename MakeMessage>
+        requires std::invocable<MakeMessage&>
+    void warn(MakeMessage&& makeMessage)
+    {
+        if (isEnabled(Level::Warn)) {
+            push(Level::Warn, std::string(makeMessage()));
+        }
+    }
 
     std::filesystem::path path() const;
 
 private:
-    void write(Level level, const char* levelLabel, const std::string& message);
+    static constexpr std::size_t kRingCapacity = 1024;
+
+    struct Entry
+    {
+        std::atomic<std::size_t> sequence{ 0 };
+        Level level{ Level::Info };
+        std::chrono::system_clock::time_point time{};
+        std::string message;
+    };
+
+    void push(Level level, std::string message);
+    void writerMain();
+    std::size_t drainLocked();
+    void writeLineLocked(Level level, std::chrono::system_clock::time_point time, const std::string& message);
     std::filesystem::path resolveLogPath() const;
-    static std::string timestamp();
+    const std::string& timestampFor(std::chrono::system_clock::time_point time);
 
     mutable std::mutex mutex_;
     std::ofstream stream_;
     std::filesystem::path logPath_;
-    Level minimumLevel_{ Level::Warn };
+    std::atomic<Level> minimumLevel_{ Level::Warn };
+
+    std::array<Entry, kRingCapacity> ring_{};
+    std::atomic<std::size_t> enqueuePos_{ 0 };
+    std::size_t dequeuePos_{ 0 };
+    std::atomic<std::uint32_t> published_{ 0 };
+    std::atomic<std::uint64_t> dropped_{ 0 };
+    std::atomic<bool> accepting_{ false };
+    std::atomic<bool> stopWriter_{ false };
+    std::thread writer_;
+
+    std::time_t cachedSecond_{ -1 };
+    std::string cachedTimestamp_;
 };
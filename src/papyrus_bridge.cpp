@@ -8,10 +8,14 @@
 #include "RE/T/TESObjectREFR.h"
 #include "RE/V/VirtualMachine.h"
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <variant>
+#include <vector>
 
 namespace
 {
@@ -33,8 +37,11 @@ constexpr std::uint64_t kFixedDeviceIdBase = 0x0001'0000'0000ULL;
 // Fixed terminal refs register via notifyDeviceClass(ref, 1); their placed ref form ID maps to
 // kFixedDeviceIdBase | baseFormId. Portable refs are never registered here; they fall back to
 // kPortableDeviceId unless Papyrus explicitly registers the player ref as headset class.
-std::mutex g_deviceClassMutex;
-std::unordered_map<std::uint32_t, std::uint64_t> g_formIdToDeviceId;
+// Every native resolves through this map, while registrations are rare, so readers take an
+// immutable snapshot and writers publish a modified copy (serialized by g_deviceClassWriteMutex).
+using DeviceClassMap = std::unordered_map<std::uint32_t, std::uint64_t>;
+std::mutex g_deviceClassWriteMutex;
+std::atomic<std::shared_ptr<const DeviceClassMap>> g_formIdToDeviceId{ std::make_shared<const DeviceClassMap>() };
 
 std::uint64_t deviceKeyFromRef(RE::TESObjectREFR* activatorRef)
 {
@@ -43,12 +50,9 @@ std::uint64_t deviceKeyFromRef(RE::TESObjectREFR* activatorRef)
     }
 
     const auto formId = activatorRef->GetFormID();
-    {
-        std::lock_guard<std::mutex> lock(g_deviceClassMutex);
-        const auto it = g_formIdToDeviceId.find(formId);
-        if (it != g_formIdToDeviceId.end()) {
-            return it->second;
-        }
+    const auto map = g_formIdToDeviceId.load(std::memory_order_acquire);
+    if (const auto it = map->find(formId); it != map->end()) {
+        return it->second;
     }
     // Default: portable device. Also covers the player ref (formId == 0x14 == kPortableDeviceId).
     return kPortableDeviceId;
@@ -171,7 +175,7 @@ void PapyrusBridge::onSFSEMessage(SFSEMessagingInterface::Message* message)
         return;
     }
 
-    self->logger_.info(std::string("[M5] SFSE message received: ") + messageTypeName(message->type));
+    self->logger_.info([&]() { return std::string("[M5] SFSE message received: ") + messageTypeName(message->type); });
     if (message->type == SFSEMessagingInterface::kMessage_PreSaveGame) {
         self->engine_.savePersistentSession();
     } else if (message->type == SFSEMessagingInterface::kMessage_PostLoadGame) {
@@ -214,8 +218,10 @@ bool PapyrusBridge::tryRegisterNatives(const char* reason)
     if (vmImpl == nullptr) {
         if (!waitingLogged_) {
             waitingLogged_ = true;
-            logger_.info(std::string("[M5] Waiting for Papyrus VM before native registration (trigger=") +
-                         (reason ? reason : "unknown") + ").");
+            logger_.info([&]() {
+                return std::string("[M5] Waiting for Papyrus VM before native registration (trigger=") +
+                       (reason ? reason : "unknown") + ").";
+            });
         }
         return false;
     }
@@ -261,35 +267,94 @@ bool PapyrusBridge::tryRegisterNatives(const char* reason)
     vm->BindNativeMethod(kScriptName, "playFx", &PapyrusBridge::nativePlayFx, std::nullopt, false);
     vm->BindNativeMethod(kScriptName, "stopFx", &PapyrusBridge::nativeStopFx, std::nullopt, false);
     vm->BindNativeMethod(kScriptName, "lastError", &PapyrusBridge::nativeLastError, std::nullopt, false);
+    vm->BindNativeMethod(kScriptName, "getStats", &PapyrusBridge::nativeGetStats, std::nullopt, false);
+    vm->BindNativeMethod(kScriptName, "reloadConfig", &PapyrusBridge::nativeReloadConfig, std::nullopt, false);
     vm->BindNativeMethod(kScriptName, "notifyDeviceClass", &PapyrusBridge::nativeNotifyDeviceClass, std::nullopt, false);
     vm->BindNativeMethod(kScriptName, "set_positions", &PapyrusBridge::nativeSetPositions, std::nullopt, false);
+    vm->BindNativeMethod(kScriptName, "pollStatus", &PapyrusBridge::nativePollStatus, std::nullopt, false);
 
     registered_ = true;
-    logger_.info(std::string("[M6] Papyrus natives registered via CommonLibSF (script=") + kScriptName +
-                 ", trigger=" + (reason ? reason : "unknown") + ").");
+    logger_.info([&]() {
+        return std::string("[M6] Papyrus natives registered via CommonLibSF (script=") + kScriptName +
+               ", trigger=" + (reason ? reason : "unknown") + ").";
+    });
 
     return true;
 }
 
-bool PapyrusBridge::shouldAcceptCommand(const char* commandName, const void* activatorRef)
+const char* PapyrusBridge::bridgeCommandName(const BridgeCommand command)
 {
-    const auto now = std::chrono::steady_clock::now();
+    switch (command) {
+    case BridgeCommand::ChangePlaylist:
+        return "change_playlist";
+    case BridgeCommand::Play:
+        return "play";
+    case BridgeCommand::Start:
+        return "start";
+    case BridgeCommand::Pause:
+        return "pause";
+    case BridgeCommand::Stop:
+        return "stop";
+    case BridgeCommand::Forward:
+        return "forward";
+    case BridgeCommand::Rewind:
+        return "rewind";
+    case BridgeCommand::Previous:
+        return "previous";
+    case BridgeCommand::ChangeToNextSource:
+        return "changeToNextSource";
+    case BridgeCommand::SelectNextSource:
+        return "selectNextSource";
+    case BridgeCommand::SetFadeParams:
+        return "setFadeParams";
+    case BridgeCommand::VolumeUp:
+        return "volumeUp";
+    case BridgeCommand::VolumeDown:
+        return "volumeDown";
+    case BridgeCommand::SetVolume:
+        return "setVolume";
+    case BridgeCommand::SetPlayMode:
+        return "setPlayMode";
+    case BridgeCommand::SetTrack:
+        return "setTrack";
+    case BridgeCommand::PlayFx:
+        return "playFx";
+    case BridgeCommand::StopFx:
+        return "stopFx";
+    case BridgeCommand::Count:
+        break;
+    }
+    return "unknown";
+}
+
+bool PapyrusBridge::shouldAcceptCommand(const BridgeCommand command, const void* activatorRef)
+{
+    const std::int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count();
     const std::uintptr_t refKey = reinterpret_cast<std::uintptr_t>(activatorRef);
-    const std::string command = commandName ? commandName : "";
-
-    std::lock_guard<std::mutex> lock(commandMutex_);
-    if (command == lastCommandName_ && refKey == lastCommandRef_) {
-        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastCommandTime_);
-        if (elapsed < commandDebounce_) {
-            logger_.info("Papyrus duplicate command ignored: " + command +
-                         " ref=0x" + std::to_string(refKey));
-            return false;
+    // Refs are heap objects; drop the alignment bits before mapping to a slot.
+    DebounceSlot& slot = debounceSlots_[(refKey >> 4) % kDebounceSlotCount];
+
+    std::uintptr_t owner = slot.ref.load(std::memory_order_acquire);
+    if (owner != refKey && slot.ref.compare_exchange_strong(owner, refKey, std::memory_order_acq_rel)) {
+        for (auto& stamp : slot.lastAcceptedNs) {
+            stamp.store(0, std::memory_order_relaxed);
         }
     }
 
-    lastCommandName_ = command;
-    lastCommandRef_ = refKey;
-    lastCommandTime_ = now;
+    auto& stamp = slot.lastAcceptedNs[static_cast<std::size_t>(command)];
+    const std::int64_t debounceNs = std::chrono::duration_cast<std::chrono::nanoseconds>(commandDebounce_).count();
+    std::int64_t previous = stamp.load(std::memory_order_relaxed);
+    do {
+        if (previous != 0 && nowNs - previous < debounceNs) {
+            logger_.info([&]() {
+                return std::string("Papyrus duplicate command ignored: ") + bridgeCommandName(command) +
+                       " ref=0x" + std::to_string(refKey);
+            });
+            return false;
+        }
+    } while (!stamp.compare_exchange_weak(previous, nowNs, std::memory_order_relaxed));
     return true;
 }
 
@@ -298,19 +363,28 @@ void PapyrusBridge::setLastError(const std::uint64_t deviceId, const std::string
     std::lock_guard<std::mutex> lock(lastErrorMutex_);
     if (message.empty()) {
         lastErrorByDevice_.erase(deviceId);
-        return;
+    } else {
+        lastErrorByDevice_[deviceId] = message;
     }
-    lastErrorByDevice_[deviceId] = message;
+    hasLastErrors_.store(!lastErrorByDevice_.empty(), std::memory_order_release);
 }
 
 void PapyrusBridge::clearLastError(const std::uint64_t deviceId)
 {
+    // Every successful native clears its device's error; the common case has none to clear.
+    if (!hasLastErrors_.load(std::memory_order_acquire)) {
+        return;
+    }
     std::lock_guard<std::mutex> lock(lastErrorMutex_);
     lastErrorByDevice_.erase(deviceId);
+    hasLastErrors_.store(!lastErrorByDevice_.empty(), std::memory_order_release);
 }
 
 std::string PapyrusBridge::getLastError(const std::uint64_t deviceId) const
 {
+    if (!hasLastErrors_.load(std::memory_order_acquire)) {
+        return {};
+    }
     std::lock_guard<std::mutex> lock(lastErrorMutex_);
     const auto it = lastErrorByDevice_.find(deviceId);
     if (it == lastErrorByDevice_.end()) {
@@ -326,7 +400,7 @@ void PapyrusBridge::nativeChangePlaylist(std::monostate, RE::TESObjectREFR* acti
         return;
     }
 
-    if (!self->shouldAcceptCommand("change_playlist", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::ChangePlaylist, activatorRef)) {
         return;
     }
 
@@ -346,13 +420,17 @@ void PapyrusBridge::nativeChangePlaylist(std::monostate, RE::TESObjectREFR* acti
 
         const std::string message = buildFailureMessage(bridge->engine_, deviceId, "change_playlist");
         bridge->setLastError(deviceId, message);
-        bridge->logger_.warn("Papyrus change_playlist failed for channel: " + channelName + " | " + message);
+        bridge->logger_.warn([&]() {
+            return "Papyrus change_playlist failed for channel: " + channelName + " | " + message;
+        });
     });
 
     if (!queued) {
         const std::string message = "Unable to queue playlist change.";
         self->setLastError(deviceId, message);
-        self->logger_.warn("Papyrus change_playlist failed for channel: " + channelName + " | " + message);
+        self->logger_.warn([&]() {
+            return "Papyrus change_playlist failed for channel: " + channelName + " | " + message;
+        });
         return;
     }
 }
@@ -364,7 +442,7 @@ void PapyrusBridge::nativePlay(std::monostate, RE::TESObjectREFR* activatorRef)
         return;
     }
 
-    if (!self->shouldAcceptCommand("play", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::Play, activatorRef)) {
         return;
     }
 
@@ -400,7 +478,7 @@ void PapyrusBridge::nativeStart(std::monostate, RE::TESObjectREFR* activatorRef)
         return;
     }
 
-    if (!self->shouldAcceptCommand("start", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::Start, activatorRef)) {
         return;
     }
 
@@ -420,13 +498,13 @@ void PapyrusBridge::nativeStart(std::monostate, RE::TESObjectREFR* activatorRef)
 
         const std::string message = buildFailureMessage(bridge->engine_, deviceId, "start");
         bridge->setLastError(deviceId, message);
-        bridge->logger_.warn("Papyrus start failed. " + message);
+        bridge->logger_.warn([&]() { return "Papyrus start failed. " + message; });
     });
 
     if (!queued) {
         const std::string message = "Unable to queue start command.";
         self->setLastError(deviceId, message);
-        self->logger_.warn("Papyrus start failed. " + message);
+        self->logger_.warn([&]() { return "Papyrus start failed. " + message; });
         return;
     }
 }
@@ -438,7 +516,7 @@ void PapyrusBridge::nativePause(std::monostate, RE::TESObjectREFR* activatorRef)
         return;
     }
 
-    if (!self->shouldAcceptCommand("pause", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::Pause, activatorRef)) {
         return;
     }
 
@@ -458,7 +536,7 @@ void PapyrusBridge::nativeStop(std::monostate, RE::TESObjectREFR* activatorRef)
         return;
     }
 
-    if (!self->shouldAcceptCommand("stop", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::Stop, activatorRef)) {
         return;
     }
 
@@ -494,7 +572,7 @@ void PapyrusBridge::nativeForward(std::monostate, RE::TESObjectREFR* activatorRe
         return;
     }
 
-    if (!self->shouldAcceptCommand("forward", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::Forward, activatorRef)) {
         return;
     }
 
@@ -514,13 +592,13 @@ void PapyrusBridge::nativeForward(std::monostate, RE::TESObjectREFR* activatorRe
 
         const std::string message = buildFailureMessage(bridge->engine_, deviceId, "forward");
         bridge->setLastError(deviceId, message);
-        bridge->logger_.warn("Papyrus forward failed. " + message);
+        bridge->logger_.warn([&]() { return "Papyrus forward failed. " + message; });
     });
 
     if (!queued) {
         const std::string message = "Unable to queue forward command.";
         self->setLastError(deviceId, message);
-        self->logger_.warn("Papyrus forward failed. " + message);
+        self->logger_.warn([&]() { return "Papyrus forward failed. " + message; });
         return;
     }
 }
@@ -532,7 +610,7 @@ void PapyrusBridge::nativeRewind(std::monostate, RE::TESObjectREFR* activatorRef
         return;
     }
 
-    if (!self->shouldAcceptCommand("rewind", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::Rewind, activatorRef)) {
         return;
     }
 
@@ -552,13 +630,13 @@ void PapyrusBridge::nativeRewind(std::monostate, RE::TESObjectREFR* activatorRef
 
         const std::string message = buildFailureMessage(bridge->engine_, deviceId, "rewind");
         bridge->setLastError(deviceId, message);
-        bridge->logger_.warn("Papyrus rewind failed. " + message);
+        bridge->logger_.warn([&]() { return "Papyrus rewind failed. " + message; });
     });
 
     if (!queued) {
         const std::string message = "Unable to queue rewind command.";
         self->setLastError(deviceId, message);
-        self->logger_.warn("Papyrus rewind failed. " + message);
+        self->logger_.warn([&]() { return "Papyrus rewind failed. " + message; });
         return;
     }
 }
@@ -570,7 +648,7 @@ void PapyrusBridge::nativePrevious(std::monostate, RE::TESObjectREFR* activatorR
         return;
     }
 
-    if (!self->shouldAcceptCommand("previous", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::Previous, activatorRef)) {
         return;
     }
 
@@ -590,13 +668,13 @@ void PapyrusBridge::nativePrevious(std::monostate, RE::TESObjectREFR* activatorR
 
         const std::string message = buildFailureMessage(bridge->engine_, deviceId, "previous");
         bridge->setLastError(deviceId, message);
-        bridge->logger_.warn("Papyrus previous failed. " + message);
+        bridge->logger_.warn([&]() { return "Papyrus previous failed. " + message; });
     });
 
     if (!queued) {
         const std::string message = "Unable to queue previous command.";
         self->setLastError(deviceId, message);
-        self->logger_.warn("Papyrus previous failed. " + message);
+        self->logger_.warn([&]() { return "Papyrus previous failed. " + message; });
         return;
     }
 }
@@ -643,7 +721,7 @@ bool PapyrusBridge::nativeChangeToNextSource(std::monostate, RE::TESObjectREFR*
         return false;
     }
 
-    if (!self->shouldAcceptCommand("changeToNextSource", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::ChangeToNextSource, activatorRef)) {
         return false;
     }
 
@@ -664,7 +742,7 @@ bool PapyrusBridge::nativeSelectNextSource(std::monostate, RE::TESObjectREFR* ac
         return false;
     }
 
-    if (!self->shouldAcceptCommand("selectNextSource", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::SelectNextSource, activatorRef)) {
         return false;
     }
 
@@ -690,7 +768,7 @@ bool PapyrusBridge::nativeSetFadeParams(
         return false;
     }
 
-    if (!self->shouldAcceptCommand("setFadeParams", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::SetFadeParams, activatorRef)) {
         return false;
     }
 
@@ -711,7 +789,7 @@ bool PapyrusBridge::nativeVolumeUp(std::monostate, RE::TESObjectREFR* activatorR
         return false;
     }
 
-    if (!self->shouldAcceptCommand("volumeUp", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::VolumeUp, activatorRef)) {
         return false;
     }
 
@@ -732,7 +810,7 @@ bool PapyrusBridge::nativeVolumeDown(std::monostate, RE::TESObjectREFR* activato
         return false;
     }
 
-    if (!self->shouldAcceptCommand("volumeDown", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::VolumeDown, activatorRef)) {
         return false;
     }
 
@@ -823,7 +901,7 @@ bool PapyrusBridge::nativeSetVolume(std::monostate, RE::TESObjectREFR* activator
         return false;
     }
 
-    if (!self->shouldAcceptCommand("setVolume", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::SetVolume, activatorRef)) {
         return false;
     }
 
@@ -844,7 +922,7 @@ bool PapyrusBridge::nativeSetPlayMode(std::monostate, RE::TESObjectREFR* activat
         return false;
     }
 
-    if (!self->shouldAcceptCommand("setPlayMode", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::SetPlayMode, activatorRef)) {
         return false;
     }
 
@@ -875,7 +953,7 @@ bool PapyrusBridge::nativeSetTrack(std::monostate, RE::TESObjectREFR* activatorR
         return false;
     }
 
-    if (!self->shouldAcceptCommand("setTrack", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::SetTrack, activatorRef)) {
         return false;
     }
 
@@ -910,7 +988,7 @@ bool PapyrusBridge::nativePlayFx(std::monostate, RE::TESObjectREFR* activatorRef
         return false;
     }
 
-    if (!self->shouldAcceptCommand("playFx", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::PlayFx, activatorRef)) {
         return false;
     }
 
@@ -945,7 +1023,7 @@ bool PapyrusBridge::nativeStopFx(std::monostate, RE::TESObjectREFR* activatorRef
         return false;
     }
 
-    if (!self->shouldAcceptCommand("stopFx", activatorRef)) {
+    if (!self->shouldAcceptCommand(BridgeCommand::StopFx, activatorRef)) {
         return false;
     }
 
@@ -983,6 +1061,28 @@ std::string PapyrusBridge::nativeLastError(std::monostate, RE::TESObjectREFR* ac
     return self->getLastError(deviceKeyFromRef(activatorRef));
 }
 
+std::vector<std::string> PapyrusBridge::nativeGetStats(std::monostate, RE::TESObjectREFR*)
+{
+    PapyrusBridge* self = g_instance_;
+    if (self == nullptr) {
+        return {};
+    }
+
+    // Engine-wide; the ref is accepted only to match the rest of the native surface.
+    return self->engine_.statsLines();
+}
+
+bool PapyrusBridge::nativeReloadConfig(std::monostate, RE::TESObjectREFR*)
+{
+    PapyrusBridge* self = g_instance_;
+    if (self == nullptr) {
+        return false;
+    }
+
+    // Engine-wide, like getStats.
+    return self->engine_.reloadConfig();
+}
+
 void PapyrusBridge::nativeNotifyDeviceClass(std::monostate, RE::TESObjectREFR* activatorRef, std::int32_t deviceClass)
 {
     PapyrusBridge* self = g_instance_;
@@ -1004,11 +1104,18 @@ void PapyrusBridge::nativeNotifyDeviceClass(std::monostate, RE::TESObjectREFR* a
     }
 
     {
-        std::lock_guard<std::mutex> lock(g_deviceClassMutex);
-        g_formIdToDeviceId[formId] = deviceId;
+        std::lock_guard<std::mutex> lock(g_deviceClassWriteMutex);
+        const auto current = g_formIdToDeviceId.load(std::memory_order_acquire);
+        // Papyrus re-registers refs on every load and equip; skip the copy when nothing changes.
+        const auto it = current->find(formId);
+        if (it == current->end() || it->second != deviceId) {
+            auto updated = std::make_shared<DeviceClassMap>(*current);
+            (*updated)[formId] = deviceId;
+            g_formIdToDeviceId.store(std::move(updated), std::memory_order_release);
+        }
     }
 
-    if (self != nullptr) {
+    if (self != nullptr && self->logger_.isEnabled(Logger::Level::Info)) {
         std::ostringstream msg;
         msg << "[M6] notifyDeviceClass: formId=0x" << std::hex << formId
             << " class=" << std::dec << deviceClass
@@ -1049,3 +1156,53 @@ void PapyrusBridge::nativeSetPositions(
     }
     self->clearLastError(deviceId);
 }
+
+std::vector<std::string> PapyrusBridge::nativePollStatus(
+    std::monostate,
+    RE::TESObjectREFR* activatorRef,
+    bool pushPositions,
+    float activatorX,
+    float activatorY,
+    float activatorZ,
+    float playerX,
+    float playerY,
+    float playerZ,
+    float playerYawDeg)
+{
+    PapyrusBridge* self = g_instance_;
+    if (self == nullptr) {
+        return {};
+    }
+
+    // One round trip per timer tick. Layout (see RadioSFSENative.psc):
+    // [0] playing "1"/"0", [1] source name, [2] track basename, [3] volume percent,
+    // [4] media type, [5] track-change sequence, [6] last error.
+    const std::uint64_t deviceId = deviceKeyFromRef(activatorRef);
+    if (pushPositions) {
+        if (self->engine_.setPositions(
+                activatorX,
+                activatorY,
+                activatorZ,
+                playerX,
+                playerY,
+                playerZ,
+                playerYawDeg,
+                deviceId)) {
+            self->clearLastError(deviceId);
+        } else {
+            self->setLastError(deviceId, "Unable to update positional audio sample.");
+        }
+    }
+
+    RadioEngine::DeviceStatus status = self->engine_.deviceStatus(deviceId);
+    std::vector<std::string> packed;
+    packed.reserve(7);
+    packed.emplace_back(status.playing ? "1" : "0");
+    packed.push_back(std::move(status.sourceName));
+    packed.push_back(std::move(status.trackBasename));
+    packed.push_back(std::to_string(status.volumePercent));
+    packed.push_back(std::to_string(status.mediaType));
+    packed.push_back(std::to_string(status.trackSequence));
+    packed.push_back(self->getLastError(deviceId));
+    return packed;
+}
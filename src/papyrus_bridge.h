@@ -5,6 +5,7 @@
 
 #include "sfse/PluginAPI.h"
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <atomic>
@@ -12,6 +13,7 @@
 #include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 namespace RE
 {
@@ -30,13 +32,50 @@ public:
     bool isRegistered() const;
 
 private:
+    // Debounced native entry points. Each (ref, command) pair keeps its own timestamp, so radios
+    // and distinct commands never debounce each other.
+    enum class BridgeCommand : std::uint8_t
+    {
+        ChangePlaylist,
+        Play,
+        Start,
+        Pause,
+        Stop,
+        Forward,
+        Rewind,
+        Previous,
+        ChangeToNextSource,
+        SelectNextSource,
+        SetFadeParams,
+        VolumeUp,
+        VolumeDown,
+        SetVolume,
+        SetPlayMode,
+        SetTrack,
+        PlayFx,
+        StopFx,
+        Count
+    };
+
+    static constexpr std::size_t kBridgeCommandCount = static_cast<std::size_t>(BridgeCommand::Count);
+    static constexpr std::size_t kDebounceSlotCount = 32;
+
+    // Direct-mapped by ref pointer; a colliding ref takes the slot over and starts with clean stamps.
+    struct DebounceSlot
+    {
+        std::atomic<std::uintptr_t> ref{ 0 };
+        std::array<std::atomic<std::int64_t>, kBridgeCommandCount> lastAcceptedNs{};
+    };
+
+    static const char* bridgeCommandName(BridgeCommand command);
+
     static PapyrusBridge* g_instance_;
     static void onSFSEMessage(SFSEMessagingInterface::Message* message);
     static const char* messageTypeName(std::uint32_t type);
 
     bool installMessagingListener(const SFSEInterface* sfse);
     bool tryRegisterNatives(const char* reason);
-    bool shouldAcceptCommand(const char* commandName, const void* activatorRef);
+    bool shouldAcceptCommand(BridgeCommand command, const void* activatorRef);
     void setLastError(std::uint64_t deviceId, const std::string& message);
     void clearLastError(std::uint64_t deviceId);
     std::string getLastError(std::uint64_t deviceId) const;
@@ -77,6 +116,8 @@ private:
     static bool nativePlayFx(std::monostate, RE::TESObjectREFR* activatorRef, std::string fxBasename);
     static bool nativeStopFx(std::monostate, RE::TESObjectREFR* activatorRef);
     static std::string nativeLastError(std::monostate, RE::TESObjectREFR* activatorRef);
+    static std::vector<std::string> nativeGetStats(std::monostate, RE::TESObjectREFR* activatorRef);
+    static bool nativeReloadConfig(std::monostate, RE::TESObjectREFR* activatorRef);
     static void nativeNotifyDeviceClass(std::monostate, RE::TESObjectREFR* activatorRef, std::int32_t deviceClass);
     static void nativeSetPositions(
         std::monostate,
@@ -88,6 +129,17 @@ private:
         float playerY,
         float playerZ,
         float playerYawDeg);
+    static std::vector<std::string> nativePollStatus(
+        std::monostate,
+        RE::TESObjectREFR* activatorRef,
+        bool pushPositions,
+        float activatorX,
+        float activatorY,
+        float activatorZ,
+        float playerX,
+        float playerY,
+        float playerZ,
+        float playerYawDeg);
 
     Logger& logger_;
     RadioEngine& engine_;
@@ -95,12 +147,10 @@ private:
     bool installed_{ false };
     bool registered_{ false };
     bool waitingLogged_{ false };
-    std::mutex commandMutex_{};
-    std::string lastCommandName_{};
-    std::uintptr_t lastCommandRef_{ 0 };
-    std::chrono::steady_clock::time_point lastCommandTime_{};
+    std::array<DebounceSlot, kDebounceSlotCount> debounceSlots_{};
     std::chrono::milliseconds commandDebounce_{ 200 };
     std::atomic<bool> shuttingDown_{ false };
     mutable std::mutex lastErrorMutex_{};
     std::unordered_map<std::uint64_t, std::string> lastErrorByDevice_{};
+    std::atomic<bool> hasLastErrors_{ false };
 };
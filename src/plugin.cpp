@@ -46,6 +46,15 @@ static bool registerPapyrusBridge(const SFSEInterface* sfse)
     return g_papyrusBridge->initialize(sfse);
 }
 
+// A failed load may be followed by FreeLibrary, and DllMain cannot join threads; stop them here.
+static bool failLoad()
+{
+    g_papyrusBridge.reset();
+    g_engine.reset();
+    g_logger.shutdown();
+    return false;
+}
+
 extern "C" __declspec(dllexport) bool SFSEPlugin_Load(const SFSEInterface* sfse)
 {
     try {
@@ -60,7 +69,7 @@ extern "C" __declspec(dllexport) bool SFSEPlugin_Load(const SFSEInterface* sfse)
         g_engine = std::make_unique<RadioEngine>(g_logger);
         if (!g_engine->initialize()) {
             g_logger.error("Radio engine failed to initialize.");
-            return false;
+            return failLoad();
         }
 
         (void)registerPapyrusBridge(sfse);
@@ -69,10 +78,10 @@ extern "C" __declspec(dllexport) bool SFSEPlugin_Load(const SFSEInterface* sfse)
         return true;
     } catch (const std::exception& ex) {
         g_logger.error(std::string("Unhandled exception in SFSEPlugin_Load: ") + ex.what());
-        return false;
+        return failLoad();
     } catch (...) {
         g_logger.error("Unhandled unknown exception in SFSEPlugin_Load.");
-        return false;
+        return failLoad();
     }
 }
 
@@ -119,6 +128,11 @@ extern "C" __declspec(dllexport) bool rescan()
     return g_engine ? g_engine->rescanLibrary() : false;
 }
 
+extern "C" __declspec(dllexport) bool reload_config()
+{
+    return g_engine ? g_engine->reloadConfig() : false;
+}
+
 extern "C" __declspec(dllexport) bool set_positions(
     float emitterX,
     float emitterY,
@@ -213,7 +227,7 @@ extern "C" __declspec(dllexport) bool set_track(const char* trackBasename)
     return g_engine->setTrack(trackBasename);
 }
 
-BOOL APIENTRY DllMain(HMODULE module, DWORD reason, LPVOID)
+BOOL APIENTRY DllMain(HMODULE module, DWORD reason, LPVOID reserved)
 {
     if (reason == DLL_PROCESS_ATTACH) {
         DisableThreadLibraryCalls(module);
@@ -223,6 +237,11 @@ BOOL APIENTRY DllMain(HMODULE module, DWORD reason, LPVOID)
         // Avoid blocking work in DllMain (loader lock). Process teardown will reclaim resources.
         (void)g_papyrusBridge.release();
         (void)g_engine.release();
+        // Never join under the loader lock. Process exit (reserved != nullptr) has already terminated
+        // the writer, so only what it left queued is written out; a failed load stopped it in failLoad().
+        if (reserved != nullptr) {
+            g_logger.drainForProcessExit();
+        }
     }
     return TRUE;
 }
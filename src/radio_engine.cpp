@@ -1,19 +1,26 @@
 #include "radio_engine.h"
 
+#include "audio_mixer.h"
+#include "internet_session.h"
+
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <cctype>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <future>
 #include <limits>
 #include <memory>
 #include <optional>
 #include <random>
 #include <regex>
 #include <sstream>
+#include <system_error>
 
 #include <windows.h>
 #include <dshow.h>
@@ -28,8 +35,10 @@
 namespace
 {
 constexpr wchar_t kAlias[] = L"RadioSFSE";
+constexpr wchar_t kStandbyAlias[] = L"RadioSFSEStandby";
 constexpr wchar_t kFxAlias[] = L"RadioSFSE_FX";
 constexpr float kMinimumFadeGap = 1.0F;
+constexpr double kFadeSettleEpsilon = 0.0005;
 constexpr float kDefaultVolumePercent = 100.0F;
 constexpr float kMaximumVolumePercent = 200.0F;
 constexpr float kDefaultVolumeStepPercent = 5.0F;
@@ -37,14 +46,56 @@ constexpr std::size_t kMaxResolverBytes = 512 * 1024;
 constexpr std::size_t kMaxWrapperTempBytes = 128 * 1024;
 constexpr int kMaxResolveDepth = 4;
 constexpr DWORD kResolverTimeoutMs = 3500;
+constexpr DWORD kStreamProbeTimeoutMs = 2000;
+constexpr std::size_t kMaxParallelStreamProbes = 4;
+constexpr int kMaxStreamStandby = 4;
+// A source cycle stops the device before the follow-up play; standbys are kept this long across it.
+constexpr auto kStreamStandbyGrace = std::chrono::seconds(15);
+constexpr int kMaxLibraryAnalysisThreads = 8;
+constexpr int kMaxFxCacheMegabytes = 256;
+constexpr int kMaxStatsLogMinutes = 24 * 60;
+constexpr int kMaxLibraryWatchDebounceMs = 10000;
+constexpr double kMinNormalizationGainDb = -20.0;
+// Normalization only turns tracks down: the final level is clamped at full scale, so a boost would clip.
+constexpr double kMaxNormalizationGainDb = 0.0;
+constexpr auto kStreamProbeBudget = std::chrono::milliseconds(3000);
+constexpr auto kStreamProbeGraceAfterLive = std::chrono::milliseconds(250);
 constexpr auto kCommandWaitTimeout = std::chrono::milliseconds(5000);
+constexpr std::size_t kCommandQueueReserve = 64;
 constexpr auto kStreamStartWaitTimeout = std::chrono::milliseconds(10000);
+// Background reconnect: first retry after the initial delay, doubling per failed attempt up to the cap.
+constexpr auto kStreamReconnectInitialDelay = std::chrono::milliseconds(500);
+constexpr auto kStreamReconnectMaxDelay = std::chrono::milliseconds(30000);
+constexpr auto kStreamReconnectPoll = std::chrono::milliseconds(250);
+constexpr std::uint32_t kMaxStreamReconnectAttempts = 8;
+// A playing stream whose position has not moved for this long is treated as dropped.
+constexpr auto kStreamStallTimeout = std::chrono::milliseconds(15000);
 constexpr auto kStreamStartPoll = std::chrono::milliseconds(50);
 constexpr auto kSessionFlushInterval = std::chrono::seconds(1);
+// watch_config: how often the worker compares the INI's write time with the one last loaded.
+constexpr auto kConfigWatchInterval = std::chrono::seconds(2);
+constexpr auto kSessionPositionFlushInterval = std::chrono::seconds(15);
 constexpr std::uint64_t kPortableDeviceId  = 0x14;             // portable tuner (all portable refs including player ref)
 constexpr std::uint64_t kFixedDeviceIdBase = 0x0001'0000'0000ULL;  // fixed/terminal tuners: kFixedDeviceIdBase | baseFormId (stable, per radio model)
 constexpr std::uint64_t kResumeSeekMinimumMs = 250;
+constexpr int kPreloadLeadTimeMs = 2500;
+// Live station slots for files the analyzer has not measured yet.
+constexpr std::uint64_t kLiveFallbackSongMs = 210000;
+constexpr std::uint64_t kLiveFallbackClipMs = 15000;
+// Tuning in this close to the end of a slot starts the next one instead of a few seconds of tail.
+constexpr std::uint64_t kLiveMinimumTailMs = 2000;
+constexpr int kGaplessHandoffLeadMs = 40;
+// How often a previous track still finishing under a gapless handoff is checked, should its end notify not arrive.
+constexpr auto kStandbyDrainPoll = std::chrono::milliseconds(2 * kGaplessHandoffLeadMs);
+constexpr auto kPlaybackSafetyPoll = std::chrono::milliseconds(1000);
+constexpr auto kFileCompletionProbeDelay = std::chrono::milliseconds(800);
+constexpr auto kStreamCompletionProbeDelay = std::chrono::milliseconds(2500);
+constexpr wchar_t kNotifyWindowClass[] = L"RadioSFSEPlaybackNotify";
+constexpr UINT kPlaybackEventMessage = WM_APP + 0x31;
 constexpr char kSessionFileName[] = "RadioSFSE.session.json";
+constexpr char kLibraryIndexFileName[] = "RadioSFSE.library.json";
+constexpr char kStreamCacheFileName[] = "RadioSFSE.streamcache.json";
+constexpr char kFxIndexKey[] = "fx";
 
 std::mt19937_64& shuffleRng()
 {
@@ -52,6 +103,62 @@ std::mt19937_64& shuffleRng()
     return engine;
 }
 
+std::uint64_t splitMix64(std::uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Keyed bijection on [0, count): a four-round balanced Feistel network over the smallest even-width
+// power-of-two domain covering count, cycle-walked back into range (under four steps on average).
+std::size_t shufflePermute(std::uint64_t seed, std::uint64_t epoch, std::size_t count, std::size_t index, bool inverse)
+{
+    if (count <= 1) {
+        return 0;
+    }
+
+    constexpr unsigned kRounds = 4;
+    const unsigned halfBits = (static_cast<unsigned>(std::bit_width(static_cast<std::uint64_t>(count - 1))) + 1) / 2;
+    const std::uint64_t mask = (std::uint64_t{ 1 } << halfBits) - 1;
+    const std::uint64_t key = splitMix64(seed ^ splitMix64(epoch));
+    const auto roundValue = [key, mask](unsigned round, std::uint64_t half) {
+        return splitMix64((key + round * 0x9E3779B97F4A7C15ULL) ^ half) & mask;
+    };
+
+    std::uint64_t value = index;
+    do {
+        std::uint64_t left = value >> halfBits;
+        std::uint64_t right = value & mask;
+        if (!inverse) {
+            for (unsigned round = 0; round < kRounds; ++round) {
+                const std::uint64_t next = left ^ roundValue(round, right);
+                left = right;
+                right = next;
+            }
+        } else {
+            for (unsigned round = kRounds; round-- > 0;) {
+                const std::uint64_t previous = right ^ roundValue(round, left);
+                right = left;
+                left = previous;
+            }
+        }
+        value = (left << halfBits) | right;
+    } while (value >= count);
+    return static_cast<std::size_t>(value);
+}
+
+// FNV-1a; stable across runs and builds, unlike std::hash.
+std::uint64_t stableHash(std::string_view text)
+{
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const char c : text) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
 std::string toLowerCopy(std::string value)
 {
     std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
@@ -244,6 +351,15 @@ bool isLikelyRiskyDirectAudioUrlForMci(const std::string& url)
     return components.nPort != 0 && components.nPort != defaultPort;
 }
 
+template <typename PositionT>
+double distanceBetween(const PositionT& from, const PositionT& to)
+{
+    const double dx = static_cast<double>(to.x) - static_cast<double>(from.x);
+    const double dy = static_cast<double>(to.y) - static_cast<double>(from.y);
+    const double dz = static_cast<double>(to.z) - static_cast<double>(from.z);
+    return std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+}
+
 std::string formatHresult(const HRESULT hr)
 {
     char buffer[32]{};
@@ -251,6 +367,18 @@ std::string formatHresult(const HRESULT hr)
     return std::string(buffer);
 }
 
+// Every device owns a primary/standby MCI alias pair so devices can hold open files concurrently.
+std::wstring deviceAliasName(const wchar_t* prefix, const std::uint64_t deviceId)
+{
+    char buffer[32]{};
+    std::snprintf(buffer, sizeof(buffer), "_%016llX", static_cast<unsigned long long>(deviceId));
+    std::wstring alias(prefix);
+    for (const char* c = buffer; *c != '\0'; ++c) {
+        alias.push_back(static_cast<wchar_t>(*c));
+    }
+    return alias;
+}
+
 std::string mfStateName(const MFP_MEDIAPLAYER_STATE state)
 {
     switch (state) {
@@ -349,6 +477,7 @@ struct MfEventState
 {
     std::atomic<HRESULT> lastError{ S_OK };
     std::atomic<bool> playbackEnded{ false };
+    std::atomic<HWND> notifyWindow{ nullptr };
 };
 
 class MfPlayerCallback final : public IMFPMediaPlayerCallback
@@ -395,11 +524,20 @@ public:
             return;
         }
 
+        bool signal = false;
         if (FAILED(eventHeader->hrEvent)) {
             state_->lastError.store(eventHeader->hrEvent);
+            signal = true;
         }
         if (eventHeader->eEventType == MFP_EVENT_TYPE_PLAYBACK_ENDED) {
             state_->playbackEnded.store(true);
+            signal = true;
+        }
+
+        // MF calls back on its own thread; hand the wakeup to the notify window instead of touching engine locks here.
+        const HWND notifyWindow = state_->notifyWindow.load();
+        if (signal && notifyWindow != nullptr) {
+            (void)PostMessageW(notifyWindow, kPlaybackEventMessage, 0, 0);
         }
     }
 
@@ -408,7 +546,7 @@ private:
     std::shared_ptr<MfEventState> state_;
 };
 
-bool isLikelyBinaryContent(const std::string& text)
+bool isLikelyBinaryContent(std::string_view text)
 {
     if (text.empty()) {
         return false;
@@ -467,96 +605,247 @@ std::string combineRelativeUrl(const std::string& baseUrl, const std::string& en
     return combined;
 }
 
+enum class StreamProbeVerdict
+{
+    Unknown,
+    Live,
+    Dead
+};
+
+struct StreamProbeResult
+{
+    StreamProbeVerdict verdict{ StreamProbeVerdict::Unknown };
+    std::chrono::milliseconds latency{ 0 };
+    std::string contentType;
+};
+
+bool looksLikeAudioContentType(const std::string& contentType)
+{
+    const std::string lowered = toLowerCopy(contentType);
+    return lowered.starts_with("audio/") ||
+           lowered.starts_with("application/ogg") ||
+           lowered.starts_with("video/nsv");
+}
+
+// audio/x-scpls, audio/x-mpegurl and friends are playlists, not audio.
+bool looksLikeStreamingAudioContentType(const std::string& contentType)
+{
+    const std::string lowered = toLowerCopy(contentType);
+    return looksLikeAudioContentType(lowered) &&
+           lowered.find("mpegurl") == std::string::npos &&
+           lowered.find("scpls") == std::string::npos &&
+           lowered.find("xspf") == std::string::npos;
+}
+
+bool looksLikeAudioPayload(const unsigned char* bytes, std::size_t size)
+{
+    if (size >= 3 && bytes[0] == 'I' && bytes[1] == 'D' && bytes[2] == '3') {
+        return true;
+    }
+    if (size >= 4 && std::memcmp(bytes, "OggS", 4) == 0) {
+        return true;
+    }
+    if (size >= 4 && std::memcmp(bytes, "fLaC", 4) == 0) {
+        return true;
+    }
+    // MPEG audio frame sync / AAC ADTS: 11-12 set bits at the start of a frame.
+    return size >= 2 && bytes[0] == 0xFF && (bytes[1] & 0xE0) == 0xE0;
+}
+
 struct TextUrlResponse
 {
     bool ok{ false };
+    bool binary{ false };
     std::string body;
     std::string contentType;
     std::string finalUrl;
 };
 
-TextUrlResponse fetchUrlText(const std::string& url, const std::function<bool()>& shouldAbort = {})
+// Playlist wrappers are a few KB of text, so the first chunk decides: an audio content type or an
+// audio/binary head stops the download instead of buffering up to kMaxResolverBytes of a live stream.
+TextUrlResponse fetchUrlText(
+    const InternetSession* internet,
+    const std::string& url,
+    const std::function<bool()>& shouldAbort = {})
 {
     TextUrlResponse response{};
-    if (!isHttpUrl(url)) {
+    if (internet == nullptr || !isHttpUrl(url)) {
         return response;
     }
+
+    InternetSession::Request request{};
+    request.timeoutMs = kResolverTimeoutMs;
+    request.maxBodyBytes = kMaxResolverBytes;
+    request.acceptBody = [](const std::string& contentType, std::string_view head) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(head.data());
+        return !looksLikeStreamingAudioContentType(contentType) &&
+               !looksLikeAudioPayload(bytes, head.size()) &&
+               !isLikelyBinaryContent(head);
+    };
+
+    InternetSession::Response fetched = internet->get(url, request, shouldAbort);
+    response.binary = fetched.rejected;
+    response.body = std::move(fetched.body);
+    response.contentType = std::move(fetched.contentType);
+    response.finalUrl = std::move(fetched.finalUrl);
+    response.ok = !response.binary && !response.body.empty();
+    return response;
+}
+
+// Short GET that stops after the response headers and the first few body bytes. Good enough to
+// drop dead mirrors (connect failure, HTTP 4xx/5xx) and to spot actual audio without opening a backend.
+StreamProbeResult probeStreamUrl(
+    const InternetSession& internet,
+    const std::string& url,
+    const std::function<bool()>& shouldAbort)
+{
+    StreamProbeResult result{};
+    if (!isHttpUrl(url) || (shouldAbort && shouldAbort())) {
+        return result;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    InternetSession::Request request{};
+    request.timeoutMs = kStreamProbeTimeoutMs;
+    request.maxBodyBytes = 16;
+    const InternetSession::Response response = internet.get(url, request, shouldAbort);
+    result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
     if (shouldAbort && shouldAbort()) {
-        return response;
+        return result;
     }
 
-    HINTERNET internet = InternetOpenA("RadioSFSE/1.0", INTERNET_OPEN_TYPE_PRECONFIG, nullptr, nullptr, 0);
-    if (internet == nullptr) {
-        return response;
+    if (!response.connected || response.statusCode >= 400) {
+        result.verdict = StreamProbeVerdict::Dead;
+        return result;
     }
 
-    DWORD timeoutMs = kResolverTimeoutMs;
-    (void)InternetSetOptionA(internet, INTERNET_OPTION_CONNECT_TIMEOUT, &timeoutMs, sizeof(timeoutMs));
-    (void)InternetSetOptionA(internet, INTERNET_OPTION_SEND_TIMEOUT, &timeoutMs, sizeof(timeoutMs));
-    (void)InternetSetOptionA(internet, INTERNET_OPTION_RECEIVE_TIMEOUT, &timeoutMs, sizeof(timeoutMs));
+    result.contentType = response.contentType;
+    const auto* head = reinterpret_cast<const unsigned char*>(response.body.data());
+    if (looksLikeAudioContentType(result.contentType) || looksLikeAudioPayload(head, response.body.size())) {
+        result.verdict = StreamProbeVerdict::Live;
+    }
+    return result;
+}
 
-    const DWORD flags = INTERNET_FLAG_RELOAD | INTERNET_FLAG_NO_CACHE_WRITE | INTERNET_FLAG_NO_COOKIES;
-    HINTERNET request = InternetOpenUrlA(internet, url.c_str(), nullptr, 0, flags, 0);
-    if (request == nullptr) {
-        InternetCloseHandle(internet);
-        return response;
+struct StreamProbeBatch
+{
+    std::shared_ptr<InternetSession> internet;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> urls;
+    std::vector<std::optional<StreamProbeResult>> results;
+    std::size_t completed{ 0 };
+    std::atomic<bool> cancelled{ false };
+};
+
+// Probes candidates on the engine's probe pool (one job per URL, handed to post) and returns them
+// reordered: confirmed audio first (fastest response first), then undecided ones in their original
+// order. Dead ones are dropped, unless every candidate looks dead, in which case the original list
+// is kept. Jobs hold only the shared batch, so the caller can stop waiting; queued ones are skipped
+// and running ones see the cancel flag and close their requests within one wait slice.
+std::vector<std::string> rankStreamCandidatesByProbe(
+    const std::shared_ptr<InternetSession>& internet,
+    const std::vector<std::string>& candidates,
+    Logger& logger,
+    bool detailedLogs,
+    const std::function<bool(std::function<void()>)>& post,
+    const std::function<bool()>& shouldAbort)
+{
+    if (!internet) {
+        return candidates;
     }
 
-    (void)InternetSetOptionA(request, INTERNET_OPTION_CONNECT_TIMEOUT, &timeoutMs, sizeof(timeoutMs));
-    (void)InternetSetOptionA(request, INTERNET_OPTION_SEND_TIMEOUT, &timeoutMs, sizeof(timeoutMs));
-    (void)InternetSetOptionA(request, INTERNET_OPTION_RECEIVE_TIMEOUT, &timeoutMs, sizeof(timeoutMs));
+    auto batch = std::make_shared<StreamProbeBatch>();
+    batch->internet = internet;
+    batch->urls = candidates;
+    batch->results.resize(candidates.size());
 
-    DWORD headerSize = 0;
-    (void)HttpQueryInfoA(request, HTTP_QUERY_CONTENT_TYPE, nullptr, &headerSize, nullptr);
-    if (headerSize > 0 && GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
-        std::string contentType(static_cast<std::size_t>(headerSize), '\0');
-        if (HttpQueryInfoA(request, HTTP_QUERY_CONTENT_TYPE, contentType.data(), &headerSize, nullptr)) {
-            if (headerSize > 0 && contentType[headerSize - 1] == '\0') {
-                --headerSize;
+    for (std::size_t index = 0; index < candidates.size(); ++index) {
+        const bool posted = post([batch, index]() {
+            if (batch->cancelled.load()) {
+                return;
             }
-            contentType.resize(static_cast<std::size_t>(headerSize));
-            response.contentType = trimAsciiCopy(contentType);
+            const StreamProbeResult result = probeStreamUrl(*batch->internet, batch->urls[index], [batch]() {
+                return batch->cancelled.load();
+            });
+
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->results[index] = result;
+                ++batch->completed;
+            }
+            batch->cv.notify_all();
+        });
+        if (!posted) {
+            batch->cancelled.store(true);
+            return candidates;
         }
     }
 
-    DWORD urlSize = 0;
-    (void)InternetQueryOptionA(request, INTERNET_OPTION_URL, nullptr, &urlSize);
-    if (urlSize > 0 && GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
-        std::string finalUrl(static_cast<std::size_t>(urlSize), '\0');
-        if (InternetQueryOptionA(request, INTERNET_OPTION_URL, finalUrl.data(), &urlSize)) {
-            if (urlSize > 0 && finalUrl[urlSize - 1] == '\0') {
-                --urlSize;
+    const auto started = std::chrono::steady_clock::now();
+    const auto deadline = started + kStreamProbeBudget;
+    std::optional<std::chrono::steady_clock::time_point> firstLiveAt;
+    std::vector<std::optional<StreamProbeResult>> results;
+    {
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        while (batch->completed < batch->urls.size()) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline || (shouldAbort && shouldAbort())) {
+                break;
+            }
+            if (!firstLiveAt.has_value()) {
+                for (const auto& result : batch->results) {
+                    if (result.has_value() && result->verdict == StreamProbeVerdict::Live) {
+                        firstLiveAt = now;
+                        break;
+                    }
+                }
+            }
+            if (firstLiveAt.has_value() && now - *firstLiveAt >= kStreamProbeGraceAfterLive) {
+                break;
             }
-            finalUrl.resize(static_cast<std::size_t>(urlSize));
-            response.finalUrl = trimAsciiCopy(finalUrl);
+            batch->cv.wait_for(lock, kStreamStartPoll);
         }
+        batch->cancelled.store(true);
+        results = batch->results;
     }
 
-    std::array<char, 4096> buffer{};
-    DWORD read = 0;
-    while (InternetReadFile(request, buffer.data(), static_cast<DWORD>(buffer.size()), &read) && read > 0) {
-        if (shouldAbort && shouldAbort()) {
-            break;
+    std::vector<std::size_t> order;
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        if (!results[i].has_value() || results[i]->verdict != StreamProbeVerdict::Dead) {
+            order.push_back(i);
         }
+    }
+    if (order.empty()) {
+        logger.warn("Stream probe found no reachable candidate; trying all " + std::to_string(candidates.size()) + " anyway.");
+        return candidates;
+    }
 
-        const std::size_t remaining =
-            response.body.size() < kMaxResolverBytes ? (kMaxResolverBytes - response.body.size()) : 0;
-        if (remaining == 0) {
-            break;
+    std::stable_sort(order.begin(), order.end(), [&results](std::size_t a, std::size_t b) {
+        const bool liveA = results[a].has_value() && results[a]->verdict == StreamProbeVerdict::Live;
+        const bool liveB = results[b].has_value() && results[b]->verdict == StreamProbeVerdict::Live;
+        if (liveA != liveB) {
+            return liveA;
         }
-
-        const std::size_t appendSize = std::min<std::size_t>(remaining, static_cast<std::size_t>(read));
-        response.body.append(buffer.data(), appendSize);
-        if (appendSize < static_cast<std::size_t>(read)) {
-            break;
+        if (liveA) {
+            return results[a]->latency < results[b]->latency;
         }
-    }
+        return false;
+    });
 
-    InternetCloseHandle(request);
-    InternetCloseHandle(internet);
+    std::vector<std::string> ranked;
+    ranked.reserve(order.size());
+    for (const auto index : order) {
+        ranked.push_back(candidates[index]);
+    }
 
-    response.ok = !response.body.empty();
-    return response;
+    if (detailedLogs) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        logger.info("Stream probe: " + std::to_string(candidates.size()) + " candidate(s), " +
+                    std::to_string(candidates.size() - ranked.size()) + " dropped, first=" + ranked.front() +
+                    " (" + std::to_string(elapsed.count()) + " ms)");
+    }
+    return ranked;
 }
 
 std::string parseM3UFirstUrl(const std::string& body, const std::string& baseUrl)
@@ -674,6 +963,7 @@ std::string parseXSPFFirstUrl(const std::string& body, const std::string& baseUr
 }
 
 std::string resolvePlayableStreamUrl(
+    const std::shared_ptr<InternetSession>& internet,
     const std::string& inputUrl,
     Logger& logger,
     int depth = 0,
@@ -698,7 +988,7 @@ std::string resolvePlayableStreamUrl(
         return trimmed;
     }
 
-    const TextUrlResponse fetched = fetchUrlText(trimmed, shouldAbort);
+    const TextUrlResponse fetched = fetchUrlText(internet.get(), trimmed, shouldAbort);
     if (!fetched.ok) {
         return trimmed;
     }
@@ -749,7 +1039,7 @@ std::string resolvePlayableStreamUrl(
     logger.info("Resolved stream URL: " + trimmed + " -> " + resolved);
     const std::string resolvedExt = urlExtensionLower(resolved);
     if (isLikelyWrapperExtension(resolvedExt)) {
-        return resolvePlayableStreamUrl(resolved, logger, depth + 1, shouldAbort);
+        return resolvePlayableStreamUrl(internet, resolved, logger, depth + 1, shouldAbort);
     }
 
     return resolved;
@@ -890,6 +1180,16 @@ std::string pathToUtf8(const std::filesystem::path& path)
 #endif
 }
 
+std::uint32_t sendMciString(const wchar_t* command, wchar_t* output, std::uint32_t outputSize, void* callbackWindow)
+{
+    return mciSendStringW(command, output, outputSize, static_cast<HWND>(callbackWindow));
+}
+
+std::uint32_t mciDeviceIdForAlias(const wchar_t* alias)
+{
+    return mciGetDeviceIDW(alias);
+}
+
 std::filesystem::path defaultRadioRoot()
 {
     std::array<wchar_t, 4096> expanded{};
@@ -1103,9 +1403,9 @@ std::optional<bool> jsonFieldBool(const std::string& object, const char* fieldNa
     return std::nullopt;
 }
 
-std::vector<std::size_t> jsonFieldIndexArray(const std::string& object, const char* fieldName)
+std::vector<std::string> jsonFieldStringArray(const std::string& object, const char* fieldName)
 {
-    std::vector<std::size_t> out;
+    std::vector<std::string> out;
     if (fieldName == nullptr || *fieldName == '\0') {
         return out;
     }
@@ -1122,31 +1422,94 @@ std::vector<std::size_t> jsonFieldIndexArray(const std::string& object, const ch
     }
 
     const std::size_t openPos = object.find('[', colonPos + 1);
-    const std::size_t closePos = object.find(']', openPos == std::string::npos ? colonPos + 1 : openPos + 1);
-    if (openPos == std::string::npos || closePos == std::string::npos || closePos <= openPos) {
+    if (openPos == std::string::npos) {
         return out;
     }
 
-    std::stringstream stream(object.substr(openPos + 1, closePos - openPos - 1));
-    std::string token;
-    while (std::getline(stream, token, ',')) {
-        token = trimAsciiCopy(token);
-        if (token.empty()) {
+    std::string value;
+    bool inString = false;
+    bool escaping = false;
+    for (std::size_t i = openPos + 1; i < object.size(); ++i) {
+        const char c = object[i];
+        if (!inString) {
+            if (c == ']') {
+                break;
+            }
+            if (c == '"') {
+                inString = true;
+                value.clear();
+            }
             continue;
         }
 
-        try {
-            const long long value = std::stoll(token);
-            if (value >= 0) {
-                out.push_back(static_cast<std::size_t>(value));
-            }
-        } catch (...) {
+        if (escaping) {
+            value.push_back(c);
+            escaping = false;
+            continue;
+        }
+        if (c == '\\') {
+            value.push_back(c);
+            escaping = true;
+            continue;
+        }
+        if (c == '"') {
+            out.push_back(jsonUnescape(value));
+            inString = false;
+            continue;
         }
+        value.push_back(c);
     }
 
     return out;
 }
 
+long long directoryWriteTimeValue(const std::filesystem::path& path, std::error_code& ec)
+{
+    const auto writeTime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return 0;
+    }
+    return static_cast<long long>(writeTime.time_since_epoch().count());
+}
+
+long long unixTimeSecondsNow()
+{
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// Writes through a sibling .tmp file and renames it over the target so readers never see a partial file.
+bool writeTextFileAtomically(const std::filesystem::path& path, const std::string& payload, Logger& logger)
+{
+    const auto tempPath = path.parent_path() / (path.filename().string() + ".tmp");
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        logger.warn("Could not open temp file for writing: " + pathToUtf8(tempPath));
+        return false;
+    }
+
+    file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    file.flush();
+    if (!file.good()) {
+        logger.warn("Could not write temp file: " + pathToUtf8(tempPath));
+        return false;
+    }
+    file.close();
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(path, ec);
+        ec.clear();
+        std::filesystem::rename(tempPath, path, ec);
+    }
+    if (ec) {
+        logger.warn("Could not finalize file: " + pathToUtf8(path));
+        return false;
+    }
+    return true;
+}
+
 std::vector<std::string> jsonObjectArrayEntries(const std::string& text, const char* arrayFieldName)
 {
     std::vector<std::string> out;
@@ -1221,6 +1584,41 @@ struct RadioEngine::MfState
     std::shared_ptr<MfEventState> events{};
     Microsoft::WRL::ComPtr<IMFPMediaPlayerCallback> callback{};
     Microsoft::WRL::ComPtr<IMFPMediaPlayer> player{};
+    StreamStallWatch stall{};
+};
+
+// A Media Foundation player buffering muted beside the live one, until it is adopted as the
+// device's player or shut down.
+struct RadioEngine::MutedStreamPlayer
+{
+    std::shared_ptr<MfEventState> events{};
+    Microsoft::WRL::ComPtr<IMFPMediaPlayerCallback> callback{};
+    Microsoft::WRL::ComPtr<IMFPMediaPlayer> player{};
+    bool started{ false };
+};
+
+struct RadioEngine::StreamStandby : MutedStreamPlayer
+{
+    std::string directUrl;
+    std::string resolvedUrl;
+    std::string candidate;
+    std::shared_ptr<std::atomic<bool>> cancel{ std::make_shared<std::atomic<bool>>(false) };
+    std::future<std::string> resolving{};
+    bool failed{ false };
+};
+
+// One device's stream being reopened off the worker's critical path: a muted Media Foundation
+// player (created asynchronously, like a standby) that replaces the dropped one once it plays.
+struct RadioEngine::StreamReconnect : MutedStreamPlayer
+{
+    std::string directUrl;
+    std::string resolvedUrl;
+    std::string candidate;
+    std::uint32_t attempt{ 0 };
+    std::chrono::steady_clock::time_point nextAttemptAt{};
+    std::chrono::steady_clock::time_point attemptDeadline{};
+    std::shared_ptr<std::atomic<bool>> cancel{ std::make_shared<std::atomic<bool>>(false) };
+    std::future<std::string> resolving{};
 };
 
 struct RadioEngine::DsState
@@ -1231,12 +1629,64 @@ struct RadioEngine::DsState
     Microsoft::WRL::ComPtr<IBasicAudio> audio{};
 };
 
+// Hidden message-only window plus wait thread that turns backend completion signals into worker wakeups:
+// MM_MCINOTIFY from "play ... notify", posted Media Foundation events, and the DirectShow event handle.
+// Fields other than thread/window/wakeEvent are guarded by the engine mutex.
+struct RadioEngine::NotifyState
+{
+    struct DirectShowWatch
+    {
+        HANDLE event{ nullptr };
+        OAEVENT source{ 0 };
+        bool armed{ false };
+    };
+
+    std::thread thread{};
+    HWND window{ nullptr };
+    HANDLE wakeEvent{ nullptr };
+    bool stop{ false };
+    std::unordered_map<std::uint64_t, DirectShowWatch> directShowWatches{};
+    std::vector<HANDLE> retiredHandles{};
+
+    static LRESULT CALLBACK windowProc(HWND window, UINT message, WPARAM wParam, LPARAM lParam)
+    {
+        auto* engine = reinterpret_cast<RadioEngine*>(GetWindowLongPtrW(window, GWLP_USERDATA));
+        if (engine != nullptr && (message == MM_MCINOTIFY || message == kPlaybackEventMessage)) {
+            {
+                std::lock_guard<std::mutex> lock(engine->mutex_);
+                if (message == MM_MCINOTIFY) {
+                    // Only natural completion matters; stop/close/replay report aborted or superseded.
+                    if (wParam != MCI_NOTIFY_SUCCESSFUL) {
+                        return 0;
+                    }
+                    engine->mciNotifiedDeviceIds_.push_back(static_cast<unsigned int>(lParam));
+                }
+                engine->playbackEventPending_ = true;
+            }
+            engine->cv_.notify_all();
+            return 0;
+        }
+        return DefWindowProcW(window, message, wParam, lParam);
+    }
+};
+
 RadioEngine::RadioEngine(Logger& logger) :
-    logger_(logger)
+    logger_(logger),
+    primaryAlias_(deviceAliasName(kAlias, 0)),
+    secondaryAlias_(deviceAliasName(kStandbyAlias, 0)),
+    activeAlias_(primaryAlias_),
+    playbackHooks_{ &sendMciString, &mciDeviceIdForAlias }
 {
     config_.radioRootPath = defaultRadioRoot();
 }
 
+void RadioEngine::setPlaybackHooks(const PlaybackHooks& hooks)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    playbackHooks_.mciSendString = hooks.mciSendString != nullptr ? hooks.mciSendString : &sendMciString;
+    playbackHooks_.mciDeviceId = hooks.mciDeviceId != nullptr ? hooks.mciDeviceId : &mciDeviceIdForAlias;
+}
+
 RadioEngine::~RadioEngine()
 {
     shutdown();
@@ -1247,44 +1697,101 @@ bool RadioEngine::initialize()
     std::lock_guard<std::mutex> lock(mutex_);
 
     logger_.info("[M1] Radio engine initialize start.");
-    (void)loadConfig();
-    if (!scanLibraryLocked()) {
+    (void)loadConfig(config_);
+    std::error_code configTimeEc;
+    configWriteTime_ = directoryWriteTimeValue(configPath(), configTimeEc);
+    (void)loadStreamCacheLocked();
+    bool loadedFromIndex = false;
+    if (loadLibraryIndexLocked() && loadLibraryFromIndexLocked()) {
+        loadedFromIndex = true;
+        logger_.info([&]() {
+            return "[M2] Radio library loaded from index. Channels: " + std::to_string(channels_.size());
+        });
+    } else if (!scanLibraryLocked()) {
         logger_.warn("[M2] Initial radio scan failed. Engine will continue and retry on demand.");
     } else {
-        logger_.info("[M2] Radio library scan complete. Channels: " + std::to_string(channels_.size()));
+        logger_.info([&]() {
+            return "[M2] Radio library scan complete. Channels: " + std::to_string(channels_.size());
+        });
+    }
+
+    startPlaybackNotifierLocked();
+    startSessionWriterLocked();
+    if (!internet_) {
+        internet_ = InternetSession::open("RadioSFSE/1.0");
+        if (!internet_) {
+            logger_.warn("Could not open the WinINet session; stream playlist resolving is disabled.");
+        }
     }
 
     if (!workerRunning_) {
         stopWorker_ = false;
+        libraryScanStop_ = false;
+        commandQueue_.reserve(kCommandQueueReserve);
+        priorityQueue_.reserve(kCommandQueueReserve);
         worker_ = std::thread(&RadioEngine::workerLoop, this);
         workerRunning_ = true;
+        positionMailboxActive_.store(true, std::memory_order_release);
+        nextStatsLogTime_ = std::chrono::steady_clock::now() + std::chrono::minutes(config_.statsLogMinutes);
         logger_.info("[M3] Background worker started.");
     }
 
+    // A fresh scan has just built the index; an index load is re-verified by the rescan below,
+    // whose install queues the whole library once instead, since files may have been edited in
+    // place while the game was closed.
+    if (!loadedFromIndex) {
+        scheduleLibraryAnalysisLocked(nullptr);
+    }
+    libraryAnalysisFullPassPending_ = loadedFromIndex;
+    refreshFxCacheLocked();
+    startLibraryWatcherLocked();
+
+    // The index may be stale if folders changed while the game was closed; verify it off-thread.
+    if (loadedFromIndex) {
+        (void)requestLibraryRescanLocked();
+    }
+
     loadPersistentSessionLocked();
     syncCurrentDeviceStateLocked();
+    publishStatusSnapshotLocked();
 
     return true;
 }
 
 void RadioEngine::savePersistentSession()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    (void)savePersistentSessionLocked();
+    std::uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        (void)savePersistentSessionLocked(true);
+        if (!sessionWriterRunning_) {
+            return;
+        }
+        std::lock_guard<std::mutex> writerLock(sessionWriterMutex_);
+        generation = sessionWriteGeneration_;
+    }
+
+    // Save-game hooks expect the file on disk when this returns.
+    if (!waitForSessionWrite(generation)) {
+        logger_.warn("Radio session write did not complete before save.");
+    }
 }
 
 void RadioEngine::reloadPersistentSession()
 {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    stopPlaybackDeviceLocked(true);
+    stopAllPlaybackDevicesLocked(true);
     stopFxLocked();
-    shutdownDirectShowLocked();
-    shutdownMediaFoundationLocked();
 
     deviceStates_.clear();
     currentDeviceId_ = 0;
     backend_ = PlaybackBackend::None;
+    primaryAlias_ = deviceAliasName(kAlias, 0);
+    secondaryAlias_ = deviceAliasName(kStandbyAlias, 0);
+    activeAlias_ = primaryAlias_;
+    preload_ = PreloadedTrack{};
+    trackEndValid_ = false;
     mediaType_ = 1;
     selectedKey_.clear();
     mode_ = PlaybackMode::None;
@@ -1297,8 +1804,7 @@ void RadioEngine::reloadPersistentSession()
     adIndex_ = 0;
     songsSinceAd_ = 0;
     previousWasSong_ = false;
-    shuffleHistory_.clear();
-    shuffleCursor_ = 0;
+    shuffle_ = {};
     lastVolume_ = -1;
     lastLeftVolume_ = -1;
     lastRightVolume_ = -1;
@@ -1309,6 +1815,7 @@ void RadioEngine::reloadPersistentSession()
 
     loadPersistentSessionLocked();
     syncCurrentDeviceStateLocked();
+    publishStatusSnapshotLocked();
 }
 
 void RadioEngine::shutdown()
@@ -1320,18 +1827,23 @@ void RadioEngine::shutdown()
     }
 
     if (!shouldJoin) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        shutdownDirectShowLocked();
-        shutdownMediaFoundationLocked();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopAllPlaybackDevicesLocked(true);
+            stopFxLocked();
+            if (mixer_) {
+                mixer_->shutdown();
+                mixer_.reset();
+            }
+        }
+        stopStreamProbes();
         return;
     }
 
     (void)runBoolCommandForDevice(currentDeviceId_, [this]() {
-        stopPlaybackDeviceLocked(true);
+        stopAllPlaybackDevicesLocked(false);
         stopFxLocked();
-        state_ = PlaybackState::Stopped;
         mode_ = PlaybackMode::None;
-        trackStartValid_ = false;
         syncCurrentDeviceStateLocked();
         return true;
     });
@@ -1339,18 +1851,46 @@ void RadioEngine::shutdown()
     {
         std::lock_guard<std::mutex> lock(mutex_);
         stopWorker_ = true;
+        libraryScanStop_ = true;
+        positionMailboxActive_.store(false, std::memory_order_release);
         cv_.notify_all();
     }
 
     if (worker_.joinable()) {
         worker_.join();
     }
+    if (libraryScanThread_.joinable()) {
+        libraryScanThread_.join();
+    }
+    // The watcher and the pool threads take mutex_ to report, so stop them without holding it.
+    if (libraryWatcher_) {
+        libraryWatcher_->shutdown();
+        libraryWatcher_.reset();
+    }
+    if (analyzer_) {
+        analyzer_->shutdown();
+        analyzer_.reset();
+    }
+    if (fxCache_) {
+        fxCache_->shutdown();
+        fxCache_.reset();
+    }
+    stopPlaybackNotifier();
+    stopSessionWriter();
+    stopStreamProbes();
 
     {
         std::lock_guard<std::mutex> lock(mutex_);
         workerRunning_ = false;
         workerThreadId_ = {};
         commandQueue_.clear();
+        priorityQueue_.clear();
+        // Resolves still finishing hold their own reference; the session closes after the last one.
+        internet_.reset();
+        // Sync callers blocked on a dropped command see workerRunning_ == false and return.
+        for (const auto& waiter : commandWaiterStorage_) {
+            waiter->wake.notify_all();
+        }
     }
 
     logger_.info("Radio engine shut down.");
@@ -1360,13 +1900,13 @@ bool RadioEngine::changePlaylist(const std::string& channelName, std::uint64_t d
 {
     requestPlayInterrupt(deviceId);
     return runBoolCommandForDevice(deviceId, [this, channelName]() {
-        if (config_.autoRescanOnChangePlaylist) {
-            scanLibraryLocked();
+        if (rescanOnDemandLocked()) {
+            (void)requestLibraryRescanLocked();
         }
 
-        const auto channel = lookupChannelLocked(channelName);
-        if (!channel.has_value()) {
-            logger_.warn("change_playlist failed. Channel not found: " + channelName);
+        const ChannelEntry* channel = lookupChannelLocked(channelName);
+        if (channel == nullptr) {
+            logger_.warn([&]() { return "change_playlist failed. Channel not found: " + channelName; });
             return false;
         }
 
@@ -1380,7 +1920,7 @@ bool RadioEngine::changePlaylist(const std::string& channelName, std::uint64_t d
         adIndex_ = 0;
         songsSinceAd_ = 0;
         previousWasSong_ = false;
-        resetShuffleHistoryLocked();
+        resetShuffleOrderLocked();
         currentTrackPath_.clear();
         lastVolume_ = -1;
         lastLeftVolume_ = -1;
@@ -1396,9 +1936,9 @@ bool RadioEngine::changePlaylist(const std::string& channelName, std::uint64_t d
         } else if (channel->type == ChannelType::Station) {
             sourceType = "station";
         }
-        logger_.info("change_playlist selected: " + channel->displayName + " (" + sourceType + ")");
+        logger_.info([&]() { return "change_playlist selected: " + channel->displayName + " (" + sourceType + ")"; });
         return true;
-    });
+    }, CommandKind::ChangePlaylist);
 }
 
 bool RadioEngine::changePlaylistAsync(
@@ -1408,13 +1948,13 @@ bool RadioEngine::changePlaylistAsync(
 {
     requestPlayInterrupt(deviceId);
     return runAsyncCommandForDevice(deviceId, [this, channelName]() {
-        if (config_.autoRescanOnChangePlaylist) {
-            scanLibraryLocked();
+        if (rescanOnDemandLocked()) {
+            (void)requestLibraryRescanLocked();
         }
 
-        const auto channel = lookupChannelLocked(channelName);
-        if (!channel.has_value()) {
-            logger_.warn("change_playlist failed. Channel not found: " + channelName);
+        const ChannelEntry* channel = lookupChannelLocked(channelName);
+        if (channel == nullptr) {
+            logger_.warn([&]() { return "change_playlist failed. Channel not found: " + channelName; });
             return false;
         }
 
@@ -1428,7 +1968,7 @@ bool RadioEngine::changePlaylistAsync(
         adIndex_ = 0;
         songsSinceAd_ = 0;
         previousWasSong_ = false;
-        resetShuffleHistoryLocked();
+        resetShuffleOrderLocked();
         currentTrackPath_.clear();
         lastVolume_ = -1;
         lastLeftVolume_ = -1;
@@ -1444,9 +1984,9 @@ bool RadioEngine::changePlaylistAsync(
         } else if (channel->type == ChannelType::Station) {
             sourceType = "station";
         }
-        logger_.info("change_playlist selected: " + channel->displayName + " (" + sourceType + ")");
+        logger_.info([&]() { return "change_playlist selected: " + channel->displayName + " (" + sourceType + ")"; });
         return true;
-    }, completion);
+    }, completion, CommandKind::ChangePlaylist);
 }
 
 bool RadioEngine::play(std::uint64_t deviceId)
@@ -1471,7 +2011,7 @@ bool RadioEngine::play(std::uint64_t deviceId)
             channelIt->second.type == ChannelType::Station ? PlaybackMode::Station : PlaybackMode::Playlist;
 
         return startCurrentLocked(desiredMode, false);
-    });
+    }, CommandKind::Transport);
 }
 
 bool RadioEngine::start(std::uint64_t deviceId)
@@ -1494,7 +2034,7 @@ bool RadioEngine::start(std::uint64_t deviceId)
         }
 
         return startCurrentLocked(PlaybackMode::Station, true);
-    });
+    }, CommandKind::Transport);
 }
 
 bool RadioEngine::startAsync(
@@ -1519,14 +2059,15 @@ bool RadioEngine::startAsync(
         }
 
         return startCurrentLocked(PlaybackMode::Station, true);
-    }, completion);
+    }, completion, CommandKind::Transport);
 }
 
 bool RadioEngine::pause(std::uint64_t deviceId)
 {
+    requestPlayInterrupt(deviceId);
     return runBoolCommandForDevice(deviceId, [this]() {
         return pauseLocked();
-    });
+    }, CommandKind::Pause);
 }
 
 bool RadioEngine::stop(std::uint64_t deviceId)
@@ -1542,7 +2083,7 @@ bool RadioEngine::stop(std::uint64_t deviceId)
         adIndex_ = 0;
         songsSinceAd_ = 0;
         previousWasSong_ = false;
-        resetShuffleHistoryLocked();
+        resetShuffleOrderLocked();
         currentTrackPath_.clear();
         lastVolume_ = -1;
         lastLeftVolume_ = -1;
@@ -1553,7 +2094,7 @@ bool RadioEngine::stop(std::uint64_t deviceId)
 
         logger_.info("stop executed. Playback reset to beginning.");
         return true;
-    });
+    }, CommandKind::Stop);
 }
 
 bool RadioEngine::stopAsync(
@@ -1571,7 +2112,7 @@ bool RadioEngine::stopAsync(
         adIndex_ = 0;
         songsSinceAd_ = 0;
         previousWasSong_ = false;
-        resetShuffleHistoryLocked();
+        resetShuffleOrderLocked();
         currentTrackPath_.clear();
         lastVolume_ = -1;
         lastLeftVolume_ = -1;
@@ -1582,15 +2123,16 @@ bool RadioEngine::stopAsync(
 
         logger_.info("stop executed. Playback reset to beginning.");
         return true;
-    }, completion);
+    }, completion, CommandKind::Stop);
 }
 
 bool RadioEngine::forward(std::uint64_t deviceId)
 {
     requestPlayInterrupt(deviceId);
-    return runBoolCommandForDevice(deviceId, [this]() {
-        return forwardLocked();
-    });
+    QueuedCommand command;
+    command.kind = CommandKind::Forward;
+    command.deviceId = deviceId;
+    return dispatchCommand(std::move(command), {}, true);
 }
 
 bool RadioEngine::forwardAsync(
@@ -1598,17 +2140,19 @@ bool RadioEngine::forwardAsync(
     const std::function<void(bool result)>& completion)
 {
     requestPlayInterrupt(deviceId);
-    return runAsyncCommandForDevice(deviceId, [this]() {
-        return forwardLocked();
-    }, completion);
+    QueuedCommand command;
+    command.kind = CommandKind::Forward;
+    command.deviceId = deviceId;
+    return dispatchCommand(std::move(command), completion, false);
 }
 
 bool RadioEngine::rewind(std::uint64_t deviceId)
 {
     requestPlayInterrupt(deviceId);
-    return runBoolCommandForDevice(deviceId, [this]() {
-        return rewindLocked();
-    });
+    QueuedCommand command;
+    command.kind = CommandKind::Rewind;
+    command.deviceId = deviceId;
+    return dispatchCommand(std::move(command), {}, true);
 }
 
 bool RadioEngine::rewindAsync(
@@ -1616,17 +2160,19 @@ bool RadioEngine::rewindAsync(
     const std::function<void(bool result)>& completion)
 {
     requestPlayInterrupt(deviceId);
-    return runAsyncCommandForDevice(deviceId, [this]() {
-        return rewindLocked();
-    }, completion);
+    QueuedCommand command;
+    command.kind = CommandKind::Rewind;
+    command.deviceId = deviceId;
+    return dispatchCommand(std::move(command), completion, false);
 }
 
 bool RadioEngine::previous(std::uint64_t deviceId)
 {
     requestPlayInterrupt(deviceId);
-    return runBoolCommandForDevice(deviceId, [this]() {
-        return previousLocked();
-    });
+    QueuedCommand command;
+    command.kind = CommandKind::Previous;
+    command.deviceId = deviceId;
+    return dispatchCommand(std::move(command), {}, true);
 }
 
 bool RadioEngine::previousAsync(
@@ -1634,78 +2180,86 @@ bool RadioEngine::previousAsync(
     const std::function<void(bool result)>& completion)
 {
     requestPlayInterrupt(deviceId);
-    return runAsyncCommandForDevice(deviceId, [this]() {
-        return previousLocked();
-    }, completion);
+    QueuedCommand command;
+    command.kind = CommandKind::Previous;
+    command.deviceId = deviceId;
+    return dispatchCommand(std::move(command), completion, false);
 }
 
 bool RadioEngine::rescanLibrary(std::uint64_t deviceId)
 {
-    return runBoolCommandForDevice(deviceId, [this]() {
-        const bool ok = scanLibraryLocked();
-        if (ok) {
-            logger_.info("Library rescan complete. Channels: " + std::to_string(channels_.size()));
-        } else {
-            logger_.warn("Library rescan failed.");
-        }
-        return ok;
-    });
+    (void)deviceId;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool ok = requestLibraryRescanLocked();
+    if (ok) {
+        logger_.info("Library rescan requested. Current channels stay active until it completes.");
+    } else {
+        logger_.warn("Library rescan failed.");
+    }
+    return ok;
 }
 
-bool RadioEngine::isPlaying(std::uint64_t deviceId) const
+bool RadioEngine::reloadConfig()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (deviceId == currentDeviceId_) {
-        return state_ == PlaybackState::Playing;
+    // Parsed on the caller's thread; the worker applies it between commands, so the next tick
+    // already evaluates every fade with the new settings.
+    auto next = std::make_shared<Config>();
+    std::error_code timeEc;
+    const long long writeTime = directoryWriteTimeValue(configPath(), timeEc);
+    if (!loadConfig(*next)) {
+        logger_.warn("Config reload failed; keeping the current settings.");
+        return false;
     }
 
-    const auto it = deviceStates_.find(deviceId);
-    if (it == deviceStates_.end()) {
-        return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    configWriteTime_ = writeTime;
+    if (!workerRunning_) {
+        // No watcher runs without the worker, so there is nothing to restart outside the lock.
+        (void)applyConfigLocked(std::move(*next));
+        return true;
     }
-    return it->second.state == PlaybackState::Playing;
+
+    QueuedCommand task;
+    task.kind = CommandKind::Task;
+    task.enqueuedAt = std::chrono::steady_clock::now();
+    task.command = [this, next]() {
+        std::unique_ptr<LibraryWatcher> retiredWatcher;
+        {
+            std::lock_guard<std::mutex> applyLock(mutex_);
+            retiredWatcher = applyConfigLocked(std::move(*next));
+        }
+        // The watcher's callback takes mutex_, so one on the old settings is stopped outside it.
+        if (retiredWatcher) {
+            retiredWatcher->shutdown();
+            retiredWatcher.reset();
+            std::lock_guard<std::mutex> startLock(mutex_);
+            startLibraryWatcherLocked();
+        }
+        return true;
+    };
+    commandQueue_.push_back(std::move(task));
+    cv_.notify_all();
+    return true;
+}
+
+bool RadioEngine::isPlaying(std::uint64_t deviceId) const
+{
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr && status->playing;
 }
 
 bool RadioEngine::changeToNextSource(int category, std::uint64_t deviceId)
 {
     requestPlayInterrupt(deviceId);
     return runBoolCommandForDevice(deviceId, [this, category]() {
-        if (config_.autoRescanOnChangePlaylist) {
-            scanLibraryLocked();
+        if (rescanOnDemandLocked()) {
+            (void)requestLibraryRescanLocked();
         }
 
-        struct Candidate
-        {
-            std::string key;
-            std::string displayName;
-        };
-
-        std::vector<Candidate> candidates;
-        auto addCandidate = [&candidates](const std::string& key, const std::string& displayName) {
-            candidates.push_back(Candidate{ key, displayName });
-        };
-
-        if (category == 1 || category == 2) {
-            for (const auto& [key, entry] : channels_) {
-                if (entry.isStream) {
-                    continue;
-                }
-                if (category == 1 && entry.type == ChannelType::Playlist) {
-                    addCandidate(key, entry.displayName);
-                } else if (category == 2 && entry.type == ChannelType::Station) {
-                    addCandidate(key, entry.displayName);
-                }
-            }
-        } else if (category == 3) {
-            for (const auto& key : streamOrderKeys_) {
-                const auto it = channels_.find(key);
-                if (it == channels_.end() || !it->second.isStream) {
-                    continue;
-                }
-                addCandidate(it->first, it->second.displayName);
-            }
-        } else {
-            logger_.warn("changeToNextSource failed. Invalid category: " + std::to_string(category));
+        const std::vector<ChannelHandle>* candidates = channelsInCategoryLocked(category);
+        if (candidates == nullptr) {
+            logger_.warn([&]() { return "changeToNextSource failed. Invalid category: " + std::to_string(category); });
             return false;
         }
 
@@ -1718,7 +2272,7 @@ bool RadioEngine::changeToNextSource(int category, std::uint64_t deviceId)
         adIndex_ = 0;
         songsSinceAd_ = 0;
         previousWasSong_ = false;
-        resetShuffleHistoryLocked();
+        resetShuffleOrderLocked();
         currentTrackPath_.clear();
         lastVolume_ = -1;
         lastLeftVolume_ = -1;
@@ -1729,105 +2283,67 @@ bool RadioEngine::changeToNextSource(int category, std::uint64_t deviceId)
 
         stopPlaybackDeviceLocked(true);
 
-        if (candidates.empty()) {
+        if (candidates->empty()) {
             selectedKey_.clear();
-            logger_.info("changeToNextSource selected empty category=" + std::to_string(category) +
-                         ". Playback stopped; waiting for a source to be added.");
+            logger_.info([&]() {
+                return "changeToNextSource selected empty category=" + std::to_string(category) +
+                       ". Playback stopped; waiting for a source to be added.";
+            });
             return true;
         }
 
-        std::sort(candidates.begin(), candidates.end(), [this](const Candidate& a, const Candidate& b) {
-            return toLower(a.displayName) < toLower(b.displayName);
-        });
-
-        const auto channelIt = channels_.find(candidates.front().key);
-        if (channelIt == channels_.end()) {
-            return false;
-        }
-
-        selectedKey_ = channelIt->first;
+        const ChannelEntry& channel = *channelTable_[candidates->front()];
+        selectedKey_ = channel.key;
 
         std::string sourceType = "playlist";
-        if (channelIt->second.isStream) {
+        if (channel.isStream) {
             sourceType = "stream";
-        } else if (channelIt->second.type == ChannelType::Station) {
+        } else if (channel.type == ChannelType::Station) {
             sourceType = "station";
         }
 
-        logger_.info("changeToNextSource selected: " + channelIt->second.displayName +
-                     " (" + sourceType + ", category=" + std::to_string(category) +
-                     "). Playback stopped; waiting for explicit play/start.");
+        logger_.info([&]() {
+            return "changeToNextSource selected: " + channel.displayName +
+                   " (" + sourceType + ", category=" + std::to_string(category) +
+                   "). Playback stopped; waiting for explicit play/start.";
+        });
         return true;
-    });
+    }, CommandKind::SelectSource);
 }
 
 bool RadioEngine::selectNextSource(int category, std::uint64_t deviceId)
 {
     requestPlayInterrupt(deviceId);
     return runBoolCommandForDevice(deviceId, [this, category]() {
-        if (config_.autoRescanOnChangePlaylist) {
-            scanLibraryLocked();
+        if (rescanOnDemandLocked()) {
+            (void)requestLibraryRescanLocked();
         }
 
-        struct Candidate
-        {
-            std::string key;
-            std::string displayName;
-        };
-
-        std::vector<Candidate> candidates;
-        auto addCandidate = [&candidates](const std::string& key, const std::string& displayName) {
-            candidates.push_back(Candidate{ key, displayName });
-        };
-
-        if (category == 1 || category == 2) {
-            for (const auto& [key, entry] : channels_) {
-                if (entry.isStream) {
-                    continue;
-                }
-                if (category == 1 && entry.type == ChannelType::Playlist) {
-                    addCandidate(key, entry.displayName);
-                } else if (category == 2 && entry.type == ChannelType::Station) {
-                    addCandidate(key, entry.displayName);
-                }
-            }
-        } else if (category == 3) {
-            for (const auto& key : streamOrderKeys_) {
-                const auto it = channels_.find(key);
-                if (it == channels_.end() || !it->second.isStream) {
-                    continue;
-                }
-                addCandidate(it->first, it->second.displayName);
-            }
-        } else {
-            logger_.warn("selectNextSource failed. Invalid category: " + std::to_string(category));
+        const std::vector<ChannelHandle>* candidates = channelsInCategoryLocked(category);
+        if (candidates == nullptr) {
+            logger_.warn([&]() { return "selectNextSource failed. Invalid category: " + std::to_string(category); });
             return false;
         }
 
-        if (candidates.empty()) {
-            logger_.warn("selectNextSource failed. No sources for category: " + std::to_string(category));
+        if (candidates->empty()) {
+            logger_.warn([&]() {
+                return "selectNextSource failed. No sources for category: " + std::to_string(category);
+            });
             return false;
         }
 
-        std::sort(candidates.begin(), candidates.end(), [this](const Candidate& a, const Candidate& b) {
-            return toLower(a.displayName) < toLower(b.displayName);
-        });
-
         std::size_t nextIndex = 0;
-        for (std::size_t i = 0; i < candidates.size(); ++i) {
-            if (candidates[i].key == selectedKey_) {
-                nextIndex = (i + 1) % candidates.size();
-                break;
+        if (const auto selectedIt = channelAliases_.find(selectedKey_);
+            selectedIt != channelAliases_.end() && selectedIt->second != kAmbiguousChannelHandle) {
+            const std::size_t position = channelCategoryPosition_[selectedIt->second];
+            if ((*candidates)[position] == selectedIt->second) {
+                nextIndex = (position + 1) % candidates->size();
             }
         }
 
-        const auto channelIt = channels_.find(candidates[nextIndex].key);
-        if (channelIt == channels_.end()) {
-            return false;
-        }
-
+        const ChannelEntry& channel = *channelTable_[(*candidates)[nextIndex]];
         mediaType_ = std::clamp(category, 1, 3);
-        selectedKey_ = channelIt->first;
+        selectedKey_ = channel.key;
         mode_ = PlaybackMode::None;
         state_ = PlaybackState::Stopped;
         resumePositionMs_ = 0;
@@ -1836,7 +2352,7 @@ bool RadioEngine::selectNextSource(int category, std::uint64_t deviceId)
         adIndex_ = 0;
         songsSinceAd_ = 0;
         previousWasSong_ = false;
-        resetShuffleHistoryLocked();
+        resetShuffleOrderLocked();
         currentTrackPath_.clear();
         lastVolume_ = -1;
         lastLeftVolume_ = -1;
@@ -1848,17 +2364,19 @@ bool RadioEngine::selectNextSource(int category, std::uint64_t deviceId)
         stopPlaybackDeviceLocked(true);
 
         std::string sourceType = "playlist";
-        if (channelIt->second.isStream) {
+        if (channel.isStream) {
             sourceType = "stream";
-        } else if (channelIt->second.type == ChannelType::Station) {
+        } else if (channel.type == ChannelType::Station) {
             sourceType = "station";
         }
 
-        logger_.info("selectNextSource selected: " + channelIt->second.displayName +
-                     " (" + sourceType + ", category=" + std::to_string(category) +
-                     "). Playback stopped; waiting for explicit play/start.");
+        logger_.info([&]() {
+            return "selectNextSource selected: " + channel.displayName +
+                   " (" + sourceType + ", category=" + std::to_string(category) +
+                   "). Playback stopped; waiting for explicit play/start.";
+        });
         return true;
-    });
+    }, CommandKind::SelectSource);
 }
 
 bool RadioEngine::setPositions(
@@ -1871,14 +2389,15 @@ bool RadioEngine::setPositions(
     float playerYawDeg,
     std::uint64_t deviceId)
 {
-    bool workerActive = false;
-    if (mutex_.try_lock()) {
-        workerActive = workerRunning_;
-        mutex_.unlock();
-    }
-
-    if (!workerActive) {
+    if (!positionMailboxActive_.load(std::memory_order_acquire)) {
         if (!mutex_.try_lock()) {
+            stats_.positionSamplesDropped.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (workerRunning_) {
+            // Worker is shutting down; the sample would be discarded anyway.
+            mutex_.unlock();
+            stats_.positionSamplesDropped.fetch_add(1, std::memory_order_relaxed);
             return true;
         }
 
@@ -1893,20 +2412,75 @@ bool RadioEngine::setPositions(
         return true;
     }
 
-    if (!pendingPositionMutex_.try_lock()) {
+    PositionMailboxSlot* slot = claimPositionMailboxSlot(deviceId);
+    if (slot == nullptr) {
+        // More distinct devices than mailbox slots: hand the sample to the worker queue instead.
+        // This must not go through runAsyncCommandForDevice, which would switch (and stop) devices.
+        PendingPositionSample sample;
+        sample.deviceId = deviceId;
+        sample.emitter = Position{ emitterX, emitterY, emitterZ };
+        sample.player = Position{ playerX, playerY, playerZ };
+        sample.playerYawDeg = playerYawDeg;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            QueuedCommand task;
+            task.kind = CommandKind::Task;
+            task.enqueuedAt = std::chrono::steady_clock::now();
+            task.command = [this, sample]() {
+                std::lock_guard<std::mutex> commandLock(mutex_);
+                const std::uint64_t homeDeviceId = currentDeviceId_;
+                (void)applyPositionSampleLocked(sample);
+                switchToDeviceLocked(homeDeviceId);
+                return true;
+            };
+            commandQueue_.push_back(std::move(task));
+        }
+        cv_.notify_all();
         return true;
     }
-    pendingPositionSample_.deviceId = deviceId;
-    pendingPositionSample_.emitter = Position{ emitterX, emitterY, emitterZ };
-    pendingPositionSample_.player = Position{ playerX, playerY, playerZ };
-    pendingPositionSample_.playerYawDeg = playerYawDeg;
-    pendingPositionDirty_.store(true, std::memory_order_release);
-    pendingPositionMutex_.unlock();
 
+    // Seqlock write: an odd sequence marks the slot as being written. If another thread is already
+    // writing this device, its sample is just as fresh, so this one is skipped instead of waiting.
+    std::uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    if ((sequence & 1U) != 0U ||
+        !slot->sequence.compare_exchange_strong(sequence, sequence + 1U, std::memory_order_acquire, std::memory_order_relaxed)) {
+        stats_.positionSamplesDropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->emitterX.store(emitterX, std::memory_order_relaxed);
+    slot->emitterY.store(emitterY, std::memory_order_relaxed);
+    slot->emitterZ.store(emitterZ, std::memory_order_relaxed);
+    slot->playerX.store(playerX, std::memory_order_relaxed);
+    slot->playerY.store(playerY, std::memory_order_relaxed);
+    slot->playerZ.store(playerZ, std::memory_order_relaxed);
+    slot->playerYawDeg.store(playerYawDeg, std::memory_order_relaxed);
+    slot->sequence.store(sequence + 2U, std::memory_order_release);
+
+    pendingPositionDirty_.store(true, std::memory_order_release);
     cv_.notify_all();
     return true;
 }
 
+RadioEngine::PositionMailboxSlot* RadioEngine::claimPositionMailboxSlot(std::uint64_t deviceId)
+{
+    // Slots are claimed once per device id and never released, so a found slot stays valid.
+    for (auto& slot : positionMailbox_) {
+        std::uint64_t owner = slot.deviceId.load(std::memory_order_acquire);
+        if (owner == deviceId) {
+            return &slot;
+        }
+        if (owner == kFreeMailboxSlot) {
+            if (slot.deviceId.compare_exchange_strong(owner, deviceId, std::memory_order_acq_rel, std::memory_order_acquire) ||
+                owner == deviceId) {
+                return &slot;
+            }
+        }
+    }
+    return nullptr;
+}
+
 bool RadioEngine::setFadeParams(float minDistance, float maxDistance, float panDistance, std::uint64_t deviceId)
 {
     return runBoolCommandForDevice(deviceId, [this, minDistance, maxDistance, panDistance]() {
@@ -1914,7 +2488,9 @@ bool RadioEngine::setFadeParams(float minDistance, float maxDistance, float panD
         if (minDistance < 0.0F || maxDistance < 0.0F || panDistance < 0.0F) {
             device.fadeOverride.enabled = false;
             updateFadeVolumeLocked();
-            logger_.info("setFadeParams reset to defaults for deviceId=" + std::to_string(currentDeviceId_));
+            logger_.info([&]() {
+                return "setFadeParams reset to defaults for deviceId=" + std::to_string(currentDeviceId_);
+            });
             return true;
         }
 
@@ -1927,110 +2503,77 @@ bool RadioEngine::setFadeParams(float minDistance, float maxDistance, float panD
         device.fadeOverride.maxDistance = maxDist;
         device.fadeOverride.panDistance = panDist;
         updateFadeVolumeLocked();
-        logger_.info("setFadeParams deviceId=" + std::to_string(currentDeviceId_) +
-                     " min=" + std::to_string(minDist) +
-                     " max=" + std::to_string(maxDist) +
-                     " pan=" + std::to_string(panDist));
+        logger_.info([&]() {
+            return "setFadeParams deviceId=" + std::to_string(currentDeviceId_) +
+                   " min=" + std::to_string(minDist) +
+                   " max=" + std::to_string(maxDist) +
+                   " pan=" + std::to_string(panDist);
+        });
         return true;
     });
 }
 
 bool RadioEngine::volumeUp(float step, std::uint64_t deviceId)
 {
-    return runBoolCommandForDevice(deviceId, [this, step]() {
-        DeviceState& device = ensureDeviceStateLocked(currentDeviceId_);
-        const float deltaPercent = step > 0.0F ? step : kDefaultVolumeStepPercent;
-        const float deltaGain = deltaPercent / kDefaultVolumePercent;
-        device.volumeGain = std::clamp(device.volumeGain + deltaGain, 0.0F, 2.0F);
-        updateFadeVolumeLocked();
-        logger_.info("volumeUp deviceId=" + std::to_string(currentDeviceId_) +
-                     " gain=" + std::to_string(device.volumeGain) +
-                     " volume=" + std::to_string(device.volumeGain * kDefaultVolumePercent));
-        return true;
-    });
+    QueuedCommand command;
+    command.kind = CommandKind::Volume;
+    command.deviceId = deviceId;
+    command.volumeDelta = (step > 0.0F ? step : kDefaultVolumeStepPercent) / kDefaultVolumePercent;
+    return dispatchCommand(std::move(command), {}, true);
 }
 
 bool RadioEngine::volumeDown(float step, std::uint64_t deviceId)
 {
-    return runBoolCommandForDevice(deviceId, [this, step]() {
-        DeviceState& device = ensureDeviceStateLocked(currentDeviceId_);
-        const float deltaPercent = step > 0.0F ? step : kDefaultVolumeStepPercent;
-        const float deltaGain = deltaPercent / kDefaultVolumePercent;
-        device.volumeGain = std::clamp(device.volumeGain - deltaGain, 0.0F, 2.0F);
-        updateFadeVolumeLocked();
-        logger_.info("volumeDown deviceId=" + std::to_string(currentDeviceId_) +
-                     " gain=" + std::to_string(device.volumeGain) +
-                     " volume=" + std::to_string(device.volumeGain * kDefaultVolumePercent));
-        return true;
-    });
+    QueuedCommand command;
+    command.kind = CommandKind::Volume;
+    command.deviceId = deviceId;
+    command.volumeDelta = -(step > 0.0F ? step : kDefaultVolumeStepPercent) / kDefaultVolumePercent;
+    return dispatchCommand(std::move(command), {}, true);
 }
 
 float RadioEngine::getVolume(std::uint64_t deviceId) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    const auto it = deviceStates_.find(deviceId == currentDeviceId_ ? currentDeviceId_ : deviceId);
-    if (it == deviceStates_.end()) {
-        return kDefaultVolumePercent;
-    }
-
-    return std::clamp(it->second.volumeGain * kDefaultVolumePercent, 0.0F, kMaximumVolumePercent);
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr ? status->volumePercent : kDefaultVolumePercent;
 }
 
 std::int32_t RadioEngine::getMediaType(std::uint64_t deviceId) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (deviceId == currentDeviceId_) {
-        return std::clamp(mediaType_, 1, 3);
-    }
-
-    const auto it = deviceStates_.find(deviceId);
-    if (it == deviceStates_.end()) {
-        return 1;
-    }
-
-    return std::clamp(it->second.mediaType, 1, 3);
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr ? status->mediaType : 1;
 }
 
 std::int32_t RadioEngine::getPlayMode(std::uint64_t deviceId) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto modeValue = static_cast<std::int32_t>(TrackOrderMode::Alphabetical);
-    if (deviceId == currentDeviceId_) {
-        modeValue = static_cast<std::int32_t>(trackOrderMode_);
-    } else {
-        const auto it = deviceStates_.find(deviceId);
-        if (it != deviceStates_.end()) {
-            modeValue = static_cast<std::int32_t>(it->second.trackOrderMode);
-        }
-    }
-
-    return (modeValue == static_cast<std::int32_t>(TrackOrderMode::Shuffle))
-        ? static_cast<std::int32_t>(TrackOrderMode::Shuffle)
-        : static_cast<std::int32_t>(TrackOrderMode::Alphabetical);
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr ? status->playMode : static_cast<std::int32_t>(TrackOrderMode::Alphabetical);
 }
 
 float RadioEngine::configuredVolumeStepPercent() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::clamp(config_.volumeStepPercent, 0.1F, kMaximumVolumePercent);
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    return snapshot ? snapshot->volumeStepPercent : 20.0F;
 }
 
 std::int32_t RadioEngine::configuredDebugVerbosity() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::clamp<std::int32_t>(config_.debugVerbosity, 0, 2);
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    return snapshot ? snapshot->debugVerbosity : 0;
 }
 
 bool RadioEngine::configuredDialogDuckEnabled() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return config_.dialogDuckEnabled;
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    return snapshot && snapshot->dialogDuckEnabled;
 }
 
 float RadioEngine::configuredDialogDuckVolume() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::clamp(config_.dialogDuckVolume, 0.0F, 200.0F);
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    return snapshot ? snapshot->dialogDuckVolume : 0.0F;
 }
 
 bool RadioEngine::setVolume(float volume, std::uint64_t deviceId)
@@ -2040,8 +2583,10 @@ bool RadioEngine::setVolume(float volume, std::uint64_t deviceId)
         const float clamped = std::clamp(volume, 0.0F, kMaximumVolumePercent);
         device.volumeGain = clamped / kDefaultVolumePercent;
         updateFadeVolumeLocked();
-        logger_.info("setVolume deviceId=" + std::to_string(currentDeviceId_) +
-                     " volume=" + std::to_string(clamped));
+        logger_.info([&]() {
+            return "setVolume deviceId=" + std::to_string(currentDeviceId_) +
+                   " volume=" + std::to_string(clamped);
+        });
         return true;
     });
 }
@@ -2059,71 +2604,30 @@ bool RadioEngine::setPlayMode(std::int32_t playMode, std::uint64_t deviceId)
         }
 
         trackOrderMode_ = resolvedMode;
-        resetShuffleHistoryLocked();
+        resetShuffleOrderLocked();
 
         const auto channelIt = channels_.find(selectedKey_);
         if (channelIt != channels_.end() && !channelIt->second.isStream && !currentTrackPath_.empty()) {
             const auto currentName = toLower(pathToUtf8(currentTrackPath_.filename()));
-            for (std::size_t i = 0; i < channelIt->second.songs.size(); ++i) {
-                if (toLower(pathToUtf8(channelIt->second.songs[i].filename())) == currentName) {
-                    songIndex_ = i;
-                    shuffleHistory_.push_back(i);
-                    shuffleCursor_ = 0;
-                    break;
-                }
+            if (const auto found = channelIt->second.songs.findByFileName(currentName); found.has_value()) {
+                songIndex_ = *found;
+                anchorShuffleOrderLocked(*found, channelIt->second.songs.size());
             }
         }
 
-        logger_.info("setPlayMode deviceId=" + std::to_string(currentDeviceId_) +
-                     " mode=" + std::to_string(static_cast<std::int32_t>(trackOrderMode_)));
+        logger_.info([&]() {
+            return "setPlayMode deviceId=" + std::to_string(currentDeviceId_) +
+                   " mode=" + std::to_string(static_cast<std::int32_t>(trackOrderMode_));
+        });
         return true;
     });
 }
 
 std::string RadioEngine::getTrack(std::uint64_t deviceId) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    std::string key;
-    std::size_t songIndex = 0;
-    std::filesystem::path trackPath;
-    if (deviceId == currentDeviceId_) {
-        key = selectedKey_;
-        songIndex = songIndex_;
-        trackPath = currentTrackPath_;
-    } else {
-        const auto stateIt = deviceStates_.find(deviceId);
-        if (stateIt == deviceStates_.end()) {
-            return {};
-        }
-
-        key = stateIt->second.selectedKey;
-        songIndex = stateIt->second.songIndex;
-        trackPath = stateIt->second.currentTrackPath;
-    }
-
-    if (key.empty()) {
-        return {};
-    }
-
-    const auto channelIt = channels_.find(key);
-    if (channelIt == channels_.end()) {
-        return {};
-    }
-
-    if (channelIt->second.isStream) {
-        return "na";
-    }
-
-    if (!trackPath.empty()) {
-        return pathToUtf8(trackPath.filename());
-    }
-
-    if (songIndex < channelIt->second.songs.size()) {
-        return pathToUtf8(channelIt->second.songs[songIndex].filename());
-    }
-
-    return {};
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr ? status->track : std::string{};
 }
 
 bool RadioEngine::setTrack(const std::string& trackBasename, std::uint64_t deviceId)
@@ -2153,18 +2657,10 @@ bool RadioEngine::setTrack(const std::string& trackBasename, std::uint64_t devic
             return false;
         }
 
-        std::size_t foundIndex = channel.songs.size();
-        for (std::size_t i = 0; i < channel.songs.size(); ++i) {
-            const std::string fileNameLower = toLower(pathToUtf8(channel.songs[i].filename()));
-            const std::string stemLower = toLower(pathToUtf8(channel.songs[i].stem()));
-            if (needle == fileNameLower || needle == stemLower) {
-                foundIndex = i;
-                break;
-            }
-        }
+        const std::size_t foundIndex = channel.songs.findByFileNameOrStem(needle).value_or(channel.songs.size());
 
         if (foundIndex >= channel.songs.size()) {
-            logger_.warn("setTrack failed. Track not found in selected source: " + trackBasename);
+            logger_.warn([&]() { return "setTrack failed. Track not found in selected source: " + trackBasename; });
             return false;
         }
 
@@ -2183,19 +2679,19 @@ bool RadioEngine::setTrack(const std::string& trackBasename, std::uint64_t devic
         resumePositionMs_ = 0;
         mode_ = channel.type == ChannelType::Station ? PlaybackMode::Station : PlaybackMode::Playlist;
         previousWasSong_ = true;
-        resetShuffleHistoryLocked();
-        shuffleHistory_.push_back(foundIndex);
-        shuffleCursor_ = 0;
+        anchorShuffleOrderLocked(foundIndex, channel.songs.size());
 
-        logger_.info("setTrack selected: " + pathToUtf8(currentTrackPath_.filename()) +
-                     " (index=" + std::to_string(foundIndex) + ")");
+        logger_.info([&]() {
+            return "setTrack selected: " + pathToUtf8(currentTrackPath_.filename()) +
+                   " (index=" + std::to_string(foundIndex) + ")";
+        });
 
         if (!wasPlaying) {
             return true;
         }
 
         return playPathLocked(currentTrackPath_);
-    });
+    }, CommandKind::Transport);
 }
 
 bool RadioEngine::setTrackAsync(
@@ -2228,18 +2724,10 @@ bool RadioEngine::setTrackAsync(
             return false;
         }
 
-        std::size_t foundIndex = channel.songs.size();
-        for (std::size_t i = 0; i < channel.songs.size(); ++i) {
-            const std::string fileNameLower = toLower(pathToUtf8(channel.songs[i].filename()));
-            const std::string stemLower = toLower(pathToUtf8(channel.songs[i].stem()));
-            if (needle == fileNameLower || needle == stemLower) {
-                foundIndex = i;
-                break;
-            }
-        }
+        const std::size_t foundIndex = channel.songs.findByFileNameOrStem(needle).value_or(channel.songs.size());
 
         if (foundIndex >= channel.songs.size()) {
-            logger_.warn("setTrack failed. Track not found in selected source: " + trackBasename);
+            logger_.warn([&]() { return "setTrack failed. Track not found in selected source: " + trackBasename; });
             return false;
         }
 
@@ -2258,19 +2746,19 @@ bool RadioEngine::setTrackAsync(
         resumePositionMs_ = 0;
         mode_ = channel.type == ChannelType::Station ? PlaybackMode::Station : PlaybackMode::Playlist;
         previousWasSong_ = true;
-        resetShuffleHistoryLocked();
-        shuffleHistory_.push_back(foundIndex);
-        shuffleCursor_ = 0;
+        anchorShuffleOrderLocked(foundIndex, channel.songs.size());
 
-        logger_.info("setTrack selected: " + pathToUtf8(currentTrackPath_.filename()) +
-                     " (index=" + std::to_string(foundIndex) + ")");
+        logger_.info([&]() {
+            return "setTrack selected: " + pathToUtf8(currentTrackPath_.filename()) +
+                   " (index=" + std::to_string(foundIndex) + ")";
+        });
 
         if (!wasPlaying) {
             return true;
         }
 
         return playPathLocked(currentTrackPath_);
-    }, completion);
+    }, completion, CommandKind::Transport);
 }
 
 bool RadioEngine::playFx(const std::string& fxBasename, std::uint64_t deviceId)
@@ -2278,7 +2766,7 @@ bool RadioEngine::playFx(const std::string& fxBasename, std::uint64_t deviceId)
     return runBoolCommandForDevice(deviceId, [this, fxBasename]() {
         const auto fxPath = findFxPathLocked(fxBasename);
         if (!fxPath.has_value()) {
-            logger_.warn("playFx failed. FX file not found: " + fxBasename);
+            logger_.warn([&]() { return "playFx failed. FX file not found: " + fxBasename; });
             return false;
         }
         return playFxLocked(*fxPath);
@@ -2293,7 +2781,7 @@ bool RadioEngine::playFxAsync(
     return runAsyncCommandForDevice(deviceId, [this, fxBasename]() {
         const auto fxPath = findFxPathLocked(fxBasename);
         if (!fxPath.has_value()) {
-            logger_.warn("playFx failed. FX file not found: " + fxBasename);
+            logger_.warn([&]() { return "playFx failed. FX file not found: " + fxBasename; });
             return false;
         }
         return playFxLocked(*fxPath);
@@ -2349,7 +2837,7 @@ bool RadioEngine::playAsync(
             channelIt->second.type == ChannelType::Station ? PlaybackMode::Station : PlaybackMode::Playlist;
 
         return startCurrentLocked(desiredMode, false);
-    }, completion);
+    }, completion, CommandKind::Transport);
 }
 
 bool RadioEngine::isPlayInterruptRequested() const
@@ -2364,91 +2852,142 @@ void RadioEngine::clearPlayInterruptRequest()
 
 std::string RadioEngine::currentChannel(std::uint64_t deviceId) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (deviceId == currentDeviceId_) {
-        return selectedKey_;
-    }
-
-    const auto it = deviceStates_.find(deviceId);
-    if (it == deviceStates_.end()) {
-        return {};
-    }
-    return it->second.selectedKey;
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr ? status->selectedKey : std::string{};
 }
 
 std::string RadioEngine::currentSourceName(std::uint64_t deviceId) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    const std::string key = (deviceId == currentDeviceId_)
-        ? selectedKey_
-        : [this, deviceId]() -> std::string {
-              const auto stateIt = deviceStates_.find(deviceId);
-              return stateIt != deviceStates_.end() ? stateIt->second.selectedKey : std::string{};
-          }();
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr ? status->sourceName : std::string{};
+}
 
-    if (key.empty()) {
-        return {};
-    }
+std::string RadioEngine::currentTrackBasename(std::uint64_t deviceId) const
+{
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr ? status->trackBasename : std::string{};
+}
 
-    const auto it = channels_.find(key);
-    if (it == channels_.end()) {
-        return {};
-    }
+std::size_t RadioEngine::channelCount() const
+{
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    return snapshot ? snapshot->channelCount : 0;
+}
 
-    return it->second.displayName;
+RadioEngine::DeviceStatus RadioEngine::deviceStatus(std::uint64_t deviceId) const
+{
+    const auto snapshot = statusSnapshot_.load(std::memory_order_acquire);
+    const DeviceStatus* status = findDeviceStatus(snapshot.get(), deviceId);
+    return status != nullptr ? *status : DeviceStatus{};
 }
 
-std::string RadioEngine::currentTrackBasename(std::uint64_t deviceId) const
+std::vector<std::string> RadioEngine::statsLines() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (deviceId == currentDeviceId_) {
-        if (state_ != PlaybackState::Playing && state_ != PlaybackState::Paused) {
-            return {};
-        }
-        if (currentTrackPath_.empty()) {
-            return {};
-        }
-        return pathToUtf8(currentTrackPath_.filename());
-    }
+    std::vector<std::string> lines;
+    const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - stats_.startedAt);
+    lines.push_back("uptime_s=" + std::to_string(uptime.count()) +
+                    " worker_wakeups=" + std::to_string(stats_.workerWakeups.load(std::memory_order_relaxed)) +
+                    " commands_merged=" + std::to_string(stats_.commandsMerged.load(std::memory_order_relaxed)));
+    lines.push_back("position_samples dropped=" + std::to_string(stats_.positionSamplesDropped.load(std::memory_order_relaxed)) +
+                    " coalesced=" + std::to_string(stats_.positionSamplesCoalesced.load(std::memory_order_relaxed)));
+    lines.push_back("stream_reconnects ok=" + std::to_string(stats_.streamReconnects.load(std::memory_order_relaxed)) +
+                    " failed_attempts=" + std::to_string(stats_.streamReconnectFailures.load(std::memory_order_relaxed)));
 
-    const auto it = deviceStates_.find(deviceId);
-    if (it == deviceStates_.end()) {
-        return {};
+    // Metrics without samples are left out to keep the list readable in Papyrus traces.
+    const auto addHistogram = [&lines](const std::string& name, const LatencyHistogram& histogram) {
+        if (histogram.summarize().count > 0) {
+            lines.push_back(name + " " + histogram.describe());
+        }
+    };
+    for (std::size_t i = 0; i < kCommandKindCount; ++i) {
+        const std::string kind = commandKindName(static_cast<CommandKind>(i));
+        addHistogram("cmd." + kind + ".wait", stats_.commandWait[i]);
+        addHistogram("cmd." + kind + ".run", stats_.commandRun[i]);
     }
-    if (it->second.state != PlaybackState::Playing && it->second.state != PlaybackState::Paused) {
-        return {};
+    static constexpr std::array<const char*, kBackendStatCount> kBackendNames = {
+        "MCI", "MediaFoundationStream", "DirectShowStream", "NativeMixer"
+    };
+    for (std::size_t i = 0; i < kBackendStatCount; ++i) {
+        addHistogram(std::string("open.") + kBackendNames[i], stats_.backendOpen[i]);
+    }
+    addHistogram("stream_resolve", stats_.streamResolve);
+    addHistogram("session_save", stats_.sessionSave);
+    return lines;
+}
+
+const char* RadioEngine::commandKindName(CommandKind kind)
+{
+    switch (kind) {
+    case CommandKind::Task:
+        return "Task";
+    case CommandKind::Generic:
+        return "Generic";
+    case CommandKind::Transport:
+        return "Transport";
+    case CommandKind::Volume:
+        return "Volume";
+    case CommandKind::Forward:
+        return "Forward";
+    case CommandKind::Rewind:
+        return "Rewind";
+    case CommandKind::Previous:
+        return "Previous";
+    case CommandKind::ChangePlaylist:
+        return "ChangePlaylist";
+    case CommandKind::SelectSource:
+        return "SelectSource";
+    case CommandKind::Stop:
+        return "Stop";
+    case CommandKind::Pause:
+        return "Pause";
+    case CommandKind::Count:
+        break;
     }
-    if (it->second.currentTrackPath.empty()) {
-        return {};
+    return "Unknown";
+}
+
+void RadioEngine::recordBackendOpen(PlaybackBackend backend, std::chrono::steady_clock::time_point startedAt)
+{
+    if (backend == PlaybackBackend::None) {
+        return;
     }
-    return pathToUtf8(it->second.currentTrackPath.filename());
+    stats_.backendOpen[static_cast<std::size_t>(backend) - 1].record(std::chrono::steady_clock::now() - startedAt);
 }
 
-std::size_t RadioEngine::channelCount() const
+void RadioEngine::maybeLogStatsLocked(std::chrono::steady_clock::time_point now, bool force)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return channels_.size();
+    if (!force && (config_.statsLogMinutes <= 0 || now < nextStatsLogTime_)) {
+        return;
+    }
+    nextStatsLogTime_ = now + std::chrono::minutes(std::max(config_.statsLogMinutes, 1));
+    logger_.info([&]() {
+        std::string line = "Stats:";
+        for (const auto& entry : statsLines()) {
+            line += " [" + entry + "]";
+        }
+        return line;
+    });
 }
 
-bool RadioEngine::loadConfig()
+bool RadioEngine::loadConfig(Config& config)
 {
-    config_.radioRootPath = defaultRadioRoot();
-    config_.streamStations.clear();
-    config_.volumeStepPercent = 20.0F;
-    config_.debugVerbosity = 0;
-    config_.dialogDuckEnabled = false;
-    config_.dialogDuckVolume = 20.0F;
+    // Every key starts from its default, so a reload also forgets keys removed from the file.
+    config = Config{};
+    config.radioRootPath = defaultRadioRoot();
     bool debugVerbosityProvided = false;
 
     const auto path = configPath();
     if (!std::filesystem::exists(path)) {
-        logger_.warn("Config not found at " + pathToUtf8(path) + ". Using defaults.");
+        logger_.warn([&]() { return "Config not found at " + pathToUtf8(path) + ". Using defaults."; });
         return false;
     }
 
     std::ifstream in(path);
     if (!in.is_open()) {
-        logger_.warn("Could not open config file: " + pathToUtf8(path));
+        logger_.warn([&]() { return "Could not open config file: " + pathToUtf8(path); });
         return false;
     }
 
@@ -2476,111 +3015,149 @@ bool RadioEngine::loadConfig()
 
         try {
             if (key == "root_path") {
-                config_.radioRootPath = expandWindowsEnvironmentVariables(value);
+                config.radioRootPath = expandWindowsEnvironmentVariables(value);
             } else if (key == "log_level") {
                 if (!logger_.setLevelFromString(value)) {
-                    logger_.warn("Invalid config value for key: log_level (" + value + ")");
+                    logger_.warn([&]() { return "Invalid config value for key: log_level (" + value + ")"; });
                 }
             } else if (key == "transition_prefix") {
-                config_.transitionPrefix = value;
+                config.transitionPrefix = value;
             } else if (key == "ad_prefix") {
-                config_.adPrefix = value;
+                config.adPrefix = value;
             } else if (key == "ad_interval_songs") {
-                config_.adIntervalSongs = static_cast<std::size_t>(std::max(1, std::stoi(value)));
+                config.adIntervalSongs = static_cast<std::size_t>(std::max(1, std::stoi(value)));
+            } else if (key == "live_stations") {
+                config.liveStations = value == "1" || toLower(value) == "true";
             } else if (key == "min_fade_distance") {
-                config_.minFadeDistance = std::stof(value);
+                config.minFadeDistance = std::stof(value);
             } else if (key == "max_fade_distance") {
-                config_.maxFadeDistance = std::stof(value);
+                config.maxFadeDistance = std::stof(value);
             } else if (key == "enable_spatial_pan") {
-                config_.enableSpatialPan = value == "1" || toLower(value) == "true";
+                config.enableSpatialPan = value == "1" || toLower(value) == "true";
             } else if (key == "pan_distance") {
-                config_.panDistance = std::stof(value);
+                config.panDistance = std::stof(value);
+            } else if (key == "fade_update_hz") {
+                config.fadeUpdateHz = std::stof(value);
+            } else if (key == "fade_smoothing_ms") {
+                config.fadeSmoothingMs = std::stof(value);
+            } else if (key == "fade_max_extrapolation_ms") {
+                config.fadeMaxExtrapolationMs = std::stof(value);
             } else if (key == "log_fade_changes") {
-                config_.logFadeChanges = value == "1" || toLower(value) == "true";
+                config.logFadeChanges = value == "1" || toLower(value) == "true";
             } else if (key == "auto_rescan_on_change_playlist") {
-                config_.autoRescanOnChangePlaylist = value == "1" || toLower(value) == "true";
+                config.autoRescanOnChangePlaylist = value == "1" || toLower(value) == "true";
+            } else if (key == "watch_library") {
+                config.watchLibrary = value == "1" || toLower(value) == "true";
+            } else if (key == "library_watch_debounce_ms") {
+                config.libraryWatchDebounceMs = std::clamp(std::stoi(value), 0, kMaxLibraryWatchDebounceMs);
+            } else if (key == "watch_config") {
+                config.watchConfig = value == "1" || toLower(value) == "true";
             } else if (key == "loop_playlist") {
-                config_.loopPlaylist = value == "1" || toLower(value) == "true";
+                config.loopPlaylist = value == "1" || toLower(value) == "true";
+            } else if (key == "stream_cache_ttl_minutes") {
+                config.streamCacheTtlMinutes = std::max(0, std::stoi(value));
+            } else if (key == "audio_backend") {
+                config.nativeAudioBackend = toLower(value) == "native";
+            } else if (key == "stream_reconnect") {
+                config.streamReconnect = value == "1" || toLower(value) == "true";
+            } else if (key == "stream_standby_count") {
+                config.streamStandbyCount = std::clamp(std::stoi(value), 0, kMaxStreamStandby);
+            } else if (key == "library_analysis_threads") {
+                config.libraryAnalysisThreads = std::clamp(std::stoi(value), 0, kMaxLibraryAnalysisThreads);
+            } else if (key == "loudness_normalization") {
+                config.loudnessNormalization = value == "1" || toLower(value) == "true";
+            } else if (key == "loudness_target_lufs") {
+                config.loudnessTargetLufs = std::clamp(std::stof(value), -40.0F, -5.0F);
+            } else if (key == "stats_log_minutes") {
+                config.statsLogMinutes = std::clamp(std::stoi(value), 0, kMaxStatsLogMinutes);
+            } else if (key == "fx_cache_mb") {
+                config.fxCacheMegabytes = std::clamp(std::stoi(value), 0, kMaxFxCacheMegabytes);
             } else if (key == "verbose_stream_diagnostics") {
-                config_.verboseStreamDiagnostics = value == "1" || toLower(value) == "true";
+                config.verboseStreamDiagnostics = value == "1" || toLower(value) == "true";
             } else if (key == "volume_step_percent") {
-                config_.volumeStepPercent = std::stof(value);
+                config.volumeStepPercent = std::stof(value);
             } else if (key == "dialog_duck_enabled") {
-                config_.dialogDuckEnabled = value == "1" || toLower(value) == "true";
+                config.dialogDuckEnabled = value == "1" || toLower(value) == "true";
             } else if (key == "dialog_duck_volume") {
-                config_.dialogDuckVolume = std::stof(value);
+                config.dialogDuckVolume = std::stof(value);
             } else if (key == "debug_verbosity") {
-                config_.debugVerbosity = std::stoi(value);
+                config.debugVerbosity = std::stoi(value);
                 debugVerbosityProvided = true;
             } else if (key == "stream_station") {
                 const auto sep = value.find('|');
                 if (sep == std::string::npos) {
-                    logger_.warn("Invalid stream_station entry, expected Name|Url: " + value);
+                    logger_.warn([&]() { return "Invalid stream_station entry, expected Name|Url: " + value; });
                 } else {
                     const std::string name = trim(value.substr(0, sep));
                     const std::string url = trim(value.substr(sep + 1));
                     if (name.empty() || url.empty()) {
-                        logger_.warn("Invalid stream_station entry, empty name/url: " + value);
+                        logger_.warn([&]() { return "Invalid stream_station entry, empty name/url: " + value; });
                     } else {
-                        config_.streamStations.emplace_back(name, url);
+                        config.streamStations.emplace_back(name, url);
                     }
                 }
             }
         } catch (...) {
-            logger_.warn("Invalid config value for key: " + key + " (" + value + ")");
+            logger_.warn([&]() { return "Invalid config value for key: " + key + " (" + value + ")"; });
         }
     }
 
-    if (config_.maxFadeDistance < config_.minFadeDistance + kMinimumFadeGap) {
-        config_.maxFadeDistance = config_.minFadeDistance + kMinimumFadeGap;
+    if (config.maxFadeDistance < config.minFadeDistance + kMinimumFadeGap) {
+        config.maxFadeDistance = config.minFadeDistance + kMinimumFadeGap;
     }
-    if (config_.panDistance < kMinimumFadeGap) {
-        config_.panDistance = kMinimumFadeGap;
+    if (config.panDistance < kMinimumFadeGap) {
+        config.panDistance = kMinimumFadeGap;
     }
-    if (config_.volumeStepPercent <= 0.0F) {
-        config_.volumeStepPercent = 20.0F;
-    } else if (config_.volumeStepPercent > kMaximumVolumePercent) {
-        config_.volumeStepPercent = kMaximumVolumePercent;
+    if (config.volumeStepPercent <= 0.0F) {
+        config.volumeStepPercent = 20.0F;
+    } else if (config.volumeStepPercent > kMaximumVolumePercent) {
+        config.volumeStepPercent = kMaximumVolumePercent;
     }
-    config_.debugVerbosity = std::clamp<std::int32_t>(config_.debugVerbosity, 0, 2);
+    config.debugVerbosity = std::clamp<std::int32_t>(config.debugVerbosity, 0, 2);
 
     if (debugVerbosityProvided) {
-        if (config_.debugVerbosity <= 0) {
+        if (config.debugVerbosity <= 0) {
             logger_.setLevel(Logger::Level::Warn);
-            config_.verboseStreamDiagnostics = false;
-            config_.logFadeChanges = false;
-        } else if (config_.debugVerbosity == 1) {
+            config.verboseStreamDiagnostics = false;
+            config.logFadeChanges = false;
+        } else if (config.debugVerbosity == 1) {
             logger_.setLevel(Logger::Level::Info);
-            config_.verboseStreamDiagnostics = false;
-            config_.logFadeChanges = false;
+            config.verboseStreamDiagnostics = false;
+            config.logFadeChanges = false;
         } else {
             logger_.setLevel(Logger::Level::Info);
-            config_.verboseStreamDiagnostics = true;
-            config_.logFadeChanges = true;
+            config.verboseStreamDiagnostics = true;
+            config.logFadeChanges = true;
         }
     } else {
-        if (config_.verboseStreamDiagnostics || config_.logFadeChanges) {
-            config_.debugVerbosity = 2;
+        if (config.verboseStreamDiagnostics || config.logFadeChanges) {
+            config.debugVerbosity = 2;
         } else if (logger_.level() == Logger::Level::Info) {
-            config_.debugVerbosity = 1;
+            config.debugVerbosity = 1;
         } else {
-            config_.debugVerbosity = 0;
+            config.debugVerbosity = 0;
         }
     }
 
-    if (config_.dialogDuckVolume < 0.0F) {
-        config_.dialogDuckVolume = 0.0F;
-    } else if (config_.dialogDuckVolume > 200.0F) {
-        config_.dialogDuckVolume = 200.0F;
+    config.fadeUpdateHz = std::clamp(config.fadeUpdateHz, 0.0F, 60.0F);
+    config.fadeSmoothingMs = std::clamp(config.fadeSmoothingMs, 0.0F, 2000.0F);
+    config.fadeMaxExtrapolationMs = std::clamp(config.fadeMaxExtrapolationMs, 0.0F, 5000.0F);
+
+    if (config.dialogDuckVolume < 0.0F) {
+        config.dialogDuckVolume = 0.0F;
+    } else if (config.dialogDuckVolume > 200.0F) {
+        config.dialogDuckVolume = 200.0F;
     }
 
-    logger_.info("Config loaded. root_path=" + pathToUtf8(config_.radioRootPath) +
-                 ", spatial_pan=" + std::string(config_.enableSpatialPan ? "true" : "false") +
-                 ", pan_distance=" + std::to_string(config_.panDistance) +
-                 ", volume_step_percent=" + std::to_string(config_.volumeStepPercent) +
-                 ", debug_verbosity=" + std::to_string(config_.debugVerbosity) +
-                 ", dialog_duck_enabled=" + std::string(config_.dialogDuckEnabled ? "true" : "false") +
-                 ", dialog_duck_volume=" + std::to_string(config_.dialogDuckVolume));
+    logger_.info([&]() {
+        return "Config loaded. root_path=" + pathToUtf8(config.radioRootPath) +
+               ", spatial_pan=" + std::string(config.enableSpatialPan ? "true" : "false") +
+               ", pan_distance=" + std::to_string(config.panDistance) +
+               ", volume_step_percent=" + std::to_string(config.volumeStepPercent) +
+               ", debug_verbosity=" + std::to_string(config.debugVerbosity) +
+               ", dialog_duck_enabled=" + std::string(config.dialogDuckEnabled ? "true" : "false") +
+               ", dialog_duck_volume=" + std::to_string(config.dialogDuckVolume);
+    });
     return true;
 }
 
@@ -2589,6 +3166,149 @@ std::filesystem::path RadioEngine::configPath()
     return std::filesystem::path("Data") / "SFSE" / "Plugins" / "RadioSFSE.ini";
 }
 
+// Swaps in a freshly parsed config and applies only what differs from the running one. Returns
+// the library watcher when its settings changed; the caller stops it without holding mutex_ and
+// then calls startLibraryWatcherLocked().
+std::unique_ptr<LibraryWatcher> RadioEngine::applyConfigLocked(Config next)
+{
+    const Config previous = std::exchange(config_, std::move(next));
+    std::vector<std::string> changes;
+
+    const bool rootChanged = previous.radioRootPath != config_.radioRootPath;
+    const bool prefixesChanged =
+        previous.transitionPrefix != config_.transitionPrefix || previous.adPrefix != config_.adPrefix;
+    if (rootChanged) {
+        // The stream cache lives under the root; the session is written there from the next save.
+        (void)loadStreamCacheLocked();
+        changes.push_back("root_path");
+    }
+    if (prefixesChanged) {
+        changes.push_back("prefixes");
+    }
+    if (rootChanged || prefixesChanged) {
+        // Listings indexed under the old root or split with the old prefixes cannot be reused.
+        libraryRelistPending_ = true;
+        (void)requestLibraryRescanLocked();
+    }
+    if (previous.streamStations != config_.streamStations) {
+        reloadConfiguredStreamsLocked();
+        changes.push_back("stream_station");
+    }
+
+    if (previous.adIntervalSongs != config_.adIntervalSongs || previous.liveStations != config_.liveStations) {
+        liveTimelines_.clear();
+        changes.push_back("station programme");
+    }
+
+    // The worker's next tick re-evaluates fade, pan and normalization gain for every playing device.
+    if (previous.minFadeDistance != config_.minFadeDistance ||
+        previous.maxFadeDistance != config_.maxFadeDistance ||
+        previous.enableSpatialPan != config_.enableSpatialPan ||
+        previous.panDistance != config_.panDistance ||
+        previous.fadeUpdateHz != config_.fadeUpdateHz ||
+        previous.fadeSmoothingMs != config_.fadeSmoothingMs ||
+        previous.fadeMaxExtrapolationMs != config_.fadeMaxExtrapolationMs ||
+        previous.loudnessNormalization != config_.loudnessNormalization ||
+        previous.loudnessTargetLufs != config_.loudnessTargetLufs) {
+        changes.push_back("fade/volume");
+    }
+
+    if (previous.fxCacheMegabytes != config_.fxCacheMegabytes) {
+        if (config_.fxCacheMegabytes > 0) {
+            refreshFxCacheLocked();
+        } else if (fxCache_) {
+            fxCache_->load({}, 0);
+        }
+        changes.push_back("fx_cache_mb");
+    }
+    if (previous.statsLogMinutes != config_.statsLogMinutes) {
+        nextStatsLogTime_ = std::chrono::steady_clock::now() + std::chrono::minutes(std::max(config_.statsLogMinutes, 1));
+    }
+    if (previous.libraryAnalysisThreads != config_.libraryAnalysisThreads) {
+        if (analyzer_) {
+            // A running pool keeps its size; 0 only stops queuing new files.
+            logger_.info("A new library_analysis_threads pool size takes effect after a restart.");
+        } else {
+            scheduleLibraryAnalysisLocked(nullptr);
+        }
+    }
+    if (previous.nativeAudioBackend != config_.nativeAudioBackend) {
+        // Tracks already open keep their backend; the next local track opens on the new one.
+        mixerUnavailable_ = false;
+        changes.push_back("audio_backend");
+    }
+    if (config_.watchConfig && !previous.watchConfig) {
+        nextConfigCheckTime_ = std::chrono::steady_clock::now() + kConfigWatchInterval;
+    }
+
+    std::unique_ptr<LibraryWatcher> retiredWatcher;
+    if (libraryWatcher_ && (rootChanged || !config_.watchLibrary ||
+                            previous.libraryWatchDebounceMs != config_.libraryWatchDebounceMs)) {
+        retiredWatcher = std::move(libraryWatcher_);
+    } else {
+        startLibraryWatcherLocked();
+    }
+
+    statusFullRebuildPending_ = true;
+    publishStatusSnapshotLocked();
+    logger_.info([&]() {
+        std::string applied;
+        for (const auto& change : changes) {
+            applied += (applied.empty() ? "" : ", ") + change;
+        }
+        return "Config reloaded" + (applied.empty() ? std::string(".") : "; applied: " + applied + ".");
+    });
+    return retiredWatcher;
+}
+
+// Replaces only the stream/ channels; library sources and every device on them stay as they are.
+void RadioEngine::reloadConfiguredStreamsLocked()
+{
+    syncCurrentDeviceStateLocked();
+
+    std::set<std::string> changedKeys;
+    std::map<std::string, ChannelEntry> previousChannels;
+    for (auto it = channels_.begin(); it != channels_.end();) {
+        const auto current = it++;
+        if (current->second.isStream) {
+            changedKeys.insert(current->first);
+            previousChannels.insert(channels_.extract(current));
+        }
+    }
+    streamOrderKeys_.clear();
+    addConfiguredStreamsLocked();
+    changedKeys.insert(streamOrderKeys_.begin(), streamOrderKeys_.end());
+
+    rebuildChannelIndexLocked();
+    remapDevicesAfterLibraryChangeLocked(previousChannels, &changedKeys);
+}
+
+void RadioEngine::maybeQueueConfigReloadLocked(std::chrono::steady_clock::time_point now)
+{
+    if (!config_.watchConfig || now < nextConfigCheckTime_) {
+        return;
+    }
+    nextConfigCheckTime_ = now + kConfigWatchInterval;
+
+    std::error_code timeEc;
+    const long long writeTime = directoryWriteTimeValue(configPath(), timeEc);
+    if (timeEc || writeTime == configWriteTime_) {
+        return;
+    }
+    // Recorded here so one save is queued once; reloadConfig() stores the time it actually read.
+    configWriteTime_ = writeTime;
+    logger_.info("Config file changed; reloading.");
+
+    QueuedCommand task;
+    task.kind = CommandKind::Task;
+    task.enqueuedAt = now;
+    task.command = [this]() {
+        (void)reloadConfig();
+        return true;
+    };
+    commandQueue_.push_back(std::move(task));
+}
+
 std::string RadioEngine::trim(const std::string& text)
 {
     std::size_t start = 0;
@@ -2666,28 +3386,149 @@ std::wstring RadioEngine::quoteForMCI(const std::wstring& text)
 
 bool RadioEngine::scanLibraryLocked()
 {
-    channels_.clear();
-    fxFiles_.clear();
-    streamOrderKeys_.clear();
+    if (libraryIndex_.empty()) {
+        (void)loadLibraryIndexLocked();
+    }
 
-    const std::string transitionPrefixLower = toLower(config_.transitionPrefix);
-    const std::string adPrefixLower = toLower(config_.adPrefix);
+    const LibraryScanSettings settings = libraryScanSettingsLocked();
+    const std::map<std::string, LibraryIndexEntry> noIndex;
+    const auto& previousIndex = std::exchange(libraryRelistPending_, false) ? noIndex : libraryIndex_;
+    LibrarySnapshot snapshot = buildLibrarySnapshot(settings, previousIndex, logger_, libraryScanStop_);
+    if (snapshot.indexDirty) {
+        (void)writeLibraryIndexFile(settings, snapshot.index, logger_);
+    }
 
-    const auto scanCategory = [this, &transitionPrefixLower, &adPrefixLower](
-                                  const std::filesystem::path& categoryRoot,
-                                  const char* keyPrefix,
-                                  ChannelType channelType) {
-        if (!std::filesystem::exists(categoryRoot)) {
-            logger_.warn("Category root path does not exist: " + pathToUtf8(categoryRoot));
-            return;
-        }
-        if (!std::filesystem::is_directory(categoryRoot)) {
-            logger_.warn("Category root is not a directory: " + pathToUtf8(categoryRoot));
+    installLibrarySnapshotLocked(std::move(snapshot));
+    return !channels_.empty();
+}
+
+RadioEngine::LibraryScanSettings RadioEngine::libraryScanSettingsLocked() const
+{
+    LibraryScanSettings settings;
+    settings.radioRootPath = config_.radioRootPath;
+    settings.transitionPrefix = config_.transitionPrefix;
+    settings.adPrefix = config_.adPrefix;
+    return settings;
+}
+
+// Lists one source directory into sorted file names. Station files are split by prefix here so
+// index reuse never has to look at individual files again.
+RadioEngine::LibraryIndexEntry RadioEngine::listLibraryDirectory(
+    const LibraryScanSettings& settings,
+    const std::filesystem::path& directoryPath,
+    ChannelType channelType,
+    bool splitByPrefix)
+{
+    const std::string transitionPrefixLower = toLower(settings.transitionPrefix);
+    const std::string adPrefixLower = toLower(settings.adPrefix);
+
+    std::vector<std::filesystem::path> songs;
+    std::vector<std::filesystem::path> transitions;
+    std::vector<std::filesystem::path> ads;
+
+    std::error_code fileEc;
+    for (std::filesystem::directory_iterator fileIt(directoryPath, fileEc), fileEnd; fileIt != fileEnd && !fileEc; fileIt.increment(fileEc)) {
+        if (!fileIt->is_regular_file()) {
+            continue;
+        }
+
+        const auto filePath = fileIt->path();
+        if (!hasAudioExtension(filePath)) {
+            continue;
+        }
+
+        if (!splitByPrefix || channelType == ChannelType::Playlist) {
+            songs.push_back(filePath);
+            continue;
+        }
+
+        const std::string stemLower = toLower(pathToUtf8(filePath.stem()));
+        if (!transitionPrefixLower.empty() && stemLower.starts_with(transitionPrefixLower)) {
+            transitions.push_back(filePath);
+        } else if (!adPrefixLower.empty() && stemLower.starts_with(adPrefixLower)) {
+            ads.push_back(filePath);
+        } else {
+            songs.push_back(filePath);
+        }
+    }
+
+    std::sort(songs.begin(), songs.end());
+    std::sort(transitions.begin(), transitions.end());
+    std::sort(ads.begin(), ads.end());
+
+    const auto toNames = [](const std::vector<std::filesystem::path>& paths) {
+        std::vector<std::string> names;
+        names.reserve(paths.size());
+        for (const auto& path : paths) {
+            names.push_back(pathToUtf8(path.filename()));
+        }
+        return names;
+    };
+
+    LibraryIndexEntry entry;
+    entry.songs = toNames(songs);
+    entry.transitions = toNames(transitions);
+    entry.ads = toNames(ads);
+    return entry;
+}
+
+RadioEngine::LibrarySnapshot RadioEngine::buildLibrarySnapshot(
+    const LibraryScanSettings& settings,
+    const std::map<std::string, LibraryIndexEntry>& previousIndex,
+    Logger& logger,
+    const std::atomic<bool>& stopRequested)
+{
+    LibrarySnapshot snapshot;
+
+    // Reuses the cached listing when the directory timestamp is unchanged. Adding, removing or
+    // renaming a file updates the parent directory's write time, which is what forces a re-list.
+    const auto resolveEntry = [&settings, &snapshot, &previousIndex](
+                                  const std::string& key,
+                                  const std::string& name,
+                                  const std::filesystem::path& directoryPath,
+                                  ChannelType channelType,
+                                  bool splitByPrefix) -> const LibraryIndexEntry& {
+        std::error_code timeEc;
+        const long long writeTime = directoryWriteTimeValue(directoryPath, timeEc);
+
+        const auto cachedIt = previousIndex.find(key);
+        if (!timeEc && cachedIt != previousIndex.end() &&
+            cachedIt->second.directoryWriteTime == writeTime &&
+            cachedIt->second.name == name) {
+            ++snapshot.reusedCount;
+            return snapshot.index[key] = cachedIt->second;
+        }
+
+        LibraryIndexEntry entry = listLibraryDirectory(settings, directoryPath, channelType, splitByPrefix);
+        entry.key = key;
+        entry.name = name;
+        entry.directoryWriteTime = timeEc ? 0 : writeTime;
+        if (cachedIt != previousIndex.end()) {
+            carryTrackAnalysis(entry, cachedIt->second);
+        }
+        ++snapshot.relistedCount;
+        snapshot.indexDirty = true;
+        return snapshot.index[key] = std::move(entry);
+    };
+
+    const auto scanCategory = [&snapshot, &resolveEntry, &logger, &stopRequested](
+                                  const std::filesystem::path& categoryRoot,
+                                  const char* keyPrefix,
+                                  ChannelType channelType) {
+        if (!std::filesystem::exists(categoryRoot)) {
+            logger.warn("Category root path does not exist: " + pathToUtf8(categoryRoot));
+            return;
+        }
+        if (!std::filesystem::is_directory(categoryRoot)) {
+            logger.warn("Category root is not a directory: " + pathToUtf8(categoryRoot));
             return;
         }
 
         std::error_code ec;
         for (std::filesystem::directory_iterator sourceIt(categoryRoot, ec), sourceEnd; sourceIt != sourceEnd && !ec; sourceIt.increment(ec)) {
+            if (stopRequested.load(std::memory_order_relaxed)) {
+                return;
+            }
             if (!sourceIt->is_directory()) {
                 continue;
             }
@@ -2698,794 +3539,2461 @@ bool RadioEngine::scanLibraryLocked()
                 continue;
             }
 
-            std::vector<std::filesystem::path> songs;
-            std::vector<std::filesystem::path> transitions;
-            std::vector<std::filesystem::path> ads;
+            const std::string key = std::string(keyPrefix) + "/" + toLower(sourceName);
+            const LibraryIndexEntry& indexEntry = resolveEntry(key, sourceName, sourcePath, channelType, true);
+            if (indexEntry.songs.empty()) {
+                continue;
+            }
 
-            std::error_code fileEc;
-            for (std::filesystem::directory_iterator fileIt(sourcePath, fileEc), fileEnd; fileIt != fileEnd && !fileEc; fileIt.increment(fileEc)) {
-                if (!fileIt->is_regular_file()) {
-                    continue;
-                }
+            snapshot.channels[key] = channelFromIndexEntry(indexEntry, sourcePath, channelType);
+        }
+    };
 
-                const auto filePath = fileIt->path();
-                if (!hasAudioExtension(filePath)) {
-                    continue;
-                }
+    if (settings.radioRootPath.empty() || !std::filesystem::exists(settings.radioRootPath)) {
+        logger.warn("Radio root path does not exist: " + pathToUtf8(settings.radioRootPath));
+    } else {
+        scanCategory(settings.radioRootPath / "Playlists", "playlist", ChannelType::Playlist);
+        scanCategory(settings.radioRootPath / "Stations", "station", ChannelType::Station);
+    }
 
-                if (channelType == ChannelType::Playlist) {
-                    songs.push_back(filePath);
-                    continue;
-                }
+    const std::filesystem::path fxRoot = settings.radioRootPath / "FX";
+    if (std::filesystem::exists(fxRoot) && std::filesystem::is_directory(fxRoot)) {
+        const LibraryIndexEntry& fxEntry = resolveEntry(kFxIndexKey, "FX", fxRoot, ChannelType::Playlist, false);
+        addFxFilesFromIndexEntry(snapshot.fxFiles, fxEntry, fxRoot);
+    }
 
-                const std::string stemLower = toLower(pathToUtf8(filePath.stem()));
-                if (!transitionPrefixLower.empty() && stemLower.starts_with(transitionPrefixLower)) {
-                    transitions.push_back(filePath);
-                } else if (!adPrefixLower.empty() && stemLower.starts_with(adPrefixLower)) {
-                    ads.push_back(filePath);
-                } else {
-                    songs.push_back(filePath);
-                }
-            }
+    if (snapshot.index.size() != previousIndex.size()) {
+        snapshot.indexDirty = true;
+    }
 
-            if (songs.empty()) {
-                continue;
-            }
+    logger.info("Library scan: reused " + std::to_string(snapshot.reusedCount) + " indexed folder(s), re-listed " +
+                std::to_string(snapshot.relistedCount) + ".");
+    return snapshot;
+}
+
+RadioEngine::LibraryUpdate RadioEngine::buildLibraryUpdate(
+    const LibraryScanSettings& settings,
+    const std::set<std::filesystem::path>& sources,
+    const std::map<std::string, LibraryIndexEntry>& previousIndex)
+{
+    LibraryUpdate update;
 
-            std::sort(songs.begin(), songs.end());
-            std::sort(transitions.begin(), transitions.end());
-            std::sort(ads.begin(), ads.end());
+    // Re-lists one source into update.index and reports whether its track lists changed. A listing
+    // that only moved the folder time (a file rewritten in place, a copy still in progress) leaves
+    // the channel alone, so devices playing from it are not disturbed.
+    const auto relist = [&settings, &update, &previousIndex](
+                            const std::string& key,
+                            const std::string& name,
+                            const std::filesystem::path& directoryPath,
+                            ChannelType channelType,
+                            bool splitByPrefix) -> bool {
+        std::error_code timeEc;
+        const long long writeTime = directoryWriteTimeValue(directoryPath, timeEc);
 
-            const std::string key = std::string(keyPrefix) + "/" + toLower(sourceName);
-            ChannelEntry entry;
-            entry.key = key;
-            entry.displayName = sourceName;
-            entry.directoryPath = sourcePath;
-            entry.type = channelType;
-            entry.songs = std::move(songs);
-            entry.transitions = std::move(transitions);
-            entry.ads = std::move(ads);
+        LibraryIndexEntry entry = listLibraryDirectory(settings, directoryPath, channelType, splitByPrefix);
+        entry.key = key;
+        entry.name = name;
+        entry.directoryWriteTime = timeEc ? 0 : writeTime;
+
+        const auto previousIt = previousIndex.find(key);
+        if (previousIt == previousIndex.end()) {
+            update.index[key] = std::move(entry);
+            return true;
+        }
 
-            channels_[key] = std::move(entry);
+        const LibraryIndexEntry& previous = previousIt->second;
+        carryTrackAnalysis(entry, previous);
+        const bool listingChanged = previous.name != entry.name || previous.songs != entry.songs ||
+                                    previous.transitions != entry.transitions || previous.ads != entry.ads;
+        if (listingChanged || previous.directoryWriteTime != entry.directoryWriteTime) {
+            update.index[key] = std::move(entry);
         }
+        return listingChanged;
     };
 
-    if (config_.radioRootPath.empty() || !std::filesystem::exists(config_.radioRootPath)) {
-        logger_.warn("Radio root path does not exist: " + pathToUtf8(config_.radioRootPath));
-    } else {
-        scanCategory(config_.radioRootPath / "Playlists", "playlist", ChannelType::Playlist);
-        scanCategory(config_.radioRootPath / "Stations", "station", ChannelType::Station);
+    struct Category
+    {
+        const char* folder;
+        const char* keyPrefix;
+        ChannelType channelType;
+        std::set<std::string> keys;
+    };
+    std::array<Category, 2> categories{ {
+        { "playlists", "playlist", ChannelType::Playlist, {} },
+        { "stations", "station", ChannelType::Station, {} },
+    } };
+    bool fxChanged = false;
+
+    for (const auto& source : sources) {
+        auto part = source.begin();
+        if (part == source.end()) {
+            continue;
+        }
+        const std::string folderLower = toLower(pathToUtf8(*part));
+        ++part;
+        if (folderLower == "fx") {
+            fxChanged = true;
+            continue;
+        }
+        if (part == source.end()) {
+            continue;
+        }
+        for (auto& category : categories) {
+            if (folderLower == category.folder) {
+                category.keys.insert(std::string(category.keyPrefix) + "/" + toLower(pathToUtf8(*part)));
+            }
+        }
     }
 
-    addConfiguredStreamsLocked();
+    for (auto& category : categories) {
+        if (category.keys.empty()) {
+            continue;
+        }
 
-    const std::filesystem::path fxRoot = config_.radioRootPath / "FX";
-    if (std::filesystem::exists(fxRoot) && std::filesystem::is_directory(fxRoot)) {
-        std::error_code fxEc;
-        for (std::filesystem::directory_iterator fxIt(fxRoot, fxEc), fxEnd; fxIt != fxEnd && !fxEc; fxIt.increment(fxEc)) {
-            if (!fxIt->is_regular_file()) {
+        // Walk the category for the folders' on-disk names; a reported key that is no longer
+        // there was removed or renamed away.
+        const std::filesystem::path categoryRoot =
+            settings.radioRootPath / (category.channelType == ChannelType::Playlist ? "Playlists" : "Stations");
+        std::set<std::string> foundKeys;
+        std::error_code ec;
+        for (std::filesystem::directory_iterator sourceIt(categoryRoot, ec), sourceEnd; sourceIt != sourceEnd && !ec; sourceIt.increment(ec)) {
+            if (!sourceIt->is_directory()) {
                 continue;
             }
 
-            const auto filePath = fxIt->path();
-            if (!hasAudioExtension(filePath)) {
+            const auto sourcePath = sourceIt->path();
+            const std::string sourceName = pathToUtf8(sourcePath.filename());
+            const std::string key = std::string(category.keyPrefix) + "/" + toLower(sourceName);
+            if (sourceName.empty() || !category.keys.contains(key)) {
                 continue;
             }
 
-            const std::string fileNameLower = toLower(pathToUtf8(filePath.filename()));
-            const std::string stemLower = toLower(pathToUtf8(filePath.stem()));
-            if (!fileNameLower.empty() && !fxFiles_.contains(fileNameLower)) {
-                fxFiles_[fileNameLower] = filePath;
+            foundKeys.insert(key);
+            if (!relist(key, sourceName, sourcePath, category.channelType, true)) {
+                continue;
+            }
+            update.changedKeys.insert(key);
+            const LibraryIndexEntry& indexEntry = *update.index[key];
+            if (!indexEntry.songs.empty()) {
+                update.channels[key] = channelFromIndexEntry(indexEntry, sourcePath, category.channelType);
             }
-            if (!stemLower.empty() && !fxFiles_.contains(stemLower)) {
-                fxFiles_[stemLower] = filePath;
+        }
+
+        for (const auto& key : category.keys) {
+            if (!foundKeys.contains(key) && previousIndex.contains(key)) {
+                update.index[key] = std::nullopt;
+                update.changedKeys.insert(key);
             }
         }
     }
 
-    return !channels_.empty();
+    if (fxChanged) {
+        const std::filesystem::path fxRoot = settings.radioRootPath / "FX";
+        if (std::filesystem::is_directory(fxRoot)) {
+            if (relist(kFxIndexKey, "FX", fxRoot, ChannelType::Playlist, false)) {
+                update.fxFiles.emplace();
+                addFxFilesFromIndexEntry(*update.fxFiles, *update.index[kFxIndexKey], fxRoot);
+            }
+        } else if (previousIndex.contains(kFxIndexKey)) {
+            update.index[kFxIndexKey] = std::nullopt;
+            update.fxFiles.emplace();
+        }
+    }
+
+    return update;
 }
 
-void RadioEngine::addConfiguredStreamsLocked()
+void RadioEngine::installLibrarySnapshotLocked(LibrarySnapshot&& snapshot)
 {
-    for (const auto& [name, url] : config_.streamStations) {
-        const std::string key = "stream/" + toLower(trim(name));
-        if (key.empty() || url.empty()) {
-            continue;
-        }
+    // Fold the live mirror into deviceStates_ first so every device is remapped the same way.
+    syncCurrentDeviceStateLocked();
 
-        ChannelEntry entry;
-        entry.key = key;
-        entry.displayName = name;
-        entry.type = ChannelType::Station;
-        entry.isStream = true;
-        entry.streamUrl = url;
+    // Preloaded tracks were resolved against the old song lists.
+    discardAllPreloadsLocked();
 
-        if (std::find(streamOrderKeys_.begin(), streamOrderKeys_.end(), key) == streamOrderKeys_.end()) {
-            streamOrderKeys_.push_back(key);
+    // The scan started from a copy of the index; keep whatever the analyzer measured since then.
+    // Only directories that are new or were written since the last scan need their files queued.
+    std::set<std::string> changedKeys;
+    for (auto& [key, entry] : snapshot.index) {
+        const auto previousIt = libraryIndex_.find(key);
+        if (previousIt != libraryIndex_.end()) {
+            carryTrackAnalysis(entry, previousIt->second);
+        }
+        if (previousIt == libraryIndex_.end() || previousIt->second.directoryWriteTime != entry.directoryWriteTime) {
+            changedKeys.insert(key);
         }
-        channels_[key] = std::move(entry);
     }
+
+    std::map<std::string, ChannelEntry> previousChannels = std::move(channels_);
+    channels_ = std::move(snapshot.channels);
+    fxFiles_ = std::move(snapshot.fxFiles);
+    refreshFxCacheLocked();
+    libraryIndex_ = std::move(snapshot.index);
+    analysisLookupPath_.clear();
+    liveTimelines_.clear();
+    streamOrderKeys_.clear();
+    addConfiguredStreamsLocked();
+    rebuildChannelIndexLocked();
+    remapDevicesAfterLibraryChangeLocked(previousChannels, nullptr);
+    scheduleLibraryAnalysisLocked(std::exchange(libraryAnalysisFullPassPending_, false) ? nullptr : &changedKeys);
 }
 
-std::optional<RadioEngine::ChannelEntry> RadioEngine::lookupChannelLocked(const std::string& channelName) const
+void RadioEngine::installLibraryUpdateLocked(LibraryUpdate&& update)
 {
-    std::string key = toLower(trim(channelName));
-    if (key.empty()) {
-        return std::nullopt;
+    for (auto& [key, entry] : update.index) {
+        if (!entry.has_value()) {
+            libraryIndex_.erase(key);
+            continue;
+        }
+        const auto previousIt = libraryIndex_.find(key);
+        if (previousIt != libraryIndex_.end()) {
+            carryTrackAnalysis(*entry, previousIt->second);
+        }
+        libraryIndex_[key] = std::move(*entry);
     }
-
-    if (key.starts_with("playlists/")) {
-        key = "playlist/" + key.substr(std::string("playlists/").size());
-    } else if (key.starts_with("stations/")) {
-        key = "station/" + key.substr(std::string("stations/").size());
+    if (update.fxFiles.has_value()) {
+        fxFiles_ = std::move(*update.fxFiles);
+        refreshFxCacheLocked();
+    }
+    if (update.changedKeys.empty()) {
+        return;
     }
+    scheduleLibraryAnalysisLocked(&update.changedKeys);
 
-    auto it = channels_.find(key);
-    if (it != channels_.end()) {
-        return it->second;
+    syncCurrentDeviceStateLocked();
+    discardAllPreloadsLocked();
+
+    // Only the reported channels are replaced; every other ChannelEntry stays where it is.
+    std::map<std::string, ChannelEntry> previousChannels;
+    for (const auto& key : update.changedKeys) {
+        auto previousNode = channels_.extract(key);
+        if (!previousNode.empty()) {
+            previousChannels.insert(std::move(previousNode));
+        }
+        const auto updatedIt = update.channels.find(key);
+        if (updatedIt != update.channels.end()) {
+            channels_.insert_or_assign(key, std::move(updatedIt->second));
+        }
     }
+    analysisLookupPath_.clear();
+    liveTimelines_.clear();
+    rebuildChannelIndexLocked();
+    remapDevicesAfterLibraryChangeLocked(previousChannels, &update.changedKeys);
+}
 
-    std::vector<std::string> prefixedKeys = {
-        "playlist/" + key,
-        "station/" + key,
-        "stream/" + key
-    };
+// changedKeys limits the remap to devices on those channels; null remaps every device.
+void RadioEngine::remapDevicesAfterLibraryChangeLocked(
+    const std::map<std::string, ChannelEntry>& previousChannels,
+    const std::set<std::string>* changedKeys)
+{
+    // Song indices point into the old per-channel song lists. Translate them through the song path
+    // so a device keeps its place when files are added or removed around it.
+    for (auto& [deviceId, deviceState] : deviceStates_) {
+        if (deviceState.selectedKey.empty()) {
+            continue;
+        }
+        if (changedKeys != nullptr && !changedKeys->contains(deviceState.selectedKey)) {
+            continue;
+        }
 
-    std::optional<ChannelEntry> uniqueMatch;
-    for (const auto& candidate : prefixedKeys) {
-        const auto byPrefix = channels_.find(candidate);
-        if (byPrefix == channels_.end()) {
+        const auto newIt = channels_.find(deviceState.selectedKey);
+        if (newIt == channels_.end()) {
+            logger_.warn([&]() {
+                return "Library rescan removed selected source '" + deviceState.selectedKey +
+                       "' (deviceId=" + std::to_string(deviceId) + ").";
+            });
             continue;
         }
-        if (uniqueMatch.has_value()) {
-            return std::nullopt;
+
+        const auto& newSongs = newIt->second.songs;
+        const auto oldIt = previousChannels.find(deviceState.selectedKey);
+        const auto remapSongIndex = [&newSongs, &oldIt, &previousChannels](std::size_t oldIndex) -> std::optional<std::size_t> {
+            if (oldIt == previousChannels.end() || oldIndex >= oldIt->second.songs.size()) {
+                return std::nullopt;
+            }
+            const auto& oldSongs = oldIt->second.songs;
+            const auto found = newSongs.findByFileName(oldSongs.lowerFileName(oldIndex));
+            if (!found.has_value() || newSongs.fileName(*found) != oldSongs.fileName(oldIndex) ||
+                newSongs.directory() != oldSongs.directory()) {
+                return std::nullopt;
+            }
+            return *found;
+        };
+
+        const auto remappedSong = remapSongIndex(deviceState.songIndex);
+        if (remappedSong.has_value()) {
+            deviceState.songIndex = *remappedSong;
+        } else if (deviceState.songIndex >= newSongs.size()) {
+            deviceState.songIndex = 0;
         }
-        uniqueMatch = byPrefix->second;
-    }
-    if (uniqueMatch.has_value()) {
-        return uniqueMatch;
-    }
 
-    for (const auto& [mapKey, entry] : channels_) {
-        (void)mapKey;
-        if (toLower(entry.displayName) == key) {
-            return entry;
+        // A shuffle order is a permutation of the old song count; once it no longer lands on the
+        // remapped song, drop it and let the next advance re-anchor a fresh one there.
+        if (!shuffleOrderMatches(deviceState.shuffle, deviceState.songIndex, newSongs.size())) {
+            deviceState.shuffle = {};
         }
     }
 
-    return std::nullopt;
+    const auto currentIt = deviceStates_.find(currentDeviceId_);
+    if (currentIt != deviceStates_.end()) {
+        applyDeviceStateLocked(currentIt->second);
+    }
+    sessionFullRebuildPending_ = true;
+    sessionStateDirty_ = true;
+    statusFullRebuildPending_ = true;
 }
 
-bool RadioEngine::startCurrentLocked(PlaybackMode mode, bool resetPosition)
+bool RadioEngine::requestLibraryRescanLocked()
 {
-    const auto channelIt = channels_.find(selectedKey_);
-    if (channelIt == channels_.end()) {
-        logger_.warn("startCurrent failed. Selected channel no longer exists.");
+    if (!workerRunning_) {
+        return scanLibraryLocked();
+    }
+    if (stopWorker_ || libraryScanStop_.load(std::memory_order_relaxed)) {
         return false;
     }
 
-    const auto& channel = channelIt->second;
-    if (channel.songs.empty()) {
-        if (!channel.isStream) {
-            logger_.warn("startCurrent failed. Channel has no songs: " + channel.displayName);
-            return false;
-        }
+    // A scan of a missing root could only empty the library; report it instead of queuing one.
+    std::error_code rootEc;
+    if (!std::filesystem::is_directory(config_.radioRootPath, rootEc)) {
+        logger_.warn([&]() { return "Library rescan not started: radio root not found at " + pathToUtf8(config_.radioRootPath); });
+        return false;
     }
 
-    mode_ = mode;
-    if (resetPosition) {
-        songIndex_ = 0;
-        transitionIndex_ = 0;
-        adIndex_ = 0;
-        songsSinceAd_ = 0;
-        resumePositionMs_ = 0;
+    if (libraryScanRunning_) {
+        libraryScanQueued_ = true;
+        return true;
     }
 
-    if (mode_ == PlaybackMode::Station) {
-        previousWasSong_ = true;
+    // A finished scan thread only returns after posting its install command, so joining here
+    // never waits on mutex_.
+    if (libraryScanThread_.joinable()) {
+        libraryScanThread_.join();
     }
 
-    if (channel.isStream) {
-        resumePositionMs_ = 0;
-        return playStreamLocked(channel.streamUrl);
+    libraryScanRunning_ = true;
+    libraryScanQueued_ = false;
+    // A full scan sees every change the watcher has reported so far.
+    pendingLibraryChanges_.clear();
+    try {
+        libraryScanThread_ = std::thread(
+            &RadioEngine::libraryScanThreadMain,
+            this,
+            libraryScanSettingsLocked(),
+            std::exchange(libraryRelistPending_, false) ? std::map<std::string, LibraryIndexEntry>{} : libraryIndex_);
+    } catch (const std::system_error& ex) {
+        libraryScanRunning_ = false;
+        logger_.warn([&]() { return std::string("Library rescan thread could not start: ") + ex.what(); });
+        return false;
     }
+    return true;
+}
 
-    if (!resetPosition && !currentTrackPath_.empty()) {
-        return playPathLocked(currentTrackPath_);
+void RadioEngine::libraryScanThreadMain(
+    LibraryScanSettings settings,
+    std::map<std::string, LibraryIndexEntry> previousIndex)
+{
+    auto snapshot = std::make_shared<LibrarySnapshot>(
+        buildLibrarySnapshot(settings, previousIndex, logger_, libraryScanStop_));
+    if (snapshot->indexDirty && !libraryScanStop_.load(std::memory_order_relaxed)) {
+        (void)writeLibraryIndexFile(settings, snapshot->index, logger_);
     }
 
-    const auto track = chooseCurrentTrackLocked();
-    if (!track.has_value()) {
-        logger_.warn("startCurrent failed. Could not determine track.");
-        return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (libraryScanStop_.load(std::memory_order_relaxed) || !workerRunning_) {
+        libraryScanRunning_ = false;
+        return;
     }
 
-    return playPathLocked(*track);
+    QueuedCommand task;
+    task.kind = CommandKind::Task;
+    task.enqueuedAt = std::chrono::steady_clock::now();
+    task.command = [this, snapshot]() {
+        std::lock_guard<std::mutex> installLock(mutex_);
+        installLibrarySnapshotLocked(std::move(*snapshot));
+        libraryScanRunning_ = false;
+        logger_.info([&]() { return "Library rescan complete. Channels: " + std::to_string(channels_.size()); });
+        continueLibraryScansLocked();
+        (void)maybeFlushPersistentSessionLocked();
+        return true;
+    };
+    commandQueue_.push_back(std::move(task));
+    cv_.notify_all();
 }
 
-bool RadioEngine::playPathLocked(const std::filesystem::path& filePath)
+void RadioEngine::requestLibraryUpdateLocked(std::set<std::filesystem::path> sources)
 {
-    stopPlaybackDeviceLocked(true);
-    if (!waitForAliasClosedLocked(std::chrono::milliseconds(150))) {
-        logger_.warn("MCI alias still open before file play. Attempting reopen anyway.");
+    pendingLibraryChanges_.merge(sources);
+    // A running scan or update picks the changes up when it installs.
+    if (!workerRunning_ || libraryScanRunning_ || pendingLibraryChanges_.empty()) {
+        return;
     }
 
-    const std::wstring quotedPath = quoteForMCI(filePath);
-    bool opened = mciCommandLocked(L"open " + quotedPath + L" alias " + kAlias);
-    if (!opened) {
-        opened = mciCommandLocked(L"open " + quotedPath + L" type mpegvideo alias " + kAlias);
+    if (libraryScanThread_.joinable()) {
+        libraryScanThread_.join();
     }
-    if (!opened) {
-        logger_.warn("MCI local open failed. Trying Media Foundation fallback for: " + pathToUtf8(filePath));
-        if (!startMediaFoundationStreamLocked(pathToUtf8(filePath), true)) {
-            state_ = PlaybackState::Stopped;
-            currentTrackPath_.clear();
-            lastVolume_ = -1;
-            lastLeftVolume_ = -1;
-            lastRightVolume_ = -1;
-            trackStartValid_ = false;
-            return false;
-        }
 
-        currentTrackPath_ = filePath;
-        backend_ = PlaybackBackend::MediaFoundationStream;
-        state_ = PlaybackState::Playing;
-        trackStartTime_ = std::chrono::steady_clock::now();
-        trackStartValid_ = true;
-        stopFxLocked();
-        lastVolume_ = -1;
-        lastLeftVolume_ = -1;
-        lastRightVolume_ = -1;
-        if (resumePositionMs_ >= kResumeSeekMinimumMs) {
-            (void)seekCurrentPlaybackLocked(resumePositionMs_);
-        }
-        updateFadeVolumeLocked();
-        logger_.info("Now playing (Media Foundation fallback): " + pathToUtf8(filePath));
-        return true;
+    libraryScanRunning_ = true;
+    try {
+        libraryScanThread_ = std::thread(
+            &RadioEngine::libraryUpdateThreadMain,
+            this,
+            libraryScanSettingsLocked(),
+            pendingLibraryChanges_,
+            libraryIndex_);
+    } catch (const std::system_error& ex) {
+        // The changes stay pending, so the next watcher report or finished scan retries them.
+        libraryScanRunning_ = false;
+        logger_.warn([&]() { return std::string("Library update thread could not start: ") + ex.what(); });
+        return;
     }
+    pendingLibraryChanges_.clear();
+}
 
-    (void)mciCommandLocked(L"set " + std::wstring(kAlias) + L" time format milliseconds");
-    std::wstring playCommand = L"play " + std::wstring(kAlias);
-    if (resumePositionMs_ >= kResumeSeekMinimumMs) {
-        playCommand += L" from " + std::to_wstring(resumePositionMs_);
-    }
-    if (!mciCommandLocked(playCommand)) {
-        (void)mciCommandLocked(L"close " + std::wstring(kAlias));
-        state_ = PlaybackState::Stopped;
-        currentTrackPath_.clear();
-        lastVolume_ = -1;
-        lastLeftVolume_ = -1;
-        lastRightVolume_ = -1;
-        trackStartValid_ = false;
-        return false;
+void RadioEngine::continueLibraryScansLocked()
+{
+    if (libraryScanQueued_) {
+        (void)requestLibraryRescanLocked();
+    } else if (!pendingLibraryChanges_.empty()) {
+        requestLibraryUpdateLocked({});
+    } else {
+        flushLibraryAnalysisLocked();
     }
-
-    currentTrackPath_ = filePath;
-    backend_ = PlaybackBackend::MCI;
-    state_ = PlaybackState::Playing;
-    trackStartTime_ = std::chrono::steady_clock::now();
-    trackStartValid_ = true;
-    stopFxLocked();
-    lastVolume_ = -1;
-    lastLeftVolume_ = -1;
-    lastRightVolume_ = -1;
-    updateFadeVolumeLocked();
-
-    logger_.info("Now playing: " + pathToUtf8(filePath));
-    return true;
 }
 
-bool RadioEngine::playFxLocked(const std::filesystem::path& filePath)
+// With the watcher running, library changes arrive on their own; the on-demand rescans that
+// commands used to trigger would only repeat that work.
+bool RadioEngine::rescanOnDemandLocked() const
 {
-    stopFxLocked();
+    return config_.autoRescanOnChangePlaylist && !libraryWatcher_;
+}
 
-    const std::wstring quotedPath = quoteForMCI(filePath);
-    bool opened = mciCommandLocked(L"open " + quotedPath + L" alias " + kFxAlias);
-    if (!opened) {
-        opened = mciCommandLocked(L"open " + quotedPath + L" type mpegvideo alias " + kFxAlias);
-    }
-    if (!opened) {
-        return false;
+void RadioEngine::libraryUpdateThreadMain(
+    LibraryScanSettings settings,
+    std::set<std::filesystem::path> sources,
+    std::map<std::string, LibraryIndexEntry> previousIndex)
+{
+    auto update = std::make_shared<LibraryUpdate>(buildLibraryUpdate(settings, sources, previousIndex));
+    if (!update->index.empty() && !libraryScanStop_.load(std::memory_order_relaxed)) {
+        for (const auto& [key, entry] : update->index) {
+            if (entry.has_value()) {
+                previousIndex[key] = *entry;
+            } else {
+                previousIndex.erase(key);
+            }
+        }
+        (void)writeLibraryIndexFile(settings, previousIndex, logger_);
     }
 
-    if (!mciCommandLocked(L"play " + std::wstring(kFxAlias))) {
-        (void)mciCommandLocked(L"close " + std::wstring(kFxAlias));
-        return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (libraryScanStop_.load(std::memory_order_relaxed) || !workerRunning_) {
+        libraryScanRunning_ = false;
+        return;
     }
 
-    return true;
+    QueuedCommand task;
+    task.kind = CommandKind::Task;
+    task.enqueuedAt = std::chrono::steady_clock::now();
+    task.command = [this, update]() {
+        std::lock_guard<std::mutex> installLock(mutex_);
+        const std::size_t changedCount = update->changedKeys.size();
+        installLibraryUpdateLocked(std::move(*update));
+        libraryScanRunning_ = false;
+        if (changedCount > 0) {
+            logger_.info([&]() {
+                return "Library update applied to " + std::to_string(changedCount) +
+                       " source(s). Channels: " + std::to_string(channels_.size());
+            });
+        }
+        continueLibraryScansLocked();
+        (void)maybeFlushPersistentSessionLocked();
+        return true;
+    };
+    commandQueue_.push_back(std::move(task));
+    cv_.notify_all();
 }
 
-void RadioEngine::stopFxLocked()
+void RadioEngine::startLibraryWatcherLocked()
 {
-    (void)mciSendStringW((L"stop " + std::wstring(kFxAlias)).c_str(), nullptr, 0, nullptr);
-    (void)mciSendStringW((L"close " + std::wstring(kFxAlias)).c_str(), nullptr, 0, nullptr);
+    if (!config_.watchLibrary || libraryWatcher_ || !workerRunning_ || stopWorker_) {
+        return;
+    }
+
+    libraryWatcher_ = LibraryWatcher::start(
+        logger_,
+        config_.radioRootPath,
+        std::chrono::milliseconds(config_.libraryWatchDebounceMs),
+        [this](LibraryWatcher::Changes changes) {
+            onLibraryChanges(std::move(changes));
+        });
+    if (libraryWatcher_) {
+        logger_.info("Library watcher started; folder changes apply without a rescan.");
+    }
 }
 
-std::optional<std::filesystem::path> RadioEngine::findFxPathLocked(const std::string& fxBasename)
+void RadioEngine::onLibraryChanges(LibraryWatcher::Changes changes)
 {
-    const std::string key = toLower(trim(fxBasename));
-    if (key.empty()) {
-        return std::nullopt;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!workerRunning_ || stopWorker_) {
+        return;
     }
-
-    auto it = fxFiles_.find(key);
-    if (it != fxFiles_.end()) {
-        return it->second;
+    if (changes.rescanAll) {
+        (void)requestLibraryRescanLocked();
+    } else {
+        requestLibraryUpdateLocked(std::move(changes.sources));
     }
+}
 
-    if (config_.autoRescanOnChangePlaylist) {
-        (void)scanLibraryLocked();
-        it = fxFiles_.find(key);
-        if (it != fxFiles_.end()) {
-            return it->second;
+void RadioEngine::carryTrackAnalysis(LibraryIndexEntry& target, const LibraryIndexEntry& source)
+{
+    if (source.analysis.empty()) {
+        return;
+    }
+    for (const auto* names : { &target.songs, &target.transitions, &target.ads }) {
+        for (const auto& name : *names) {
+            const auto analysisIt = source.analysis.find(name);
+            if (analysisIt != source.analysis.end()) {
+                (void)target.analysis.try_emplace(name, analysisIt->second);
+            }
         }
     }
-
-    return std::nullopt;
 }
 
-bool RadioEngine::ensureMediaFoundationLocked()
+// keys limits the queue to those index entries; null queues the whole library.
+void RadioEngine::scheduleLibraryAnalysisLocked(const std::set<std::string>* keys)
 {
-    if (!mfState_) {
-        mfState_ = std::make_unique<MfState>();
+    if (config_.libraryAnalysisThreads <= 0 || !workerRunning_) {
+        return;
+    }
+    if (!analyzer_) {
+        analyzer_ = std::make_unique<LibraryAnalyzer>(logger_);
+        analyzer_->start(static_cast<std::size_t>(config_.libraryAnalysisThreads), [this]() {
+            onLibraryAnalysisReady();
+        });
     }
 
-    if (!mfState_->comInitialized) {
-        const HRESULT coHr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-        if (SUCCEEDED(coHr)) {
-            mfState_->comInitialized = true;
-            mfState_->ownsComInitialization = true;
-        } else if (coHr == RPC_E_CHANGED_MODE) {
-            mfState_->comInitialized = true;
-            mfState_->ownsComInitialization = false;
+    // The pool skips files whose write time still matches the cache, so a changed directory can
+    // queue all of its files without decoding the ones that were left alone.
+    std::vector<LibraryAnalyzer::Job> jobs;
+    const auto queueEntry = [this, &jobs](const std::string& key, const LibraryIndexEntry& entry) {
+        std::filesystem::path directoryPath;
+        if (key.starts_with("playlist/")) {
+            directoryPath = config_.radioRootPath / "Playlists" / std::filesystem::path(utf8ToWide(entry.name));
+        } else if (key.starts_with("station/")) {
+            directoryPath = config_.radioRootPath / "Stations" / std::filesystem::path(utf8ToWide(entry.name));
         } else {
-            logger_.warn("Media Foundation unavailable: CoInitializeEx failed: " + formatHresult(coHr));
-            return false;
+            return;
         }
-    }
 
-    if (!mfState_->mfInitialized) {
-        const HRESULT mfHr = MFStartup(MF_VERSION, MFSTARTUP_LITE);
-        if (FAILED(mfHr)) {
-            logger_.warn("Media Foundation startup failed: " + formatHresult(mfHr));
-            return false;
+        for (const auto* names : { &entry.songs, &entry.transitions, &entry.ads }) {
+            for (const auto& name : *names) {
+                const auto analysisIt = entry.analysis.find(name);
+                LibraryAnalyzer::Job job;
+                job.indexKey = key;
+                job.fileName = name;
+                job.path = directoryPath / std::filesystem::path(utf8ToWide(name));
+                job.cachedWriteTime = analysisIt != entry.analysis.end() ? analysisIt->second.fileWriteTime : 0;
+                jobs.push_back(std::move(job));
+            }
+        }
+    };
+
+    if (keys == nullptr) {
+        for (const auto& [key, entry] : libraryIndex_) {
+            queueEntry(key, entry);
+        }
+    } else {
+        for (const auto& key : *keys) {
+            const auto entryIt = libraryIndex_.find(key);
+            if (entryIt != libraryIndex_.end()) {
+                queueEntry(entryIt->first, entryIt->second);
+            }
         }
-        mfState_->mfInitialized = true;
     }
+    analyzer_->submit(std::move(jobs));
+}
 
-    if (!mfState_->callback) {
-        mfState_->events = std::make_shared<MfEventState>();
-        mfState_->callback.Attach(new MfPlayerCallback(mfState_->events));
+void RadioEngine::onLibraryAnalysisReady()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!workerRunning_ || stopWorker_ || analysisMergeQueued_) {
+        return;
     }
 
-    return true;
+    analysisMergeQueued_ = true;
+    QueuedCommand task;
+    task.kind = CommandKind::Task;
+    task.enqueuedAt = std::chrono::steady_clock::now();
+    task.command = [this]() {
+        std::lock_guard<std::mutex> mergeLock(mutex_);
+        mergeLibraryAnalysisLocked();
+        return true;
+    };
+    commandQueue_.push_back(std::move(task));
+    cv_.notify_all();
 }
 
-bool RadioEngine::startMediaFoundationStreamLocked(const std::string& streamUrl, bool detailedLogs)
+void RadioEngine::mergeLibraryAnalysisLocked()
 {
-    if (isPlayInterruptRequested()) {
-        return false;
+    analysisMergeQueued_ = false;
+    if (!analyzer_) {
+        return;
     }
 
-    if (!ensureMediaFoundationLocked()) {
-        return false;
+    const std::vector<LibraryAnalyzer::Result> results = analyzer_->takeResults();
+    for (const auto& result : results) {
+        // A rescan may have dropped the folder since the job was queued.
+        const auto indexIt = libraryIndex_.find(result.indexKey);
+        if (indexIt == libraryIndex_.end()) {
+            continue;
+        }
+        indexIt->second.analysis[result.fileName] = result.analysis;
+        libraryAnalysisDirty_ = true;
     }
-    if (!mfState_ || !mfState_->callback) {
-        return false;
+    if (!results.empty()) {
+        analysisLookupPath_.clear();
+        liveTimelines_.clear();
+        logger_.info([&]() { return "Library analysis: merged " + std::to_string(results.size()) + " result(s)."; });
     }
 
-    if (mfState_->player) {
-        (void)mfState_->player->Stop();
-        (void)mfState_->player->Shutdown();
-        mfState_->player.Reset();
+    flushLibraryAnalysisLocked();
+}
+
+void RadioEngine::flushLibraryAnalysisLocked()
+{
+    // Saved once the pool drains, from a copy on the scan thread slot: scans and updates write the
+    // same file there, so the writes never overlap. A busy slot flushes when its work completes.
+    if (!libraryAnalysisDirty_ || libraryScanRunning_ || !workerRunning_ || !analyzer_ || !analyzer_->idle()) {
+        return;
     }
 
-    mfState_->events->lastError.store(S_OK);
-    mfState_->events->playbackEnded.store(false);
+    if (libraryScanThread_.joinable()) {
+        libraryScanThread_.join();
+    }
 
-    const std::wstring wideUrl = utf8ToWide(streamUrl);
-    if (wideUrl.empty()) {
-        if (detailedLogs) {
-            logger_.warn("Media Foundation stream open failed: URL conversion to UTF-16 returned empty.");
-        }
-        return false;
+    libraryAnalysisDirty_ = false;
+    libraryScanRunning_ = true;
+    try {
+        libraryScanThread_ = std::thread(&RadioEngine::libraryIndexWriteThreadMain, this, libraryScanSettingsLocked(), libraryIndex_);
+    } catch (const std::system_error& ex) {
+        libraryScanRunning_ = false;
+        libraryAnalysisDirty_ = true;
+        logger_.warn([&]() { return std::string("Library index write thread could not start: ") + ex.what(); });
     }
+}
 
-    const HRESULT createHr = MFPCreateMediaPlayer(
-        wideUrl.c_str(),
-        FALSE,
-        MFP_OPTION_FREE_THREADED_CALLBACK,
-        mfState_->callback.Get(),
-        nullptr,
-        mfState_->player.ReleaseAndGetAddressOf());
-    if (FAILED(createHr) || !mfState_->player) {
-        if (detailedLogs) {
-            logger_.warn("Media Foundation could not open stream: " + streamUrl +
-                         " | hr=" + formatHresult(createHr));
-        }
-        return false;
+void RadioEngine::libraryIndexWriteThreadMain(LibraryScanSettings settings, std::map<std::string, LibraryIndexEntry> index)
+{
+    (void)writeLibraryIndexFile(settings, index, logger_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (libraryScanStop_.load(std::memory_order_relaxed) || !workerRunning_) {
+        libraryScanRunning_ = false;
+        return;
     }
 
-    const HRESULT playHr = mfState_->player->Play();
-    if (FAILED(playHr)) {
-        if (detailedLogs) {
-            logger_.warn("Media Foundation Play failed for stream: " + streamUrl +
-                         " | hr=" + formatHresult(playHr));
+    // The slot is released on the worker, which may join this thread to start the next one.
+    QueuedCommand task;
+    task.kind = CommandKind::Task;
+    task.enqueuedAt = std::chrono::steady_clock::now();
+    task.command = [this]() {
+        std::lock_guard<std::mutex> releaseLock(mutex_);
+        libraryScanRunning_ = false;
+        continueLibraryScansLocked();
+        return true;
+    };
+    commandQueue_.push_back(std::move(task));
+    cv_.notify_all();
+}
+
+const TrackAnalysis* RadioEngine::currentTrackAnalysisLocked()
+{
+    if (currentTrackPath_ != analysisLookupPath_) {
+        analysisLookupPath_ = currentTrackPath_;
+        analysisLookup_.reset();
+        const auto indexIt = libraryIndex_.find(selectedKey_);
+        if (indexIt != libraryIndex_.end() && !currentTrackPath_.empty()) {
+            const auto analysisIt = indexIt->second.analysis.find(pathToUtf8(currentTrackPath_.filename()));
+            if (analysisIt != indexIt->second.analysis.end()) {
+                analysisLookup_ = analysisIt->second;
+            }
         }
-        (void)mfState_->player->Shutdown();
-        mfState_->player.Reset();
-        return false;
+    }
+    return analysisLookup_.has_value() ? &*analysisLookup_ : nullptr;
+}
+
+double RadioEngine::trackNormalizationGainLocked()
+{
+    if (!config_.loudnessNormalization ||
+        (backend_ != PlaybackBackend::MCI && backend_ != PlaybackBackend::NativeMixer)) {
+        return 1.0;
     }
 
-    const auto deadline = std::chrono::steady_clock::now() + kStreamStartWaitTimeout;
-    MFP_MEDIAPLAYER_STATE lastState = MFP_MEDIAPLAYER_STATE_EMPTY;
-    while (std::chrono::steady_clock::now() < deadline) {
-        if (isPlayInterruptRequested()) {
-            (void)mfState_->player->Stop();
-            (void)mfState_->player->Shutdown();
-            mfState_->player.Reset();
-            return false;
+    const TrackAnalysis* analysis = currentTrackAnalysisLocked();
+    if (analysis == nullptr || !analysis->hasLoudness) {
+        return 1.0;
+    }
+    const double gainDb = std::clamp(
+        static_cast<double>(config_.loudnessTargetLufs) - static_cast<double>(analysis->loudnessLufs),
+        kMinNormalizationGainDb,
+        kMaxNormalizationGainDb);
+    return std::pow(10.0, gainDb / 20.0);
+}
+
+void RadioEngine::addFxFilesFromIndexEntry(
+    std::map<std::string, std::filesystem::path>& fxFiles,
+    const LibraryIndexEntry& indexEntry,
+    const std::filesystem::path& fxRoot)
+{
+    for (const auto& name : indexEntry.songs) {
+        const std::filesystem::path filePath = fxRoot / std::filesystem::path(utf8ToWide(name));
+        const std::string fileNameLower = toLower(name);
+        const std::string stemLower = toLower(pathToUtf8(filePath.stem()));
+        if (!fileNameLower.empty() && !fxFiles.contains(fileNameLower)) {
+            fxFiles[fileNameLower] = filePath;
+        }
+        if (!stemLower.empty() && !fxFiles.contains(stemLower)) {
+            fxFiles[stemLower] = filePath;
         }
+    }
+}
 
-        const HRESULT asyncHr = mfState_->events->lastError.load();
-        if (FAILED(asyncHr)) {
-            if (detailedLogs) {
-                logger_.warn("Media Foundation stream error: " + streamUrl +
-                             " | hr=" + formatHresult(asyncHr));
-            }
-            (void)mfState_->player->Stop();
-            (void)mfState_->player->Shutdown();
-            mfState_->player.Reset();
-            return false;
+RadioEngine::ChannelEntry RadioEngine::channelFromIndexEntry(
+    const LibraryIndexEntry& indexEntry,
+    const std::filesystem::path& directoryPath,
+    ChannelType channelType)
+{
+    const auto toTracks = [&directoryPath](const std::vector<std::string>& names, TrackKind kind) {
+        std::vector<std::wstring> wideNames;
+        wideNames.reserve(names.size());
+        std::size_t nameChars = 0;
+        for (const auto& name : names) {
+            wideNames.push_back(utf8ToWide(name));
+            nameChars += wideNames.back().size();
         }
 
-        MFP_MEDIAPLAYER_STATE playerState = MFP_MEDIAPLAYER_STATE_EMPTY;
-        const HRESULT stateHr = mfState_->player->GetState(&playerState);
-        if (SUCCEEDED(stateHr)) {
-            lastState = playerState;
-            if (playerState == MFP_MEDIAPLAYER_STATE_PLAYING || playerState == MFP_MEDIAPLAYER_STATE_PAUSED) {
-                return true;
-            }
-            if (playerState == MFP_MEDIAPLAYER_STATE_SHUTDOWN) {
-                if (detailedLogs) {
-                    logger_.warn("Media Foundation stream state is shutdown: " + streamUrl);
-                }
-                (void)mfState_->player->Shutdown();
-                mfState_->player.Reset();
-                return false;
-            }
+        TrackList tracks(directoryPath, kind);
+        tracks.reserve(names.size(), nameChars);
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            tracks.append(wideNames[i], names[i]);
         }
+        tracks.finalize();
+        return tracks;
+    };
 
-        std::this_thread::sleep_for(kStreamStartPoll);
-    }
+    ChannelEntry entry;
+    entry.key = indexEntry.key;
+    entry.displayName = indexEntry.name;
+    entry.directoryPath = directoryPath;
+    entry.type = channelType;
+    entry.songs = toTracks(indexEntry.songs, TrackKind::Song);
+    entry.transitions = toTracks(indexEntry.transitions, TrackKind::Transition);
+    entry.ads = toTracks(indexEntry.ads, TrackKind::Ad);
+    return entry;
+}
 
-    MFP_MEDIAPLAYER_STATE finalState = MFP_MEDIAPLAYER_STATE_EMPTY;
-    const HRESULT finalStateHr = mfState_->player->GetState(&finalState);
-    const HRESULT finalAsyncHr = mfState_->events->lastError.load();
-    if (SUCCEEDED(finalStateHr) &&
-        (finalState == MFP_MEDIAPLAYER_STATE_PLAYING || finalState == MFP_MEDIAPLAYER_STATE_PAUSED)) {
-        return true;
-    }
+std::filesystem::path RadioEngine::libraryIndexPathLocked() const
+{
+    return libraryIndexPath(config_.radioRootPath);
+}
 
-    if (SUCCEEDED(finalStateHr)) {
-        lastState = finalState;
-    }
-    if (detailedLogs) {
-        logger_.warn("Media Foundation stream did not enter PLAYING state in time: " + streamUrl +
-                     " | state=" + mfStateName(lastState) +
-                     " | lastHr=" + formatHresult(finalAsyncHr));
-    }
-    (void)mfState_->player->Stop();
-    (void)mfState_->player->Shutdown();
-    mfState_->player.Reset();
-    return false;
+std::filesystem::path RadioEngine::libraryIndexPath(const std::filesystem::path& radioRootPath)
+{
+    return radioRootPath / kLibraryIndexFileName;
 }
 
-void RadioEngine::shutdownMediaFoundationLocked()
+bool RadioEngine::loadLibraryIndexLocked()
 {
-    if (!mfState_) {
-        return;
+    libraryIndex_.clear();
+
+    const auto path = libraryIndexPathLocked();
+    if (!std::filesystem::exists(path)) {
+        return false;
     }
 
-    if (mfState_->player) {
-        (void)mfState_->player->Stop();
-        (void)mfState_->player->Shutdown();
-        mfState_->player.Reset();
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        logger_.warn([&]() { return "Could not open library index: " + pathToUtf8(path); });
+        return false;
     }
 
-    mfState_->callback.Reset();
-    mfState_->events.reset();
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+    if (text.empty()) {
+        return false;
+    }
 
-    if (mfState_->mfInitialized) {
-        (void)MFShutdown();
-        mfState_->mfInitialized = false;
+    // The header fields precede the directories array, so these lookups never hit per-folder data.
+    const auto directoriesPos = text.find("\"directories\"");
+    const std::string header = text.substr(0, directoriesPos);
+    const bool matchesConfig =
+        jsonFieldInt(header, "version").value_or(0) == 1 &&
+        jsonFieldString(header, "root_path").value_or(std::string{}) == pathToUtf8(config_.radioRootPath) &&
+        jsonFieldString(header, "transition_prefix").value_or(std::string{}) == config_.transitionPrefix &&
+        jsonFieldString(header, "ad_prefix").value_or(std::string{}) == config_.adPrefix;
+    if (!matchesConfig) {
+        logger_.info("Library index ignored: root path or prefixes changed since it was written.");
+        return false;
     }
 
-    if (mfState_->comInitialized && mfState_->ownsComInitialization) {
-        CoUninitialize();
-        mfState_->comInitialized = false;
-        mfState_->ownsComInitialization = false;
+    for (const auto& object : jsonObjectArrayEntries(text, "directories")) {
+        LibraryIndexEntry entry;
+        entry.key = jsonFieldString(object, "key").value_or(std::string{});
+        entry.name = jsonFieldString(object, "name").value_or(std::string{});
+        entry.directoryWriteTime = jsonFieldInt(object, "write_time").value_or(0);
+        if (entry.key.empty() || entry.name.empty()) {
+            continue;
+        }
+
+        entry.songs = jsonFieldStringArray(object, "songs");
+        entry.transitions = jsonFieldStringArray(object, "transitions");
+        entry.ads = jsonFieldStringArray(object, "ads");
+        for (const auto& analysisObject : jsonObjectArrayEntries(object, "analysis")) {
+            const auto fileName = jsonFieldString(analysisObject, "file");
+            if (!fileName.has_value() || fileName->empty()) {
+                continue;
+            }
+            TrackAnalysis analysis;
+            analysis.fileWriteTime = jsonFieldInt(analysisObject, "write_time").value_or(0);
+            analysis.durationMs = static_cast<std::uint64_t>(std::max<long long>(0, jsonFieldInt(analysisObject, "duration_ms").value_or(0)));
+            const auto lufs = jsonFieldDouble(analysisObject, "lufs");
+            analysis.hasLoudness = lufs.has_value();
+            analysis.loudnessLufs = static_cast<float>(lufs.value_or(0.0));
+            entry.analysis[*fileName] = analysis;
+        }
+        libraryIndex_[entry.key] = std::move(entry);
     }
+
+    return !libraryIndex_.empty();
 }
 
-bool RadioEngine::startDirectShowStreamLocked(const std::string& streamUrl, bool detailedLogs)
+bool RadioEngine::writeLibraryIndexFile(
+    const LibraryScanSettings& settings,
+    const std::map<std::string, LibraryIndexEntry>& index,
+    Logger& logger)
 {
-    if (isPlayInterruptRequested()) {
+    std::error_code ec;
+    std::filesystem::create_directories(settings.radioRootPath, ec);
+    if (ec) {
+        logger.warn("Could not create library index directory: " + pathToUtf8(settings.radioRootPath));
         return false;
     }
 
-    HRESULT coHr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-    const bool needsUninit = SUCCEEDED(coHr);
-    if (coHr == RPC_E_CHANGED_MODE) {
-        coHr = S_OK;
-    }
-    if (FAILED(coHr)) {
-        if (detailedLogs) {
-            logger_.warn("DirectShow unavailable: CoInitializeEx failed: " + formatHresult(coHr));
-        }
+    const auto writeNames = [](std::ostringstream& out, const std::vector<std::string>& names) {
+        out << "[";
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (i > 0) {
+                out << ", ";
+            }
+            out << "\"" << jsonEscape(names[i]) << "\"";
+        }
+        out << "]";
+    };
+
+    std::ostringstream out;
+    out << "{\n  \"version\": 1,\n";
+    out << "  \"root_path\": \"" << jsonEscape(pathToUtf8(settings.radioRootPath)) << "\",\n";
+    out << "  \"transition_prefix\": \"" << jsonEscape(settings.transitionPrefix) << "\",\n";
+    out << "  \"ad_prefix\": \"" << jsonEscape(settings.adPrefix) << "\",\n";
+    out << "  \"directories\": [";
+
+    bool wroteAny = false;
+    for (const auto& [key, entry] : index) {
+        out << (wroteAny ? ",\n" : "\n");
+        wroteAny = true;
+
+        out << "    {\n";
+        out << "      \"key\": \"" << jsonEscape(key) << "\",\n";
+        out << "      \"name\": \"" << jsonEscape(entry.name) << "\",\n";
+        out << "      \"write_time\": " << entry.directoryWriteTime << ",\n";
+        out << "      \"songs\": ";
+        writeNames(out, entry.songs);
+        out << ",\n      \"transitions\": ";
+        writeNames(out, entry.transitions);
+        out << ",\n      \"ads\": ";
+        writeNames(out, entry.ads);
+        out << ",\n      \"analysis\": [";
+        bool wroteAnalysis = false;
+        for (const auto& [fileName, analysis] : entry.analysis) {
+            out << (wroteAnalysis ? ", " : "") << "{\"file\": \"" << jsonEscape(fileName) << "\", \"write_time\": "
+                << analysis.fileWriteTime << ", \"duration_ms\": " << analysis.durationMs;
+            if (analysis.hasLoudness) {
+                out << ", \"lufs\": " << analysis.loudnessLufs;
+            }
+            out << "}";
+            wroteAnalysis = true;
+        }
+        out << "]\n    }";
+    }
+
+    if (wroteAny) {
+        out << "\n";
+    }
+    out << "  ]\n}\n";
+
+    const auto path = libraryIndexPath(settings.radioRootPath);
+    if (!writeTextFileAtomically(path, out.str(), logger)) {
+        logger.warn("Could not save library index: " + pathToUtf8(path));
+        return false;
+    }
+
+    logger.info("Saved library index: " + pathToUtf8(path));
+    return true;
+}
+
+bool RadioEngine::loadLibraryFromIndexLocked()
+{
+    channels_.clear();
+    fxFiles_.clear();
+    streamOrderKeys_.clear();
+
+    for (const auto& [key, entry] : libraryIndex_) {
+        if (key == kFxIndexKey) {
+            addFxFilesFromIndexEntry(fxFiles_, entry, config_.radioRootPath / "FX");
+            continue;
+        }
+        if (entry.songs.empty()) {
+            continue;
+        }
+
+        if (key.starts_with("playlist/")) {
+            channels_[key] = channelFromIndexEntry(entry, config_.radioRootPath / "Playlists" / std::filesystem::path(utf8ToWide(entry.name)), ChannelType::Playlist);
+        } else if (key.starts_with("station/")) {
+            channels_[key] = channelFromIndexEntry(entry, config_.radioRootPath / "Stations" / std::filesystem::path(utf8ToWide(entry.name)), ChannelType::Station);
+        }
+    }
+
+    addConfiguredStreamsLocked();
+    rebuildChannelIndexLocked();
+    return !channels_.empty();
+}
+
+void RadioEngine::addConfiguredStreamsLocked()
+{
+    for (const auto& [name, url] : config_.streamStations) {
+        const std::string key = "stream/" + toLower(trim(name));
+        if (key.empty() || url.empty()) {
+            continue;
+        }
+
+        ChannelEntry entry;
+        entry.key = key;
+        entry.displayName = name;
+        entry.type = ChannelType::Station;
+        entry.isStream = true;
+        entry.streamUrl = url;
+
+        if (std::find(streamOrderKeys_.begin(), streamOrderKeys_.end(), key) == streamOrderKeys_.end()) {
+            streamOrderKeys_.push_back(key);
+        }
+        channels_[key] = std::move(entry);
+    }
+}
+
+void RadioEngine::rebuildChannelIndexLocked()
+{
+    channelTable_.clear();
+    channelAliases_.clear();
+    for (auto& handles : channelsByCategory_) {
+        handles.clear();
+    }
+
+    channelTable_.reserve(channels_.size());
+    channelAliases_.reserve(channels_.size() * 4);
+    for (const auto& [key, entry] : channels_) {
+        (void)key;
+        channelTable_.push_back(&entry);
+    }
+    channelCategoryPosition_.assign(channelTable_.size(), 0);
+
+    // Aliases in lookup precedence: exact keys, then unique bare names, then display names (first
+    // in key order). A bare name shared by several sources resolves to nothing, as before.
+    std::vector<std::string> displayAliases(channelTable_.size());
+    for (ChannelHandle handle = 0; handle < channelTable_.size(); ++handle) {
+        const ChannelEntry& entry = *channelTable_[handle];
+        const std::string key = toLower(entry.key);
+        channelAliases_[key] = handle;
+        if (key.starts_with("playlist/")) {
+            channelAliases_["playlists/" + key.substr(std::string("playlist/").size())] = handle;
+        } else if (key.starts_with("station/")) {
+            channelAliases_["stations/" + key.substr(std::string("station/").size())] = handle;
+        }
+        displayAliases[handle] = toLower(entry.displayName);
+    }
+
+    std::unordered_map<std::string, ChannelHandle> bareAliases;
+    for (ChannelHandle handle = 0; handle < channelTable_.size(); ++handle) {
+        const std::string key = toLower(channelTable_[handle]->key);
+        const std::size_t slash = key.find('/');
+        if (slash == std::string::npos) {
+            continue;
+        }
+        const auto [it, inserted] = bareAliases.try_emplace(key.substr(slash + 1), handle);
+        if (!inserted) {
+            it->second = kAmbiguousChannelHandle;
+        }
+    }
+    for (const auto& [alias, handle] : bareAliases) {
+        channelAliases_.try_emplace(alias, handle);
+    }
+    for (ChannelHandle handle = 0; handle < channelTable_.size(); ++handle) {
+        channelAliases_.try_emplace(displayAliases[handle], handle);
+    }
+
+    for (ChannelHandle handle = 0; handle < channelTable_.size(); ++handle) {
+        const ChannelEntry& entry = *channelTable_[handle];
+        if (!entry.isStream) {
+            channelsByCategory_[entry.type == ChannelType::Station ? 1 : 0].push_back(handle);
+        }
+    }
+    for (const auto& key : streamOrderKeys_) {
+        const auto it = channelAliases_.find(key);
+        if (it != channelAliases_.end() && it->second != kAmbiguousChannelHandle && channelTable_[it->second]->isStream) {
+            channelsByCategory_[2].push_back(it->second);
+        }
+    }
+    for (auto& handles : channelsByCategory_) {
+        std::stable_sort(handles.begin(), handles.end(), [&displayAliases](ChannelHandle a, ChannelHandle b) {
+            return displayAliases[a] < displayAliases[b];
+        });
+        for (std::size_t position = 0; position < handles.size(); ++position) {
+            channelCategoryPosition_[handles[position]] = position;
+        }
+    }
+}
+
+const RadioEngine::ChannelEntry* RadioEngine::lookupChannelLocked(const std::string& channelName) const
+{
+    const std::string key = toLower(trim(channelName));
+    if (key.empty()) {
+        return nullptr;
+    }
+
+    const auto it = channelAliases_.find(key);
+    if (it == channelAliases_.end() || it->second == kAmbiguousChannelHandle) {
+        return nullptr;
+    }
+    return channelTable_[it->second];
+}
+
+const std::vector<RadioEngine::ChannelHandle>* RadioEngine::channelsInCategoryLocked(const int category) const
+{
+    if (category < 1 || category > static_cast<int>(channelsByCategory_.size())) {
+        return nullptr;
+    }
+    return &channelsByCategory_[static_cast<std::size_t>(category - 1)];
+}
+
+bool RadioEngine::startCurrentLocked(PlaybackMode mode, bool resetPosition)
+{
+    const auto channelIt = channels_.find(selectedKey_);
+    if (channelIt == channels_.end()) {
+        logger_.warn("startCurrent failed. Selected channel no longer exists.");
+        return false;
+    }
+
+    const auto& channel = channelIt->second;
+    if (channel.songs.empty()) {
+        if (!channel.isStream) {
+            logger_.warn([&]() { return "startCurrent failed. Channel has no songs: " + channel.displayName; });
+            return false;
+        }
+    }
+
+    mode_ = mode;
+    if (resetPosition) {
+        songIndex_ = 0;
+        transitionIndex_ = 0;
+        adIndex_ = 0;
+        songsSinceAd_ = 0;
+        resumePositionMs_ = 0;
+    }
+
+    if (mode_ == PlaybackMode::Station) {
+        previousWasSong_ = true;
+    }
+
+    if (channel.isStream) {
+        resumePositionMs_ = 0;
+        return playStreamLocked(channel.streamUrl);
+    }
+
+    if (liveStationActiveLocked(channel)) {
+        return startLiveStationLocked(channel);
+    }
+
+    if (!resetPosition && !currentTrackPath_.empty()) {
+        return playPathLocked(currentTrackPath_);
+    }
+
+    const auto track = chooseCurrentTrackLocked();
+    if (!track.has_value()) {
+        logger_.warn("startCurrent failed. Could not determine track.");
+        return false;
+    }
+
+    return playPathLocked(*track);
+}
+
+bool RadioEngine::playPathLocked(const std::filesystem::path& filePath)
+{
+    stopPlaybackDeviceLocked(true);
+    if (ensureAudioMixerLocked()) {
+        const auto nativeStartedAt = std::chrono::steady_clock::now();
+        if (playNativeLocked(filePath)) {
+            recordBackendOpen(PlaybackBackend::NativeMixer, nativeStartedAt);
+            return true;
+        }
+        logger_.warn([&]() {
+            return "Native mixer could not play file. Falling back to MCI: " + pathToUtf8(filePath);
+        });
+    }
+
+    if (!waitForAliasClosedLocked(std::chrono::milliseconds(150))) {
+        logger_.warn("MCI alias still open before file play. Attempting reopen anyway.");
+    }
+
+    const auto openStartedAt = std::chrono::steady_clock::now();
+    const std::wstring quotedPath = quoteForMCI(filePath);
+    bool opened = mciCommandLocked(L"open " + quotedPath + L" alias " + activeAlias_);
+    if (!opened) {
+        opened = mciCommandLocked(L"open " + quotedPath + L" type mpegvideo alias " + activeAlias_);
+    }
+    if (!opened) {
+        logger_.warn([&]() {
+            return "MCI local open failed. Trying Media Foundation fallback for: " + pathToUtf8(filePath);
+        });
+        if (!startMediaFoundationStreamLocked(pathToUtf8(filePath), true)) {
+            state_ = PlaybackState::Stopped;
+            currentTrackPath_.clear();
+            lastVolume_ = -1;
+            lastLeftVolume_ = -1;
+            lastRightVolume_ = -1;
+            trackStartValid_ = false;
+            return false;
+        }
+
+        recordBackendOpen(PlaybackBackend::MediaFoundationStream, openStartedAt);
+        currentTrackPath_ = filePath;
+        backend_ = PlaybackBackend::MediaFoundationStream;
+        state_ = PlaybackState::Playing;
+        trackStartTime_ = std::chrono::steady_clock::now();
+        trackStartValid_ = true;
+        stopFxLocked();
+        lastVolume_ = -1;
+        lastLeftVolume_ = -1;
+        lastRightVolume_ = -1;
+        if (resumePositionMs_ >= kResumeSeekMinimumMs) {
+            (void)seekCurrentPlaybackLocked(resumePositionMs_);
+        }
+        updateFadeVolumeLocked();
+        logger_.info([&]() { return "Now playing (Media Foundation fallback): " + pathToUtf8(filePath); });
+        return true;
+    }
+
+    (void)mciCommandLocked(L"set " + activeAlias_ + L" time format milliseconds");
+    std::wstring playCommand = L"play " + activeAlias_;
+    if (resumePositionMs_ >= kResumeSeekMinimumMs) {
+        playCommand += L" from " + std::to_wstring(resumePositionMs_);
+    }
+    if (!mciPlayLocked(playCommand)) {
+        (void)mciCommandLocked(L"close " + activeAlias_);
+        state_ = PlaybackState::Stopped;
+        currentTrackPath_.clear();
+        lastVolume_ = -1;
+        lastLeftVolume_ = -1;
+        lastRightVolume_ = -1;
+        trackStartValid_ = false;
+        return false;
+    }
+
+    recordBackendOpen(PlaybackBackend::MCI, openStartedAt);
+    currentTrackPath_ = filePath;
+    backend_ = PlaybackBackend::MCI;
+    state_ = PlaybackState::Playing;
+    trackStartTime_ = std::chrono::steady_clock::now();
+    trackStartValid_ = true;
+    stopFxLocked();
+    lastVolume_ = -1;
+    lastLeftVolume_ = -1;
+    lastRightVolume_ = -1;
+    updateFadeVolumeLocked();
+
+    logger_.info([&]() { return "Now playing: " + pathToUtf8(filePath); });
+    return true;
+}
+
+bool RadioEngine::ensureAudioMixerLocked()
+{
+    if (!config_.nativeAudioBackend || mixerUnavailable_) {
+        return false;
+    }
+    if (mixer_ && mixer_->ready()) {
+        return true;
+    }
+
+    mixer_ = std::make_unique<AudioMixer>(logger_);
+    const HWND notifyWindow = notifyState_ ? notifyState_->window : nullptr;
+    const bool started = mixer_->initialize([notifyWindow]() {
+        if (notifyWindow != nullptr) {
+            (void)PostMessageW(notifyWindow, kPlaybackEventMessage, 0, 0);
+        }
+    });
+    if (!started) {
+        // Don't retry on every track; MCI keeps working as before.
+        logger_.warn("Native audio backend unavailable. Using MCI for local files.");
+        mixer_.reset();
+        mixerUnavailable_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool RadioEngine::playNativeLocked(const std::filesystem::path& filePath)
+{
+    const std::uint64_t startMs = resumePositionMs_ >= kResumeSeekMinimumMs ? resumePositionMs_ : 0;
+    const AudioMixer::VoiceId voice = mixer_->open(filePath, startMs);
+    if (voice == 0) {
+        return false;
+    }
+
+    mixerVoice_ = voice;
+    backend_ = PlaybackBackend::NativeMixer;
+    currentTrackPath_ = filePath;
+    state_ = PlaybackState::Playing;
+    lastVolume_ = -1;
+    lastLeftVolume_ = -1;
+    lastRightVolume_ = -1;
+    // The voice opens silent; write the fade before it becomes audible.
+    updateFadeVolumeLocked();
+    if (!mixer_->start(voice)) {
+        mixer_->close(voice);
+        mixerVoice_ = 0;
+        backend_ = PlaybackBackend::None;
+        state_ = PlaybackState::Stopped;
+        currentTrackPath_.clear();
+        return false;
+    }
+
+    trackStartTime_ = std::chrono::steady_clock::now();
+    trackStartValid_ = true;
+    stopFxLocked();
+
+    logger_.info([&]() { return "Now playing (native): " + pathToUtf8(filePath); });
+    return true;
+}
+
+bool RadioEngine::playFxLocked(const std::filesystem::path& filePath)
+{
+    stopFxLocked();
+
+    // A decoded clip starts within a few milliseconds; opening the file through MCI or the mixer
+    // costs a decoder spin-up on every trigger.
+    if (fxCache_) {
+        FxCache::Clip clip = fxCache_->find(filePath);
+        if (clip && PlaySoundW(reinterpret_cast<LPCWSTR>(clip->data()), nullptr, SND_MEMORY | SND_ASYNC | SND_NODEFAULT)) {
+            fxClipPlaying_ = std::move(clip);
+            return true;
+        }
+    }
+
+    if (ensureAudioMixerLocked()) {
+        const AudioMixer::VoiceId voice = mixer_->open(filePath, 0);
+        if (voice != 0 && mixer_->setLevelPan(voice, 1.0F, 0.0F) && mixer_->start(voice)) {
+            fxMixerVoice_ = voice;
+            return true;
+        }
+        if (voice != 0) {
+            mixer_->close(voice);
+        }
+    }
+
+    const std::wstring quotedPath = quoteForMCI(filePath);
+    bool opened = mciCommandLocked(L"open " + quotedPath + L" alias " + kFxAlias);
+    if (!opened) {
+        opened = mciCommandLocked(L"open " + quotedPath + L" type mpegvideo alias " + kFxAlias);
+    }
+    if (!opened) {
+        return false;
+    }
+
+    if (!mciCommandLocked(L"play " + std::wstring(kFxAlias))) {
+        (void)mciCommandLocked(L"close " + std::wstring(kFxAlias));
+        return false;
+    }
+
+    return true;
+}
+
+void RadioEngine::stopFxLocked()
+{
+    if (fxClipPlaying_) {
+        (void)PlaySoundW(nullptr, nullptr, 0);
+        fxClipPlaying_.reset();
+    }
+    if (fxMixerVoice_ != 0) {
+        if (mixer_) {
+            mixer_->close(fxMixerVoice_);
+        }
+        fxMixerVoice_ = 0;
+    }
+    (void)mciSend(L"stop " + std::wstring(kFxAlias));
+    (void)mciSend(L"close " + std::wstring(kFxAlias));
+}
+
+void RadioEngine::refreshFxCacheLocked()
+{
+    if (config_.fxCacheMegabytes <= 0 || !workerRunning_) {
+        return;
+    }
+
+    // fxFiles_ maps both "name.ext" and the bare stem to the same file; decode each file once.
+    std::vector<std::filesystem::path> files;
+    files.reserve(fxFiles_.size());
+    for (const auto& [key, path] : fxFiles_) {
+        if (std::find(files.begin(), files.end(), path) == files.end()) {
+            files.push_back(path);
+        }
+    }
+
+    if (!fxCache_) {
+        fxCache_ = std::make_unique<FxCache>(logger_);
+    }
+    fxCache_->load(std::move(files), static_cast<std::size_t>(config_.fxCacheMegabytes) * 1024 * 1024);
+}
+
+std::optional<std::filesystem::path> RadioEngine::findFxPathLocked(const std::string& fxBasename)
+{
+    const std::string key = toLower(trim(fxBasename));
+    if (key.empty()) {
+        return std::nullopt;
+    }
+
+    auto it = fxFiles_.find(key);
+    if (it != fxFiles_.end()) {
+        return it->second;
+    }
+
+    // A miss schedules a background rescan; the FX becomes playable once the new table is installed.
+    if (rescanOnDemandLocked()) {
+        (void)requestLibraryRescanLocked();
+    }
+
+    return std::nullopt;
+}
+
+bool RadioEngine::ensureMediaFoundationLocked()
+{
+    if (!mfState_) {
+        mfState_ = std::make_unique<MfState>();
+    }
+
+    if (!mfState_->comInitialized) {
+        const HRESULT coHr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+        if (SUCCEEDED(coHr)) {
+            mfState_->comInitialized = true;
+            mfState_->ownsComInitialization = true;
+        } else if (coHr == RPC_E_CHANGED_MODE) {
+            mfState_->comInitialized = true;
+            mfState_->ownsComInitialization = false;
+        } else {
+            logger_.warn([&]() {
+                return "Media Foundation unavailable: CoInitializeEx failed: " + formatHresult(coHr);
+            });
+            return false;
+        }
+    }
+
+    if (!mfState_->mfInitialized) {
+        const HRESULT mfHr = MFStartup(MF_VERSION, MFSTARTUP_LITE);
+        if (FAILED(mfHr)) {
+            logger_.warn([&]() { return "Media Foundation startup failed: " + formatHresult(mfHr); });
+            return false;
+        }
+        mfState_->mfInitialized = true;
+    }
+
+    if (!mfState_->callback) {
+        mfState_->events = std::make_shared<MfEventState>();
+        mfState_->events->notifyWindow.store(notifyState_ ? notifyState_->window : nullptr);
+        mfState_->callback.Attach(new MfPlayerCallback(mfState_->events));
+    }
+
+    return true;
+}
+
+bool RadioEngine::startMediaFoundationStreamLocked(const std::string& streamUrl, bool detailedLogs)
+{
+    if (isPlayInterruptRequested()) {
+        return false;
+    }
+
+    if (!ensureMediaFoundationLocked()) {
+        return false;
+    }
+    if (!mfState_ || !mfState_->callback) {
+        return false;
+    }
+
+    if (mfState_->player) {
+        (void)mfState_->player->Stop();
+        (void)mfState_->player->Shutdown();
+        mfState_->player.Reset();
+    }
+
+    mfState_->events->lastError.store(S_OK);
+    mfState_->events->playbackEnded.store(false);
+
+    const std::wstring wideUrl = utf8ToWide(streamUrl);
+    if (wideUrl.empty()) {
+        if (detailedLogs) {
+            logger_.warn("Media Foundation stream open failed: URL conversion to UTF-16 returned empty.");
+        }
+        return false;
+    }
+
+    const HRESULT createHr = MFPCreateMediaPlayer(
+        wideUrl.c_str(),
+        FALSE,
+        MFP_OPTION_FREE_THREADED_CALLBACK,
+        mfState_->callback.Get(),
+        nullptr,
+        mfState_->player.ReleaseAndGetAddressOf());
+    if (FAILED(createHr) || !mfState_->player) {
+        if (detailedLogs) {
+            logger_.warn([&]() {
+                return "Media Foundation could not open stream: " + streamUrl +
+                       " | hr=" + formatHresult(createHr);
+            });
+        }
+        return false;
+    }
+
+    const HRESULT playHr = mfState_->player->Play();
+    if (FAILED(playHr)) {
+        if (detailedLogs) {
+            logger_.warn([&]() {
+                return "Media Foundation Play failed for stream: " + streamUrl +
+                       " | hr=" + formatHresult(playHr);
+            });
+        }
+        (void)mfState_->player->Shutdown();
+        mfState_->player.Reset();
+        return false;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + kStreamStartWaitTimeout;
+    MFP_MEDIAPLAYER_STATE lastState = MFP_MEDIAPLAYER_STATE_EMPTY;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (isPlayInterruptRequested()) {
+            (void)mfState_->player->Stop();
+            (void)mfState_->player->Shutdown();
+            mfState_->player.Reset();
+            return false;
+        }
+
+        const HRESULT asyncHr = mfState_->events->lastError.load();
+        if (FAILED(asyncHr)) {
+            if (detailedLogs) {
+                logger_.warn([&]() {
+                    return "Media Foundation stream error: " + streamUrl +
+                           " | hr=" + formatHresult(asyncHr);
+                });
+            }
+            (void)mfState_->player->Stop();
+            (void)mfState_->player->Shutdown();
+            mfState_->player.Reset();
+            return false;
+        }
+
+        MFP_MEDIAPLAYER_STATE playerState = MFP_MEDIAPLAYER_STATE_EMPTY;
+        const HRESULT stateHr = mfState_->player->GetState(&playerState);
+        if (SUCCEEDED(stateHr)) {
+            lastState = playerState;
+            if (playerState == MFP_MEDIAPLAYER_STATE_PLAYING || playerState == MFP_MEDIAPLAYER_STATE_PAUSED) {
+                return true;
+            }
+            if (playerState == MFP_MEDIAPLAYER_STATE_SHUTDOWN) {
+                if (detailedLogs) {
+                    logger_.warn([&]() { return "Media Foundation stream state is shutdown: " + streamUrl; });
+                }
+                (void)mfState_->player->Shutdown();
+                mfState_->player.Reset();
+                return false;
+            }
+        }
+
+        std::this_thread::sleep_for(kStreamStartPoll);
+    }
+
+    MFP_MEDIAPLAYER_STATE finalState = MFP_MEDIAPLAYER_STATE_EMPTY;
+    const HRESULT finalStateHr = mfState_->player->GetState(&finalState);
+    const HRESULT finalAsyncHr = mfState_->events->lastError.load();
+    if (SUCCEEDED(finalStateHr) &&
+        (finalState == MFP_MEDIAPLAYER_STATE_PLAYING || finalState == MFP_MEDIAPLAYER_STATE_PAUSED)) {
+        return true;
+    }
+
+    if (SUCCEEDED(finalStateHr)) {
+        lastState = finalState;
+    }
+    if (detailedLogs) {
+        logger_.warn([&]() {
+            return "Media Foundation stream did not enter PLAYING state in time: " + streamUrl +
+                   " | state=" + mfStateName(lastState) +
+                   " | lastHr=" + formatHresult(finalAsyncHr);
+        });
+    }
+    (void)mfState_->player->Stop();
+    (void)mfState_->player->Shutdown();
+    mfState_->player.Reset();
+    return false;
+}
+
+void RadioEngine::shutdownMediaFoundationLocked()
+{
+    if (!mfState_) {
+        return;
+    }
+
+    if (mfState_->player) {
+        (void)mfState_->player->Stop();
+        (void)mfState_->player->Shutdown();
+        mfState_->player.Reset();
+    }
+
+    mfState_->callback.Reset();
+    mfState_->events.reset();
+
+    if (mfState_->mfInitialized) {
+        (void)MFShutdown();
+        mfState_->mfInitialized = false;
+    }
+
+    if (mfState_->comInitialized && mfState_->ownsComInitialization) {
+        CoUninitialize();
+        mfState_->comInitialized = false;
+        mfState_->ownsComInitialization = false;
+    }
+}
+
+bool RadioEngine::startDirectShowStreamLocked(const std::string& streamUrl, bool detailedLogs)
+{
+    if (isPlayInterruptRequested()) {
+        return false;
+    }
+
+    HRESULT coHr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    const bool needsUninit = SUCCEEDED(coHr);
+    if (coHr == RPC_E_CHANGED_MODE) {
+        coHr = S_OK;
+    }
+    if (FAILED(coHr)) {
+        if (detailedLogs) {
+            logger_.warn([&]() { return "DirectShow unavailable: CoInitializeEx failed: " + formatHresult(coHr); });
+        }
+        return false;
+    }
+
+    if (!dsState_) {
+        dsState_ = std::make_unique<DsState>();
+    } else {
+        shutdownDirectShowLocked();
+    }
+
+    auto cleanupOnFailure = [this, needsUninit]() {
+        shutdownDirectShowLocked();
+        if (needsUninit) {
+            CoUninitialize();
+        }
+    };
+
+    const HRESULT graphHr = CoCreateInstance(
+        CLSID_FilterGraph,
+        nullptr,
+        CLSCTX_INPROC_SERVER,
+        IID_IGraphBuilder,
+        reinterpret_cast<void**>(dsState_->graph.ReleaseAndGetAddressOf()));
+    if (FAILED(graphHr) || !dsState_->graph) {
+        if (detailedLogs) {
+            logger_.warn([&]() {
+                return "DirectShow graph creation failed for stream: " + streamUrl +
+                       " | hr=" + formatHresult(graphHr);
+            });
+        }
+        cleanupOnFailure();
+        return false;
+    }
+
+    const HRESULT controlHr = dsState_->graph.As(&dsState_->control);
+    const HRESULT eventHr = dsState_->graph.As(&dsState_->events);
+    (void)dsState_->graph.As(&dsState_->audio);
+    if (FAILED(controlHr) || FAILED(eventHr) || !dsState_->control || !dsState_->events) {
+        if (detailedLogs) {
+            logger_.warn([&]() {
+                return "DirectShow interface query failed for stream: " + streamUrl +
+                       " | controlHr=" + formatHresult(controlHr) +
+                       " | eventHr=" + formatHresult(eventHr);
+            });
+        }
+        cleanupOnFailure();
+        return false;
+    }
+
+    const std::wstring wideUrl = utf8ToWide(streamUrl);
+    if (wideUrl.empty()) {
+        if (detailedLogs) {
+            logger_.warn("DirectShow stream open failed: URL conversion to UTF-16 returned empty.");
+        }
+        cleanupOnFailure();
+        return false;
+    }
+
+    if (isPlayInterruptRequested()) {
+        cleanupOnFailure();
+        return false;
+    }
+
+    const HRESULT renderHr = dsState_->graph->RenderFile(wideUrl.c_str(), nullptr);
+    if (FAILED(renderHr)) {
+        if (detailedLogs) {
+            logger_.warn([&]() {
+                return "DirectShow could not render stream: " + streamUrl +
+                       " | hr=" + formatHresult(renderHr);
+            });
+        }
+        cleanupOnFailure();
+        return false;
+    }
+
+    if (isPlayInterruptRequested()) {
+        cleanupOnFailure();
+        return false;
+    }
+
+    const HRESULT runHr = dsState_->control->Run();
+    if (FAILED(runHr)) {
+        if (detailedLogs) {
+            logger_.warn([&]() {
+                return "DirectShow could not run stream: " + streamUrl +
+                       " | hr=" + formatHresult(runHr);
+            });
+        }
+        cleanupOnFailure();
         return false;
     }
 
+    if (needsUninit) {
+        // Keep COM initialized for this thread lifetime; matching uninit happens on shutdown.
+        if (mfState_) {
+            mfState_->comInitialized = true;
+            mfState_->ownsComInitialization = true;
+        }
+    }
+
+    return true;
+}
+
+void RadioEngine::shutdownDirectShowLocked()
+{
+    disarmDirectShowNotifyLocked();
     if (!dsState_) {
-        dsState_ = std::make_unique<DsState>();
+        return;
+    }
+
+    if (dsState_->control) {
+        (void)dsState_->control->Stop();
+    }
+    dsState_->audio.Reset();
+    dsState_->events.Reset();
+    dsState_->control.Reset();
+    dsState_->graph.Reset();
+}
+
+bool RadioEngine::playStreamLocked(const std::string& streamUrl)
+{
+    stopPlaybackDeviceLocked(true);
+
+    const std::string directUrl = trim(streamUrl);
+    if (directUrl.empty()) {
+        logger_.warn("Stream play failed: empty URL.");
+        state_ = PlaybackState::Stopped;
+        currentTrackPath_.clear();
+        resumePositionMs_ = 0;
+        lastVolume_ = -1;
+        lastLeftVolume_ = -1;
+        lastRightVolume_ = -1;
+        trackStartValid_ = false;
+        return false;
+    }
+
+    auto clearStreamState = [this]() {
+        backend_ = PlaybackBackend::None;
+        state_ = PlaybackState::Stopped;
+        currentTrackPath_.clear();
+        resumePositionMs_ = 0;
+        lastVolume_ = -1;
+        lastLeftVolume_ = -1;
+        lastRightVolume_ = -1;
+        trackStartValid_ = false;
+    };
+
+    std::vector<std::string> candidates;
+    auto addCandidate = [&candidates](const std::string& url) {
+        const std::string trimmedUrl = trimAsciiCopy(url);
+        if (trimmedUrl.empty()) {
+            return;
+        }
+        const std::string lowered = toLowerCopy(trimmedUrl);
+        for (const auto& existing : candidates) {
+            if (toLowerCopy(existing) == lowered) {
+                return;
+            }
+        }
+        candidates.push_back(trimmedUrl);
+    };
+
+    // A warm standby player is already buffering this station muted; taking it over is instant.
+    if (const auto promoted = promoteStreamStandbyLocked(directUrl); promoted.has_value()) {
+        markStreamPlayingLocked(PlaybackBackend::MediaFoundationStream, directUrl, promoted->candidate);
+        recordStreamWinnerLocked(directUrl, promoted->resolvedUrl, promoted->candidate, PlaybackBackend::MediaFoundationStream);
+        return true;
+    }
+
+    // Known-good shortcut: replay the candidate and backend that last worked for this configured URL.
+    const auto cacheIt = streamCache_.find(directUrl);
+    if (cacheIt != streamCache_.end() && isStreamCacheEntryFreshLocked(cacheIt->second)) {
+        const StreamResolutionEntry cached = cacheIt->second;
+        if (startStreamBackendLocked(cached.candidate, cached.backend)) {
+            markStreamPlayingLocked(cached.backend, directUrl, cached.candidate);
+            recordStreamWinnerLocked(directUrl, cached.resolvedUrl, cached.candidate, cached.backend);
+            return true;
+        }
+        if (isPlayInterruptRequested()) {
+            clearStreamState();
+            return false;
+        }
+        logger_.info([&]() { return "Cached stream candidate failed, resolving again: " + directUrl; });
+    }
+
+    const auto resolveStartedAt = std::chrono::steady_clock::now();
+    const std::string resolvedUrl = resolvePlayableStreamUrl(
+        internet_,
+        directUrl,
+        logger_,
+        0,
+        [this]() {
+            return isPlayInterruptRequested();
+        });
+    stats_.streamResolve.record(std::chrono::steady_clock::now() - resolveStartedAt);
+    if (isPlayInterruptRequested()) {
+        clearStreamState();
+        return false;
+    }
+    const bool directLooksWrapper = isLikelyWrapperExtension(urlExtensionLower(directUrl));
+    const bool hasResolvedAlternative =
+        !resolvedUrl.empty() && toLower(resolvedUrl) != toLower(directUrl);
+
+    auto addCandidateFamily = [&addCandidate](const std::string& baseUrl) {
+        addCandidate(baseUrl);
+        addCandidate(httpsToHttpVariant(baseUrl));
+        addCandidate(httpToHttpsVariant(baseUrl));
+
+        if (isLikelyWrapperExtension(urlExtensionLower(baseUrl))) {
+            return;
+        }
+        for (const auto& variant : makeShoutcastStyleVariants(baseUrl)) {
+            addCandidate(variant);
+            addCandidate(httpsToHttpVariant(variant));
+            addCandidate(httpToHttpsVariant(variant));
+        }
+    };
+
+    if (!directLooksWrapper || !hasResolvedAlternative) {
+        addCandidateFamily(directUrl);
+    }
+    if (hasResolvedAlternative) {
+        addCandidateFamily(resolvedUrl);
+    }
+    if (candidates.empty()) {
+        addCandidate(directUrl);
+    }
+
+    // Opening a dead mirror costs up to kStreamStartWaitTimeout per backend, so weed those out in parallel first.
+    if (candidates.size() > 1) {
+        candidates = rankStreamCandidatesByProbe(
+            internet_,
+            candidates,
+            logger_,
+            config_.verboseStreamDiagnostics,
+            [this](std::function<void()> probe) {
+                return postStreamProbeLocked(std::move(probe));
+            },
+            [this]() {
+                return isPlayInterruptRequested();
+            });
+        if (isPlayInterruptRequested()) {
+            clearStreamState();
+            return false;
+        }
+    }
+
+    for (const auto& candidate : candidates) {
+        for (const auto backend : { PlaybackBackend::MediaFoundationStream, PlaybackBackend::DirectShowStream }) {
+            if (isPlayInterruptRequested()) {
+                clearStreamState();
+                return false;
+            }
+
+            if (startStreamBackendLocked(candidate, backend)) {
+                markStreamPlayingLocked(backend, directUrl, candidate);
+                recordStreamWinnerLocked(directUrl, resolvedUrl, candidate, backend);
+                return true;
+            }
+        }
+    }
+
+    clearStreamState();
+    if (streamCache_.erase(directUrl) > 0) {
+        (void)saveStreamCacheLocked();
+    }
+    logger_.warn([&]() { return "Stream play failed after all URL attempts: " + directUrl; });
+    return false;
+}
+
+bool RadioEngine::startStreamBackendLocked(const std::string& candidate, PlaybackBackend backend)
+{
+    const auto startedAt = std::chrono::steady_clock::now();
+    bool started = false;
+    if (backend == PlaybackBackend::MediaFoundationStream) {
+        started = startMediaFoundationStreamLocked(candidate, config_.verboseStreamDiagnostics);
+    } else if (backend == PlaybackBackend::DirectShowStream) {
+        started = startDirectShowStreamLocked(candidate, config_.verboseStreamDiagnostics);
+    }
+    if (started) {
+        recordBackendOpen(backend, startedAt);
+    }
+    return started;
+}
+
+void RadioEngine::markStreamPlayingLocked(PlaybackBackend backend, const std::string& directUrl, const std::string& candidate)
+{
+    streamWrapperTempPath_.clear();
+    currentTrackPath_.clear();
+    resumePositionMs_ = 0;
+    backend_ = backend;
+    state_ = PlaybackState::Playing;
+    trackStartTime_ = std::chrono::steady_clock::now();
+    trackStartValid_ = true;
+    standbyDeviceId_ = currentDeviceId_;
+    stopFxLocked();
+    lastVolume_ = -1;
+    lastLeftVolume_ = -1;
+    lastRightVolume_ = -1;
+    updateFadeVolumeLocked();
+
+    const std::string prefix = backend == PlaybackBackend::DirectShowStream
+        ? "Now streaming (DirectShow fallback): "
+        : "Now streaming: ";
+    if (candidate == directUrl) {
+        logger_.info([&]() { return prefix + directUrl; });
     } else {
-        shutdownDirectShowLocked();
+        logger_.info([&]() { return prefix + directUrl + " (resolved: " + candidate + ")"; });
+    }
+}
+
+void RadioEngine::maintainStreamStandbyLocked()
+{
+    // The standbys follow the device that last started a stream; the mirror is authoritative while it is current.
+    PlaybackState anchorState = PlaybackState::Stopped;
+    const std::string* anchorKey = nullptr;
+    if (standbyDeviceId_ == currentDeviceId_) {
+        anchorState = state_;
+        anchorKey = &selectedKey_;
+    } else if (const auto deviceIt = deviceStates_.find(standbyDeviceId_); deviceIt != deviceStates_.end()) {
+        anchorState = deviceIt->second.state;
+        anchorKey = &deviceIt->second.selectedKey;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto standbyCount = static_cast<std::size_t>(std::clamp(config_.streamStandbyCount, 0, kMaxStreamStandby));
+    if (anchorState == PlaybackState::Playing) {
+        standbyGraceUntil_ = {};
+    } else if (!streamStandbys_.empty() && standbyGraceUntil_ == std::chrono::steady_clock::time_point{}) {
+        standbyGraceUntil_ = now + kStreamStandbyGrace;
+    }
+    // Stopped by a source cycle: the station it landed on is one of the standbys, so keep the set
+    // as it is until the follow-up play promotes it or the grace period runs out.
+    const bool holdForCycle = standbyCount > 0 && anchorState != PlaybackState::Playing && now < standbyGraceUntil_;
+    if (!holdForCycle) {
+        standbyGraceUntil_ = {};
+    }
+
+    // Neighbours of the anchor device's stream in source-cycling order: next, previous, next+1, ...
+    std::vector<std::string> wanted;
+    const auto* streams = channelsInCategoryLocked(3);
+    const auto selectedIt = anchorKey != nullptr ? channelAliases_.find(*anchorKey) : channelAliases_.end();
+    if (holdForCycle) {
+        for (const auto& standby : streamStandbys_) {
+            wanted.push_back(standby->directUrl);
+        }
+    } else if (standbyCount > 0 && anchorState == PlaybackState::Playing && streams != nullptr && streams->size() > 1 &&
+        selectedIt != channelAliases_.end() && selectedIt->second != kAmbiguousChannelHandle &&
+        channelTable_[selectedIt->second]->isStream) {
+        const std::size_t count = streams->size();
+        const std::size_t position = channelCategoryPosition_[selectedIt->second];
+        for (std::size_t distance = 1; distance < count && wanted.size() < standbyCount; ++distance) {
+            for (const std::size_t neighbor : { (position + distance) % count, (position + count - distance) % count }) {
+                const std::string url = trim(channelTable_[(*streams)[neighbor]]->streamUrl);
+                if (neighbor != position && !url.empty() && wanted.size() < standbyCount &&
+                    std::find(wanted.begin(), wanted.end(), url) == wanted.end()) {
+                    wanted.push_back(url);
+                }
+            }
+        }
+    }
+
+    for (auto it = streamStandbys_.begin(); it != streamStandbys_.end();) {
+        if (std::find(wanted.begin(), wanted.end(), (*it)->directUrl) == wanted.end()) {
+            retireStreamStandbyLocked(**it);
+            it = streamStandbys_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::erase_if(retiredStandbyResolves_, [](const std::future<std::string>& resolve) {
+        return resolve.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    if (wanted.empty() || !ensureMediaFoundationLocked()) {
+        return;
+    }
+
+    for (const auto& url : wanted) {
+        const bool present = std::any_of(streamStandbys_.begin(), streamStandbys_.end(), [&url](const auto& standby) {
+            return standby->directUrl == url;
+        });
+        if (present) {
+            continue;
+        }
+
+        auto standby = std::make_unique<StreamStandby>();
+        standby->directUrl = url;
+        const auto cacheIt = streamCache_.find(url);
+        if (cacheIt != streamCache_.end() && isStreamCacheEntryFreshLocked(cacheIt->second) &&
+            cacheIt->second.backend == PlaybackBackend::MediaFoundationStream) {
+            standby->resolvedUrl = cacheIt->second.resolvedUrl;
+            standby->candidate = cacheIt->second.candidate;
+        } else if (isLikelyWrapperExtension(urlExtensionLower(url))) {
+            // Playlist wrappers need an HTTP fetch; resolve off the worker and open once it lands.
+            standby->resolving = std::async(std::launch::async, [url, cancel = standby->cancel, internet = internet_, &logger = logger_]() {
+                return resolvePlayableStreamUrl(internet, url, logger, 0, [cancel]() {
+                    return cancel->load();
+                });
+            });
+        } else {
+            standby->candidate = url;
+        }
+        streamStandbys_.push_back(std::move(standby));
+    }
+
+    for (auto& standbyPtr : streamStandbys_) {
+        StreamStandby& standby = *standbyPtr;
+        if (standby.failed) {
+            continue;
+        }
+
+        if (standby.resolving.valid()) {
+            if (standby.resolving.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                continue;
+            }
+            standby.resolvedUrl = standby.resolving.get();
+            standby.candidate = standby.resolvedUrl.empty() ? standby.directUrl : standby.resolvedUrl;
+        }
+
+        if (!standby.player) {
+            standby.failed = !openMutedStreamPlayerLocked(standby, standby.candidate, "standby");
+            continue;
+        }
+
+        MFP_MEDIAPLAYER_STATE playerState = MFP_MEDIAPLAYER_STATE_EMPTY;
+        const HRESULT stateHr = standby.player->GetState(&playerState);
+        if (FAILED(standby.events->lastError.load()) || FAILED(stateHr) || playerState == MFP_MEDIAPLAYER_STATE_SHUTDOWN) {
+            logger_.info([&]() { return "Stream standby dropped: " + standby.directUrl; });
+            shutdownMutedStreamPlayerLocked(standby);
+            standby.failed = true;
+            continue;
+        }
+
+        if (!standby.started && playerState == MFP_MEDIAPLAYER_STATE_STOPPED) {
+            standby.failed = !startMutedStreamPlayerLocked(standby);
+        }
+    }
+}
+
+std::optional<RadioEngine::StreamResolutionEntry> RadioEngine::promoteStreamStandbyLocked(const std::string& directUrl)
+{
+    const auto it = std::find_if(streamStandbys_.begin(), streamStandbys_.end(), [&directUrl](const auto& standby) {
+        return standby->directUrl == directUrl;
+    });
+    if (it == streamStandbys_.end()) {
+        return std::nullopt;
+    }
+
+    StreamStandby& standby = **it;
+    MFP_MEDIAPLAYER_STATE playerState = MFP_MEDIAPLAYER_STATE_EMPTY;
+    if (!standby.started || !standby.player || FAILED(standby.events->lastError.load()) ||
+        FAILED(standby.player->GetState(&playerState)) || playerState != MFP_MEDIAPLAYER_STATE_PLAYING ||
+        !ensureMediaFoundationLocked() || !mfState_) {
+        return std::nullopt;
+    }
+
+    adoptMutedStreamPlayerLocked(standby);
+
+    StreamResolutionEntry promoted;
+    promoted.resolvedUrl = standby.resolvedUrl;
+    promoted.candidate = standby.candidate;
+    promoted.backend = PlaybackBackend::MediaFoundationStream;
+    streamStandbys_.erase(it);
+    logger_.info([&]() { return "Stream standby promoted: " + directUrl; });
+    return promoted;
+}
+
+void RadioEngine::retireStreamStandbyLocked(StreamStandby& standby)
+{
+    standby.cancel->store(true);
+    if (standby.resolving.valid()) {
+        retiredStandbyResolves_.push_back(std::move(standby.resolving));
+    }
+    shutdownMutedStreamPlayerLocked(standby);
+}
+
+void RadioEngine::clearStreamStandbyLocked()
+{
+    for (auto& standby : streamStandbys_) {
+        retireStreamStandbyLocked(*standby);
+    }
+    streamStandbys_.clear();
+}
+
+void RadioEngine::beginStreamReconnectLocked(const std::string& streamUrl)
+{
+    // The dropped player goes now. The device stays Playing on the Media Foundation backend with no
+    // player until a new one plays; with backend None a device switch would mark it Stopped.
+    stopPlaybackDeviceLocked(true);
+    backend_ = PlaybackBackend::MediaFoundationStream;
+
+    const auto now = std::chrono::steady_clock::now();
+    auto reconnect = std::make_unique<StreamReconnect>();
+    reconnect->directUrl = trim(streamUrl);
+    reconnect->nextAttemptAt = now + kStreamReconnectInitialDelay;
+    streamReconnect_ = std::move(reconnect);
+
+    state_ = PlaybackState::Playing;
+    trackStartValid_ = false;
+    nextPlaybackPollTime_ = streamReconnect_->nextAttemptAt;
+    logger_.info([&]() { return "Stream dropped, reconnecting in the background: " + streamReconnect_->directUrl; });
+}
+
+void RadioEngine::serviceStreamReconnectLocked(std::chrono::steady_clock::time_point now)
+{
+    StreamReconnect& reconnect = *streamReconnect_;
+    nextPlaybackPollTime_ = now + kStreamReconnectPoll;
+
+    if (reconnect.resolving.valid()) {
+        if (reconnect.resolving.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        reconnect.resolvedUrl = reconnect.resolving.get();
+        reconnect.candidate = reconnect.resolvedUrl.empty() ? reconnect.directUrl : reconnect.resolvedUrl;
+    }
+
+    if (!reconnect.player) {
+        if (now < reconnect.nextAttemptAt) {
+            nextPlaybackPollTime_ = reconnect.nextAttemptAt;
+            return;
+        }
+
+        // The first attempt replays the candidate that last worked; later ones resolve afresh in
+        // case the station moved to another mirror.
+        if (reconnect.candidate.empty()) {
+            const auto cacheIt = streamCache_.find(reconnect.directUrl);
+            const bool cacheFresh = cacheIt != streamCache_.end() && isStreamCacheEntryFreshLocked(cacheIt->second);
+            if (reconnect.attempt == 0 && cacheFresh && cacheIt->second.backend == PlaybackBackend::DirectShowStream) {
+                // Only DirectShow has played this station; a muted Media Foundation player would
+                // fail every attempt, so reopen it the blocking way straight away.
+                const std::string directUrl = reconnect.directUrl;
+                logger_.info([&]() { return "Stream reconnect reopening through DirectShow: " + directUrl; });
+                if (playStreamLocked(directUrl)) {
+                    stats_.streamReconnects.fetch_add(1, std::memory_order_relaxed);
+                }
+                return;
+            }
+            if (reconnect.attempt == 0 && cacheFresh) {
+                reconnect.resolvedUrl = cacheIt->second.resolvedUrl;
+                reconnect.candidate = cacheIt->second.candidate;
+            } else if (reconnect.attempt == 0 && !isLikelyWrapperExtension(urlExtensionLower(reconnect.directUrl))) {
+                reconnect.candidate = reconnect.directUrl;
+            } else {
+                reconnect.resolving = std::async(
+                    std::launch::async,
+                    [url = reconnect.directUrl, cancel = reconnect.cancel, internet = internet_, &logger = logger_]() {
+                        return resolvePlayableStreamUrl(internet, url, logger, 0, [cancel]() {
+                            return cancel->load();
+                        });
+                    });
+                return;
+            }
+        }
+
+        if (!ensureMediaFoundationLocked()) {
+            failStreamReconnectAttemptLocked(now);
+            return;
+        }
+
+        if (!openMutedStreamPlayerLocked(reconnect, reconnect.candidate, "reconnect")) {
+            failStreamReconnectAttemptLocked(now);
+            return;
+        }
+        reconnect.attemptDeadline = now + kStreamStartWaitTimeout;
+        return;
+    }
+
+    MFP_MEDIAPLAYER_STATE playerState = MFP_MEDIAPLAYER_STATE_EMPTY;
+    const HRESULT stateHr = reconnect.player->GetState(&playerState);
+    if (FAILED(reconnect.events->lastError.load()) || FAILED(stateHr) ||
+        playerState == MFP_MEDIAPLAYER_STATE_SHUTDOWN || now >= reconnect.attemptDeadline) {
+        failStreamReconnectAttemptLocked(now);
+        return;
+    }
+
+    if (!reconnect.started) {
+        if (playerState == MFP_MEDIAPLAYER_STATE_STOPPED && !startMutedStreamPlayerLocked(reconnect)) {
+            failStreamReconnectAttemptLocked(now);
+        }
+        return;
+    }
+    if (playerState != MFP_MEDIAPLAYER_STATE_PLAYING || !mfState_) {
+        return;
     }
 
-    auto cleanupOnFailure = [this, needsUninit]() {
-        shutdownDirectShowLocked();
-        if (needsUninit) {
-            CoUninitialize();
-        }
-    };
+    adoptMutedStreamPlayerLocked(reconnect);
 
-    const HRESULT graphHr = CoCreateInstance(
-        CLSID_FilterGraph,
-        nullptr,
-        CLSCTX_INPROC_SERVER,
-        IID_IGraphBuilder,
-        reinterpret_cast<void**>(dsState_->graph.ReleaseAndGetAddressOf()));
-    if (FAILED(graphHr) || !dsState_->graph) {
-        if (detailedLogs) {
-            logger_.warn("DirectShow graph creation failed for stream: " + streamUrl +
-                         " | hr=" + formatHresult(graphHr));
+    const std::string directUrl = reconnect.directUrl;
+    const std::string resolvedUrl = reconnect.resolvedUrl;
+    const std::string candidate = reconnect.candidate;
+    const std::uint32_t attempts = reconnect.attempt + 1;
+    streamReconnect_.reset();
+
+    stats_.streamReconnects.fetch_add(1, std::memory_order_relaxed);
+    logger_.info([&]() { return "Stream reconnected after " + std::to_string(attempts) + " attempt(s)."; });
+    markStreamPlayingLocked(PlaybackBackend::MediaFoundationStream, directUrl, candidate);
+    recordStreamWinnerLocked(directUrl, resolvedUrl, candidate, PlaybackBackend::MediaFoundationStream);
+    nextPlaybackPollTime_ = now + kPlaybackSafetyPoll;
+}
+
+void RadioEngine::failStreamReconnectAttemptLocked(std::chrono::steady_clock::time_point now)
+{
+    StreamReconnect& reconnect = *streamReconnect_;
+    stats_.streamReconnectFailures.fetch_add(1, std::memory_order_relaxed);
+    shutdownMutedStreamPlayerLocked(reconnect);
+    reconnect.candidate.clear();
+    ++reconnect.attempt;
+
+    if (reconnect.attempt >= kMaxStreamReconnectAttempts) {
+        // Last resort: the blocking open also tries every mirror on DirectShow, and leaves the
+        // device Stopped if nothing plays.
+        const std::string directUrl = reconnect.directUrl;
+        logger_.warn([&]() {
+            return "Stream reconnect gave up after " + std::to_string(reconnect.attempt) +
+                   " Media Foundation attempt(s), reopening: " + directUrl;
+        });
+        if (playStreamLocked(directUrl)) {
+            stats_.streamReconnects.fetch_add(1, std::memory_order_relaxed);
         }
-        cleanupOnFailure();
-        return false;
+        return;
     }
 
-    const HRESULT controlHr = dsState_->graph.As(&dsState_->control);
-    const HRESULT eventHr = dsState_->graph.As(&dsState_->events);
-    (void)dsState_->graph.As(&dsState_->audio);
-    if (FAILED(controlHr) || FAILED(eventHr) || !dsState_->control || !dsState_->events) {
-        if (detailedLogs) {
-            logger_.warn("DirectShow interface query failed for stream: " + streamUrl +
-                         " | controlHr=" + formatHresult(controlHr) +
-                         " | eventHr=" + formatHresult(eventHr));
-        }
-        cleanupOnFailure();
-        return false;
+    const auto delay = std::min<std::chrono::steady_clock::duration>(
+        kStreamReconnectInitialDelay * (1U << std::min<std::uint32_t>(reconnect.attempt, 16)), kStreamReconnectMaxDelay);
+    reconnect.nextAttemptAt = now + delay;
+    nextPlaybackPollTime_ = reconnect.nextAttemptAt;
+    logger_.info([&]() {
+        return "Stream reconnect attempt " + std::to_string(reconnect.attempt) + " failed; retrying in " +
+               std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(delay).count()) + " ms.";
+    });
+}
+
+void RadioEngine::cancelStreamReconnectLocked()
+{
+    if (!streamReconnect_) {
+        return;
     }
 
-    const std::wstring wideUrl = utf8ToWide(streamUrl);
-    if (wideUrl.empty()) {
-        if (detailedLogs) {
-            logger_.warn("DirectShow stream open failed: URL conversion to UTF-16 returned empty.");
-        }
-        cleanupOnFailure();
+    streamReconnect_->cancel->store(true);
+    if (streamReconnect_->resolving.valid()) {
+        retiredStandbyResolves_.push_back(std::move(streamReconnect_->resolving));
+    }
+    shutdownMutedStreamPlayerLocked(*streamReconnect_);
+    streamReconnect_.reset();
+}
+
+bool RadioEngine::openMutedStreamPlayerLocked(MutedStreamPlayer& muted, const std::string& candidate, const char* purpose)
+{
+    // Opened without the notify window: its errors must not wake the worker as if the live player
+    // had failed.
+    muted.events = std::make_shared<MfEventState>();
+    muted.callback.Attach(new MfPlayerCallback(muted.events));
+    muted.started = false;
+    const std::wstring wideUrl = utf8ToWide(candidate);
+    const HRESULT createHr = wideUrl.empty()
+        ? E_INVALIDARG
+        : MFPCreateMediaPlayer(
+              wideUrl.c_str(),
+              FALSE,
+              MFP_OPTION_FREE_THREADED_CALLBACK,
+              muted.callback.Get(),
+              nullptr,
+              muted.player.ReleaseAndGetAddressOf());
+    if (FAILED(createHr) || !muted.player) {
+        logger_.info([&]() {
+            return std::string("Stream ") + purpose + " open failed: " + candidate + " | hr=" + formatHresult(createHr);
+        });
         return false;
     }
+    return true;
+}
 
-    if (isPlayInterruptRequested()) {
-        cleanupOnFailure();
-        return false;
+bool RadioEngine::startMutedStreamPlayerLocked(MutedStreamPlayer& muted)
+{
+    // Volume and mute only stick once the media item is set, so start buffering from STOPPED.
+    (void)muted.player->SetMute(TRUE);
+    (void)muted.player->SetVolume(0.0F);
+    muted.started = SUCCEEDED(muted.player->Play());
+    return muted.started;
+}
+
+void RadioEngine::adoptMutedStreamPlayerLocked(MutedStreamPlayer& muted)
+{
+    if (mfState_->player) {
+        (void)mfState_->player->Stop();
+        (void)mfState_->player->Shutdown();
     }
+    mfState_->player = std::move(muted.player);
+    mfState_->callback = std::move(muted.callback);
+    mfState_->events = std::move(muted.events);
+    mfState_->events->notifyWindow.store(notifyState_ ? notifyState_->window : nullptr);
+    mfState_->stall = StreamStallWatch{};
+    (void)mfState_->player->SetMute(FALSE);
+}
 
-    const HRESULT renderHr = dsState_->graph->RenderFile(wideUrl.c_str(), nullptr);
-    if (FAILED(renderHr)) {
-        if (detailedLogs) {
-            logger_.warn("DirectShow could not render stream: " + streamUrl +
-                         " | hr=" + formatHresult(renderHr));
-        }
-        cleanupOnFailure();
-        return false;
+void RadioEngine::shutdownMutedStreamPlayerLocked(MutedStreamPlayer& muted)
+{
+    if (muted.player) {
+        (void)muted.player->Stop();
+        (void)muted.player->Shutdown();
+        muted.player.Reset();
     }
+    muted.callback.Reset();
+    muted.events.reset();
+    muted.started = false;
+}
 
-    if (isPlayInterruptRequested()) {
-        cleanupOnFailure();
+bool RadioEngine::mfStreamStalledLocked()
+{
+    // Read the player itself: currentPlaybackPositionMsLocked reports 0 for every stream channel.
+    // Players that cannot report a position cannot be judged.
+    const auto positionMs = mfPlayerPositionMsLocked();
+    if (!positionMs.has_value()) {
         return false;
     }
+    const auto now = std::chrono::steady_clock::now();
+    return streamStalled(mfState_->stall, *positionMs, now, trackStartValid_ ? trackStartTime_ : now);
+}
 
-    const HRESULT runHr = dsState_->control->Run();
-    if (FAILED(runHr)) {
-        if (detailedLogs) {
-            logger_.warn("DirectShow could not run stream: " + streamUrl +
-                         " | hr=" + formatHresult(runHr));
+std::optional<std::uint64_t> RadioEngine::mfPlayerPositionMsLocked() const
+{
+    if (!mfState_ || !mfState_->player) {
+        return std::nullopt;
+    }
+
+    PROPVARIANT position{};
+    PropVariantInit(&position);
+    const HRESULT hr = mfState_->player->GetPosition(MFP_POSITIONTYPE_100NS, &position);
+    std::optional<std::uint64_t> positionMs;
+    if (SUCCEEDED(hr)) {
+        if (position.vt == VT_I8) {
+            positionMs = static_cast<std::uint64_t>(std::max<LONGLONG>(position.hVal.QuadPart, 0) / 10000);
+        } else if (position.vt == VT_UI8) {
+            positionMs = static_cast<std::uint64_t>(position.uhVal.QuadPart / 10000);
         }
-        cleanupOnFailure();
+    }
+    PropVariantClear(&position);
+    return positionMs;
+}
+
+bool RadioEngine::streamStalled(
+    StreamStallWatch& watch,
+    std::uint64_t positionMs,
+    std::chrono::steady_clock::time_point now,
+    std::chrono::steady_clock::time_point notBefore)
+{
+    if (positionMs != watch.lastPositionMs || watch.lastProgressAt == std::chrono::steady_clock::time_point{}) {
+        watch.lastPositionMs = positionMs;
+        watch.lastProgressAt = now;
         return false;
     }
 
-    if (needsUninit) {
-        // Keep COM initialized for this thread lifetime; matching uninit happens on shutdown.
-        if (mfState_) {
-            mfState_->comInitialized = true;
-            mfState_->ownsComInitialization = true;
-        }
+    // A fresh start or resume gets the full window even if the position has not moved yet.
+    return now - std::max(watch.lastProgressAt, notBefore) >= kStreamStallTimeout;
+}
+
+bool RadioEngine::isStreamCacheEntryFreshLocked(const StreamResolutionEntry& entry) const
+{
+    if (config_.streamCacheTtlMinutes <= 0 || entry.candidate.empty() || entry.backend == PlaybackBackend::None) {
+        return false;
     }
 
-    return true;
+    const long long ageSeconds = unixTimeSecondsNow() - entry.confirmedAtUnix;
+    return ageSeconds >= 0 && ageSeconds < static_cast<long long>(config_.streamCacheTtlMinutes) * 60;
 }
 
-void RadioEngine::shutdownDirectShowLocked()
+void RadioEngine::recordStreamWinnerLocked(
+    const std::string& directUrl,
+    const std::string& resolvedUrl,
+    const std::string& candidate,
+    PlaybackBackend backend)
 {
-    if (!dsState_) {
+    if (config_.streamCacheTtlMinutes <= 0) {
         return;
     }
 
-    if (dsState_->control) {
-        (void)dsState_->control->Stop();
+    // Re-confirming the same winner only moves its timestamp, so that (and the file) is refreshed
+    // once it is halfway to the TTL rather than on every tune.
+    const long long now = unixTimeSecondsNow();
+    StreamResolutionEntry& entry = streamCache_[directUrl];
+    if (entry.resolvedUrl == resolvedUrl && entry.candidate == candidate && entry.backend == backend &&
+        now - entry.confirmedAtUnix < static_cast<long long>(config_.streamCacheTtlMinutes) * 30) {
+        return;
     }
-    dsState_->audio.Reset();
-    dsState_->events.Reset();
-    dsState_->control.Reset();
-    dsState_->graph.Reset();
+    entry.resolvedUrl = resolvedUrl;
+    entry.candidate = candidate;
+    entry.backend = backend;
+    entry.confirmedAtUnix = now;
+    (void)saveStreamCacheLocked();
 }
 
-bool RadioEngine::playStreamLocked(const std::string& streamUrl)
+std::filesystem::path RadioEngine::streamCachePathLocked() const
 {
-    stopPlaybackDeviceLocked(true);
+    return config_.radioRootPath / kStreamCacheFileName;
+}
 
-    const std::string directUrl = trim(streamUrl);
-    if (directUrl.empty()) {
-        logger_.warn("Stream play failed: empty URL.");
-        state_ = PlaybackState::Stopped;
-        currentTrackPath_.clear();
-        resumePositionMs_ = 0;
-        lastVolume_ = -1;
-        lastLeftVolume_ = -1;
-        lastRightVolume_ = -1;
-        trackStartValid_ = false;
+bool RadioEngine::loadStreamCacheLocked()
+{
+    streamCache_.clear();
+
+    const auto path = streamCachePathLocked();
+    if (!std::filesystem::exists(path)) {
         return false;
     }
 
-    auto clearStreamState = [this]() {
-        backend_ = PlaybackBackend::None;
-        state_ = PlaybackState::Stopped;
-        currentTrackPath_.clear();
-        resumePositionMs_ = 0;
-        lastVolume_ = -1;
-        lastLeftVolume_ = -1;
-        lastRightVolume_ = -1;
-        trackStartValid_ = false;
-    };
-
-    std::vector<std::string> candidates;
-    auto addCandidate = [&candidates](const std::string& url) {
-        const std::string trimmedUrl = trimAsciiCopy(url);
-        if (trimmedUrl.empty()) {
-            return;
-        }
-        const std::string lowered = toLowerCopy(trimmedUrl);
-        for (const auto& existing : candidates) {
-            if (toLowerCopy(existing) == lowered) {
-                return;
-            }
-        }
-        candidates.push_back(trimmedUrl);
-    };
-
-    const std::string resolvedUrl = resolvePlayableStreamUrl(
-        directUrl,
-        logger_,
-        0,
-        [this]() {
-            return isPlayInterruptRequested();
-        });
-    if (isPlayInterruptRequested()) {
-        clearStreamState();
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        logger_.warn([&]() { return "Could not open stream cache: " + pathToUtf8(path); });
         return false;
     }
-    const bool directLooksWrapper = isLikelyWrapperExtension(urlExtensionLower(directUrl));
-    const bool hasResolvedAlternative =
-        !resolvedUrl.empty() && toLower(resolvedUrl) != toLower(directUrl);
 
-    auto addCandidateFamily = [&addCandidate](const std::string& baseUrl) {
-        addCandidate(baseUrl);
-        addCandidate(httpsToHttpVariant(baseUrl));
-        addCandidate(httpToHttpsVariant(baseUrl));
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
 
-        if (isLikelyWrapperExtension(urlExtensionLower(baseUrl))) {
-            return;
-        }
-        for (const auto& variant : makeShoutcastStyleVariants(baseUrl)) {
-            addCandidate(variant);
-            addCandidate(httpsToHttpVariant(variant));
-            addCandidate(httpToHttpsVariant(variant));
+    for (const auto& object : jsonObjectArrayEntries(text, "streams")) {
+        const std::string url = jsonFieldString(object, "url").value_or(std::string{});
+        if (url.empty()) {
+            continue;
         }
-    };
 
-    if (!directLooksWrapper || !hasResolvedAlternative) {
-        addCandidateFamily(directUrl);
-    }
-    if (hasResolvedAlternative) {
-        addCandidateFamily(resolvedUrl);
-    }
-    if (candidates.empty()) {
-        addCandidate(directUrl);
+        StreamResolutionEntry entry;
+        entry.resolvedUrl = jsonFieldString(object, "resolved_url").value_or(std::string{});
+        entry.candidate = jsonFieldString(object, "candidate").value_or(std::string{});
+        entry.confirmedAtUnix = jsonFieldInt(object, "confirmed_at").value_or(0);
+        const std::string backend = jsonFieldString(object, "backend").value_or(std::string{});
+        if (backend == "media_foundation") {
+            entry.backend = PlaybackBackend::MediaFoundationStream;
+        } else if (backend == "directshow") {
+            entry.backend = PlaybackBackend::DirectShowStream;
+        } else {
+            continue;
+        }
+        streamCache_[url] = std::move(entry);
     }
 
-    for (const auto& candidate : candidates) {
-        if (isPlayInterruptRequested()) {
-            clearStreamState();
-            return false;
-        }
+    logger_.info([&]() { return "Loaded stream cache entries: " + std::to_string(streamCache_.size()); });
+    return !streamCache_.empty();
+}
 
-        if (startMediaFoundationStreamLocked(candidate, config_.verboseStreamDiagnostics)) {
-            streamWrapperTempPath_.clear();
-            currentTrackPath_.clear();
-            resumePositionMs_ = 0;
-            backend_ = PlaybackBackend::MediaFoundationStream;
-            state_ = PlaybackState::Playing;
-            trackStartTime_ = std::chrono::steady_clock::now();
-            trackStartValid_ = true;
-            stopFxLocked();
-            lastVolume_ = -1;
-            lastLeftVolume_ = -1;
-            lastRightVolume_ = -1;
-            updateFadeVolumeLocked();
-            if (candidate == directUrl) {
-                logger_.info("Now streaming: " + directUrl);
-            } else {
-                logger_.info("Now streaming: " + directUrl + " (resolved: " + candidate + ")");
-            }
-            return true;
-        }
+bool RadioEngine::saveStreamCacheLocked()
+{
+    std::ostringstream out;
+    out << "{\n  \"version\": 1,\n  \"streams\": [";
+    bool wroteAny = false;
+    for (const auto& [url, entry] : streamCache_) {
+        out << (wroteAny ? ",\n" : "\n");
+        wroteAny = true;
+        out << "    {\n";
+        out << "      \"url\": \"" << jsonEscape(url) << "\",\n";
+        out << "      \"resolved_url\": \"" << jsonEscape(entry.resolvedUrl) << "\",\n";
+        out << "      \"candidate\": \"" << jsonEscape(entry.candidate) << "\",\n";
+        out << "      \"backend\": \""
+            << (entry.backend == PlaybackBackend::DirectShowStream ? "directshow" : "media_foundation") << "\",\n";
+        out << "      \"confirmed_at\": " << entry.confirmedAtUnix << "\n";
+        out << "    }";
+    }
+    if (wroteAny) {
+        out << "\n";
+    }
+    out << "  ]\n}\n";
 
-        if (isPlayInterruptRequested()) {
-            clearStreamState();
-            return false;
-        }
+    StreamCacheWriteJob job{ streamCachePathLocked(), out.str() };
+    if (!sessionWriterRunning_) {
+        return writeStreamCacheJob(job, logger_);
+    }
 
-        if (startDirectShowStreamLocked(candidate, config_.verboseStreamDiagnostics)) {
-            streamWrapperTempPath_.clear();
-            currentTrackPath_.clear();
-            resumePositionMs_ = 0;
-            backend_ = PlaybackBackend::DirectShowStream;
-            state_ = PlaybackState::Playing;
-            trackStartTime_ = std::chrono::steady_clock::now();
-            trackStartValid_ = true;
-            stopFxLocked();
-            lastVolume_ = -1;
-            lastLeftVolume_ = -1;
-            lastRightVolume_ = -1;
-            updateFadeVolumeLocked();
-            if (candidate == directUrl) {
-                logger_.info("Now streaming (DirectShow fallback): " + directUrl);
-            } else {
-                logger_.info("Now streaming (DirectShow fallback): " + directUrl + " (resolved: " + candidate + ")");
-            }
-            return true;
-        }
+    {
+        std::lock_guard<std::mutex> writerLock(sessionWriterMutex_);
+        pendingStreamCacheWrite_ = std::move(job);
     }
+    sessionWriterCv_.notify_all();
+    return true;
+}
 
-    clearStreamState();
-    logger_.warn("Stream play failed after all URL attempts: " + directUrl);
-    return false;
+bool RadioEngine::writeStreamCacheJob(const StreamCacheWriteJob& job, Logger& logger)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(job.path.parent_path(), ec);
+    if (ec) {
+        logger.warn([&]() { return "Could not create stream cache directory: " + pathToUtf8(job.path.parent_path()); });
+        return false;
+    }
+    return writeTextFileAtomically(job.path, job.payload, logger);
 }
 
 void RadioEngine::stopPlaybackDeviceLocked(bool closeDevice)
 {
-    if (backend_ == PlaybackBackend::MediaFoundationStream && mfState_ && mfState_->player) {
-        (void)mfState_->player->Stop();
-        if (closeDevice) {
-            (void)mfState_->player->Shutdown();
-            mfState_->player.Reset();
-            if (mfState_->events) {
-                mfState_->events->lastError.store(S_OK);
-                mfState_->events->playbackEnded.store(false);
+    closeDrainedStandbyLocked({}, true);
+    discardPreloadLocked();
+    cancelStreamReconnectLocked();
+
+    if (backend_ == PlaybackBackend::MediaFoundationStream) {
+        // No player while a reconnect is pending; there is no MCI alias to close either.
+        if (mfState_ && mfState_->player) {
+            (void)mfState_->player->Stop();
+            if (closeDevice) {
+                (void)mfState_->player->Shutdown();
+                mfState_->player.Reset();
+                if (mfState_->events) {
+                    mfState_->events->lastError.store(S_OK);
+                    mfState_->events->playbackEnded.store(false);
+                }
             }
         }
     } else if (backend_ == PlaybackBackend::DirectShowStream && dsState_ && dsState_->control) {
@@ -3493,13 +6001,23 @@ void RadioEngine::stopPlaybackDeviceLocked(bool closeDevice)
         if (closeDevice) {
             shutdownDirectShowLocked();
         }
+    } else if (backend_ == PlaybackBackend::NativeMixer) {
+        if (mixer_ && mixerVoice_ != 0) {
+            if (closeDevice) {
+                mixer_->close(mixerVoice_);
+            } else {
+                (void)mixer_->pause(mixerVoice_);
+            }
+        }
+        if (closeDevice) {
+            mixerVoice_ = 0;
+        }
     } else {
-        (void)mciSendStringW((L"stop " + std::wstring(kAlias)).c_str(), nullptr, 0, nullptr);
+        (void)mciSend(L"stop " + activeAlias_);
         if (closeDevice) {
             bool closed = false;
             for (int attempt = 0; attempt < 3 && !closed; ++attempt) {
-                const MCIERROR closeErr =
-                    mciSendStringW((L"close " + std::wstring(kAlias)).c_str(), nullptr, 0, nullptr);
+                const MCIERROR closeErr = mciSend(L"close " + activeAlias_);
                 if (closeErr == 0) {
                     closed = waitForAliasClosedLocked(std::chrono::milliseconds(80));
                 } else {
@@ -3510,7 +6028,7 @@ void RadioEngine::stopPlaybackDeviceLocked(bool closeDevice)
                 }
 
                 if (!closed) {
-                    (void)mciSendStringW((L"stop " + std::wstring(kAlias)).c_str(), nullptr, 0, nullptr);
+                    (void)mciSend(L"stop " + activeAlias_);
                     std::this_thread::sleep_for(std::chrono::milliseconds(20));
                 }
             }
@@ -3533,6 +6051,12 @@ bool RadioEngine::resumeLocked()
         return false;
     }
 
+    // A live station kept broadcasting while paused; tune back in where it is now.
+    const auto liveIt = channels_.find(selectedKey_);
+    if (liveIt != channels_.end() && liveStationActiveLocked(liveIt->second)) {
+        return startLiveStationLocked(liveIt->second);
+    }
+
     if (backend_ == PlaybackBackend::MediaFoundationStream) {
         if (!mfState_ || !mfState_->player) {
             logger_.warn("resume failed. Stream backend player is not available.");
@@ -3541,9 +6065,11 @@ bool RadioEngine::resumeLocked()
 
         const HRESULT playHr = mfState_->player->Play();
         if (FAILED(playHr)) {
-            logger_.warn("resume failed. Media Foundation Play failed: " + formatHresult(playHr));
+            logger_.warn([&]() { return "resume failed. Media Foundation Play failed: " + formatHresult(playHr); });
             return false;
         }
+        // The position stood still while paused; that is not a stall.
+        mfState_->stall.lastProgressAt = std::chrono::steady_clock::now();
     } else if (backend_ == PlaybackBackend::DirectShowStream) {
         if (!dsState_ || !dsState_->control) {
             logger_.warn("resume failed. DirectShow backend player is not available.");
@@ -3552,12 +6078,17 @@ bool RadioEngine::resumeLocked()
 
         const HRESULT runHr = dsState_->control->Run();
         if (FAILED(runHr)) {
-            logger_.warn("resume failed. DirectShow Run failed: " + formatHresult(runHr));
+            logger_.warn([&]() { return "resume failed. DirectShow Run failed: " + formatHresult(runHr); });
+            return false;
+        }
+    } else if (backend_ == PlaybackBackend::NativeMixer) {
+        if (!mixer_ || !mixer_->start(mixerVoice_)) {
+            logger_.warn("resume failed. Native mixer voice is not available.");
             return false;
         }
     } else {
-        if (!mciCommandLocked(L"resume " + std::wstring(kAlias))) {
-            if (!mciCommandLocked(L"play " + std::wstring(kAlias))) {
+        if (!mciPlayLocked(L"resume " + activeAlias_)) {
+            if (!mciPlayLocked(L"play " + activeAlias_)) {
                 logger_.warn("resume failed.");
                 return false;
             }
@@ -3575,6 +6106,15 @@ bool RadioEngine::pauseLocked()
         return false;
     }
 
+    // Nothing is audible while a stream reconnects; pausing gives up on it, and play starts over.
+    if (streamReconnect_) {
+        stopPlaybackDeviceLocked(true);
+        state_ = PlaybackState::Stopped;
+        trackStartValid_ = false;
+        logger_.info("Stream reconnect cancelled by pause.");
+        return true;
+    }
+
     if (backend_ == PlaybackBackend::MediaFoundationStream) {
         if (!mfState_ || !mfState_->player) {
             logger_.warn("pause failed. Stream backend player is not available.");
@@ -3583,7 +6123,7 @@ bool RadioEngine::pauseLocked()
 
         const HRESULT pauseHr = mfState_->player->Pause();
         if (FAILED(pauseHr)) {
-            logger_.warn("pause failed. Media Foundation Pause failed: " + formatHresult(pauseHr));
+            logger_.warn([&]() { return "pause failed. Media Foundation Pause failed: " + formatHresult(pauseHr); });
             return false;
         }
     } else if (backend_ == PlaybackBackend::DirectShowStream) {
@@ -3594,11 +6134,16 @@ bool RadioEngine::pauseLocked()
 
         const HRESULT pauseHr = dsState_->control->Pause();
         if (FAILED(pauseHr)) {
-            logger_.warn("pause failed. DirectShow Pause failed: " + formatHresult(pauseHr));
+            logger_.warn([&]() { return "pause failed. DirectShow Pause failed: " + formatHresult(pauseHr); });
+            return false;
+        }
+    } else if (backend_ == PlaybackBackend::NativeMixer) {
+        if (!mixer_ || !mixer_->pause(mixerVoice_)) {
+            logger_.warn("pause failed. Native mixer voice is not available.");
             return false;
         }
     } else {
-        if (!mciCommandLocked(L"pause " + std::wstring(kAlias))) {
+        if (!mciCommandLocked(L"pause " + activeAlias_)) {
             logger_.warn("pause failed.");
             return false;
         }
@@ -3609,7 +6154,7 @@ bool RadioEngine::pauseLocked()
     return true;
 }
 
-bool RadioEngine::forwardLocked()
+bool RadioEngine::forwardLocked(std::size_t steps)
 {
     if (selectedKey_.empty()) {
         return false;
@@ -3630,19 +6175,23 @@ bool RadioEngine::forwardLocked()
         return false;
     }
 
+    // Coalesced presses move the cursor several tracks but only the final one is opened.
+    steps = std::max<std::size_t>(steps, 1);
     if (trackOrderMode_ == TrackOrderMode::Shuffle) {
-        const auto songIndex = advanceShuffleSongLocked(channelIt->second);
-        if (!songIndex.has_value()) {
-            return false;
+        for (std::size_t step = 0; step < steps; ++step) {
+            const auto songIndex = advanceShuffleSongLocked(channelIt->second);
+            if (!songIndex.has_value()) {
+                return false;
+            }
+            songIndex_ = *songIndex;
         }
-        songIndex_ = *songIndex;
         previousWasSong_ = true;
     } else if (mode_ == PlaybackMode::Station || channelIt->second.type == ChannelType::Station) {
-        songIndex_ = (songIndex_ + 1) % channelIt->second.songs.size();
+        songIndex_ = (songIndex_ + steps) % channelIt->second.songs.size();
         previousWasSong_ = true;
         mode_ = PlaybackMode::Station;
     } else {
-        songIndex_ = (songIndex_ + 1) % channelIt->second.songs.size();
+        songIndex_ = (songIndex_ + steps) % channelIt->second.songs.size();
         mode_ = PlaybackMode::Playlist;
     }
     resumePositionMs_ = 0;
@@ -3652,11 +6201,11 @@ bool RadioEngine::forwardLocked()
         return false;
     }
 
-    logger_.info("forward -> " + pathToUtf8(*track));
+    logger_.info([&]() { return "forward -> " + pathToUtf8(*track); });
     return playPathLocked(*track);
 }
 
-bool RadioEngine::rewindLocked()
+bool RadioEngine::rewindLocked(std::size_t steps)
 {
     const auto channelIt = channels_.find(selectedKey_);
     if (channelIt != channels_.end() && channelIt->second.isStream) {
@@ -3665,11 +6214,32 @@ bool RadioEngine::rewindLocked()
         return playStreamLocked(channelIt->second.streamUrl);
     }
 
-    int positionMs = 0;
-    if (mciStatusNumberLocked(L"position", positionMs) && positionMs > 3000) {
-        if (mciCommandLocked(L"seek " + std::wstring(kAlias) + L" to 0")) {
+    steps = std::max<std::size_t>(steps, 1);
+    bool pastRestartPoint = false;
+    if (backend_ == PlaybackBackend::NativeMixer && mixer_) {
+        const auto positionMs = mixer_->positionMs(mixerVoice_);
+        pastRestartPoint = positionMs.has_value() && *positionMs > 3000;
+    } else if (backend_ == PlaybackBackend::MCI) {
+        int positionMs = 0;
+        pastRestartPoint = mciStatusNumberLocked(L"position", positionMs) && positionMs > 3000;
+    }
+
+    if (pastRestartPoint && steps > 1) {
+        // The first of several coalesced presses would only have restarted the track.
+        pastRestartPoint = false;
+        --steps;
+    }
+
+    if (pastRestartPoint && backend_ == PlaybackBackend::NativeMixer) {
+        if (mixer_->seek(mixerVoice_, 0)) {
+            resumePositionMs_ = 0;
+            logger_.info("rewind -> restart current track.");
+            return true;
+        }
+    } else if (pastRestartPoint) {
+        if (mciCommandLocked(L"seek " + activeAlias_ + L" to 0")) {
             if (state_ != PlaybackState::Paused) {
-                (void)mciCommandLocked(L"play " + std::wstring(kAlias));
+                (void)mciPlayLocked(L"play " + activeAlias_);
                 state_ = PlaybackState::Playing;
             }
             resumePositionMs_ = 0;
@@ -3683,14 +6253,17 @@ bool RadioEngine::rewindLocked()
     }
 
     if (trackOrderMode_ == TrackOrderMode::Shuffle) {
-        const auto songIndex = retreatShuffleSongLocked(channelIt->second);
-        if (!songIndex.has_value()) {
-            return false;
+        for (std::size_t step = 0; step < steps; ++step) {
+            const auto songIndex = retreatShuffleSongLocked(channelIt->second);
+            if (!songIndex.has_value()) {
+                return false;
+            }
+            songIndex_ = *songIndex;
         }
-        songIndex_ = *songIndex;
     } else {
         const auto songCount = channelIt->second.songs.size();
-        songIndex_ = (songIndex_ == 0) ? (songCount - 1) : (songIndex_ - 1);
+        const std::size_t back = steps % songCount;
+        songIndex_ = (songIndex_ + songCount - back) % songCount;
     }
     previousWasSong_ = true;
     resumePositionMs_ = 0;
@@ -3704,12 +6277,13 @@ bool RadioEngine::rewindLocked()
         return false;
     }
 
-    logger_.info("rewind -> " + pathToUtf8(*track));
+    logger_.info([&]() { return "rewind -> " + pathToUtf8(*track); });
     return playPathLocked(*track);
 }
 
-bool RadioEngine::previousLocked()
+bool RadioEngine::previousLocked(std::size_t steps)
 {
+    steps = std::max<std::size_t>(steps, 1);
     const auto channelIt = channels_.find(selectedKey_);
     if (channelIt != channels_.end() && channelIt->second.isStream) {
         resumePositionMs_ = 0;
@@ -3722,14 +6296,17 @@ bool RadioEngine::previousLocked()
     }
 
     if (trackOrderMode_ == TrackOrderMode::Shuffle) {
-        const auto songIndex = retreatShuffleSongLocked(channelIt->second);
-        if (!songIndex.has_value()) {
-            return false;
+        for (std::size_t step = 0; step < steps; ++step) {
+            const auto songIndex = retreatShuffleSongLocked(channelIt->second);
+            if (!songIndex.has_value()) {
+                return false;
+            }
+            songIndex_ = *songIndex;
         }
-        songIndex_ = *songIndex;
     } else {
         const auto songCount = channelIt->second.songs.size();
-        songIndex_ = (songIndex_ == 0) ? (songCount - 1) : (songIndex_ - 1);
+        const std::size_t back = steps % songCount;
+        songIndex_ = (songIndex_ + songCount - back) % songCount;
     }
     previousWasSong_ = true;
     resumePositionMs_ = 0;
@@ -3743,10 +6320,24 @@ bool RadioEngine::previousLocked()
         return false;
     }
 
-    logger_.info("previous -> " + pathToUtf8(*track));
+    logger_.info([&]() { return "previous -> " + pathToUtf8(*track); });
     return playPathLocked(*track);
 }
 
+bool RadioEngine::applyVolumeDeltaLocked(float deltaGain)
+{
+    DeviceState& device = ensureDeviceStateLocked(currentDeviceId_);
+    device.volumeGain = std::clamp(device.volumeGain + deltaGain, 0.0F, 2.0F);
+    updateFadeVolumeLocked();
+    logger_.info([&]() {
+        return std::string(deltaGain >= 0.0F ? "volumeUp" : "volumeDown") +
+               " deviceId=" + std::to_string(currentDeviceId_) +
+               " gain=" + std::to_string(device.volumeGain) +
+               " volume=" + std::to_string(device.volumeGain * kDefaultVolumePercent);
+    });
+    return true;
+}
+
 void RadioEngine::syncResumePositionFromBackendLocked()
 {
     if (selectedKey_.empty()) {
@@ -3778,20 +6369,13 @@ std::uint64_t RadioEngine::currentPlaybackPositionMsLocked()
         return resumePositionMs_;
     }
 
-    if (backend_ == PlaybackBackend::MediaFoundationStream && mfState_ && mfState_->player) {
-        PROPVARIANT position{};
-        PropVariantInit(&position);
-        const HRESULT hr = mfState_->player->GetPosition(MFP_POSITIONTYPE_100NS, &position);
-        std::uint64_t positionMs = 0;
-        if (SUCCEEDED(hr)) {
-            if (position.vt == VT_I8 && position.hVal.QuadPart > 0) {
-                positionMs = static_cast<std::uint64_t>(position.hVal.QuadPart / 10000);
-            } else if (position.vt == VT_UI8 && position.uhVal.QuadPart > 0) {
-                positionMs = static_cast<std::uint64_t>(position.uhVal.QuadPart / 10000);
-            }
-        }
-        PropVariantClear(&position);
-        return positionMs;
+    if (backend_ == PlaybackBackend::NativeMixer) {
+        const auto positionMs = mixer_ ? mixer_->positionMs(mixerVoice_) : std::nullopt;
+        return positionMs.value_or(resumePositionMs_);
+    }
+
+    if (backend_ == PlaybackBackend::MediaFoundationStream) {
+        return mfPlayerPositionMsLocked().value_or(0);
     }
 
     return resumePositionMs_;
@@ -3805,7 +6389,11 @@ bool RadioEngine::seekCurrentPlaybackLocked(const std::uint64_t positionMs)
 
     if (backend_ == PlaybackBackend::MCI) {
         return mciCommandLocked(
-            L"seek " + std::wstring(kAlias) + L" to " + std::to_wstring(positionMs));
+            L"seek " + activeAlias_ + L" to " + std::to_wstring(positionMs));
+    }
+
+    if (backend_ == PlaybackBackend::NativeMixer && mixer_) {
+        return mixer_->seek(mixerVoice_, positionMs);
     }
 
     if (backend_ == PlaybackBackend::MediaFoundationStream && mfState_ && mfState_->player) {
@@ -3821,10 +6409,43 @@ bool RadioEngine::seekCurrentPlaybackLocked(const std::uint64_t positionMs)
     return false;
 }
 
-void RadioEngine::resetShuffleHistoryLocked()
+void RadioEngine::resetShuffleOrderLocked()
+{
+    shuffle_ = {};
+}
+
+void RadioEngine::anchorShuffleOrderLocked(const std::size_t songIndex, const std::size_t songCount)
+{
+    shuffle_ = {};
+    if (songCount == 0) {
+        return;
+    }
+
+    // Rotate cycle 0 so the anchored song sits at play position 0 and the whole cycle follows it.
+    shuffle_.seed = shuffleRng()();
+    shuffle_.songCount = songCount;
+    shuffle_.offset = shufflePermute(shuffle_.seed, 0, songCount, std::min(songIndex, songCount - 1), true);
+}
+
+std::size_t RadioEngine::shuffleSongAt(const ShuffleOrder& order, const std::uint64_t epoch, const std::size_t position)
+{
+    if (order.songCount == 0) {
+        return 0;
+    }
+    return shufflePermute(order.seed, epoch, order.songCount, (position + order.offset) % order.songCount, false);
+}
+
+bool RadioEngine::shuffleSkipsEpochLead(const ShuffleOrder& order, const std::uint64_t epoch)
 {
-    shuffleHistory_.clear();
-    shuffleCursor_ = 0;
+    // A new cycle never opens with the song that closed the previous one.
+    return epoch > 0 && order.songCount > 1 &&
+           shuffleSongAt(order, epoch, 0) == shuffleSongAt(order, epoch - 1, order.songCount - 1);
+}
+
+bool RadioEngine::shuffleOrderMatches(const ShuffleOrder& order, const std::size_t songIndex, const std::size_t songCount)
+{
+    return order.songCount != 0 && order.songCount == songCount && order.cursor < songCount &&
+           shuffleSongAt(order, order.epoch, order.cursor) == songIndex;
 }
 
 std::optional<std::size_t> RadioEngine::ensureShuffleCurrentSongLocked(const ChannelEntry& channel)
@@ -3833,11 +6454,8 @@ std::optional<std::size_t> RadioEngine::ensureShuffleCurrentSongLocked(const Cha
         return std::nullopt;
     }
 
-    if (!shuffleHistory_.empty() && shuffleCursor_ < shuffleHistory_.size()) {
-        const std::size_t current = shuffleHistory_[shuffleCursor_];
-        if (current < channel.songs.size()) {
-            return current;
-        }
+    if (shuffleOrderMatches(shuffle_, songIndex_, channel.songs.size())) {
+        return songIndex_;
     }
 
     std::size_t seedIndex = songIndex_;
@@ -3846,81 +6464,46 @@ std::optional<std::size_t> RadioEngine::ensureShuffleCurrentSongLocked(const Cha
         seedIndex = distribution(shuffleRng());
     }
 
-    resetShuffleHistoryLocked();
-    shuffleHistory_.push_back(seedIndex);
-    shuffleCursor_ = 0;
+    anchorShuffleOrderLocked(seedIndex, channel.songs.size());
     return seedIndex;
 }
 
 std::optional<std::size_t> RadioEngine::advanceShuffleSongLocked(const ChannelEntry& channel)
 {
-    if (channel.songs.empty()) {
-        return std::nullopt;
-    }
-
     const auto current = ensureShuffleCurrentSongLocked(channel);
     if (!current.has_value()) {
         return std::nullopt;
     }
 
-    if ((shuffleCursor_ + 1) < shuffleHistory_.size()) {
-        ++shuffleCursor_;
-        return shuffleHistory_[shuffleCursor_];
-    }
-
-    std::vector<bool> used(channel.songs.size(), false);
-    for (const auto index : shuffleHistory_) {
-        if (index < used.size()) {
-            used[index] = true;
-        }
-    }
-
-    std::vector<std::size_t> candidates;
-    for (std::size_t i = 0; i < channel.songs.size(); ++i) {
-        if (!used[i]) {
-            candidates.push_back(i);
-        }
-    }
-
-    if (candidates.empty()) {
-        resetShuffleHistoryLocked();
-        shuffleHistory_.push_back(*current);
-        shuffleCursor_ = 0;
-        for (std::size_t i = 0; i < channel.songs.size(); ++i) {
-            if (i != *current) {
-                candidates.push_back(i);
-            }
-        }
-    }
-
-    if (candidates.empty()) {
+    if (shuffle_.songCount <= 1) {
         return *current;
     }
 
-    std::uniform_int_distribution<std::size_t> distribution(0, candidates.size() - 1);
-    const std::size_t nextIndex = candidates[distribution(shuffleRng())];
-    shuffleHistory_.push_back(nextIndex);
-    shuffleCursor_ = shuffleHistory_.size() - 1;
-    return nextIndex;
+    if ((shuffle_.cursor + 1) < shuffle_.songCount) {
+        ++shuffle_.cursor;
+    } else {
+        ++shuffle_.epoch;
+        shuffle_.cursor = shuffleSkipsEpochLead(shuffle_, shuffle_.epoch) ? 1 : 0;
+    }
+    return shuffleSongAt(shuffle_, shuffle_.epoch, shuffle_.cursor);
 }
 
 std::optional<std::size_t> RadioEngine::retreatShuffleSongLocked(const ChannelEntry& channel)
 {
-    if (channel.songs.empty()) {
-        return std::nullopt;
-    }
-
     const auto current = ensureShuffleCurrentSongLocked(channel);
     if (!current.has_value()) {
         return std::nullopt;
     }
 
-    if (shuffleCursor_ > 0) {
-        --shuffleCursor_;
-        return shuffleHistory_[shuffleCursor_];
+    if (shuffle_.cursor > 1 || (shuffle_.cursor == 1 && !shuffleSkipsEpochLead(shuffle_, shuffle_.epoch))) {
+        --shuffle_.cursor;
+    } else if (shuffle_.epoch > 0) {
+        --shuffle_.epoch;
+        shuffle_.cursor = shuffle_.songCount - 1;
+    } else {
+        return *current;
     }
-
-    return *current;
+    return shuffleSongAt(shuffle_, shuffle_.epoch, shuffle_.cursor);
 }
 
 bool RadioEngine::updateTrackLocked(bool force)
@@ -3938,7 +6521,11 @@ bool RadioEngine::updateTrackLocked(bool force)
         if (!force && !isTrackCompleteLocked()) {
             return true;
         }
-        logger_.info("Stream ended/disconnected, reconnecting: " + channelIt->second.displayName);
+        if (config_.streamReconnect) {
+            beginStreamReconnectLocked(channelIt->second.streamUrl);
+            return true;
+        }
+        logger_.info([&]() { return "Stream ended/disconnected, reconnecting: " + channelIt->second.displayName; });
         return playStreamLocked(channelIt->second.streamUrl);
     }
 
@@ -3946,6 +6533,18 @@ bool RadioEngine::updateTrackLocked(bool force)
         return true;
     }
 
+    if (handoffPreloadedTrackLocked()) {
+        return true;
+    }
+
+    if (liveStationActiveLocked(channelIt->second)) {
+        const auto cue = liveCueLocked(channelIt->second, true);
+        if (cue.has_value()) {
+            resumePositionMs_ = cue->offsetMs;
+            return playPathLocked(cue->path);
+        }
+    }
+
     const auto nextTrack = advanceAndChooseNextTrackLocked();
     if (!nextTrack.has_value()) {
         stopPlaybackDeviceLocked(true);
@@ -3971,13 +6570,17 @@ bool RadioEngine::isTrackCompleteLocked()
             std::chrono::steady_clock::now() - trackStartTime_);
         const auto minProbeTime = (backend_ == PlaybackBackend::MediaFoundationStream ||
                                    backend_ == PlaybackBackend::DirectShowStream)
-            ? std::chrono::milliseconds(2500)
-            : std::chrono::milliseconds(800);
+            ? std::chrono::duration_cast<std::chrono::milliseconds>(kStreamCompletionProbeDelay)
+            : std::chrono::duration_cast<std::chrono::milliseconds>(kFileCompletionProbeDelay);
         if (elapsed < minProbeTime) {
             return false;
         }
     }
 
+    if (backend_ == PlaybackBackend::NativeMixer) {
+        return !mixer_ || mixerVoice_ == 0 || mixer_->finished(mixerVoice_);
+    }
+
     if (backend_ == PlaybackBackend::MediaFoundationStream) {
         if (!mfState_ || !mfState_->player) {
             logger_.warn("Media Foundation player missing while state=Playing. Treating stream as complete.");
@@ -3986,7 +6589,9 @@ bool RadioEngine::isTrackCompleteLocked()
         if (mfState_->events) {
             const HRESULT asyncHr = mfState_->events->lastError.load();
             if (FAILED(asyncHr)) {
-                logger_.warn("Media Foundation stream error while playing: " + formatHresult(asyncHr));
+                logger_.warn([&]() {
+                    return "Media Foundation stream error while playing: " + formatHresult(asyncHr);
+                });
                 return true;
             }
             if (mfState_->events->playbackEnded.load()) {
@@ -3998,7 +6603,13 @@ bool RadioEngine::isTrackCompleteLocked()
         MFP_MEDIAPLAYER_STATE playerState = MFP_MEDIAPLAYER_STATE_EMPTY;
         const HRESULT stateHr = mfState_->player->GetState(&playerState);
         if (FAILED(stateHr)) {
-            logger_.warn("Media Foundation GetState failed while playing: " + formatHresult(stateHr));
+            logger_.warn([&]() { return "Media Foundation GetState failed while playing: " + formatHresult(stateHr); });
+            return true;
+        }
+
+        if (playerState == MFP_MEDIAPLAYER_STATE_PLAYING && config_.streamReconnect && mfStreamStalledLocked()) {
+            logger_.warn("Media Foundation stream stalled; no progress for " +
+                         std::to_string(std::chrono::duration_cast<std::chrono::seconds>(kStreamStallTimeout).count()) + " s.");
             return true;
         }
 
@@ -4019,7 +6630,9 @@ bool RadioEngine::isTrackCompleteLocked()
             while (SUCCEEDED(dsState_->events->GetEvent(&eventCode, &param1, &param2, 0))) {
                 dsState_->events->FreeEventParams(eventCode, param1, param2);
                 if (eventCode == EC_COMPLETE || eventCode == EC_ERRORABORT) {
-                    logger_.warn("DirectShow stream event indicates completion/error: code=" + std::to_string(eventCode));
+                    logger_.warn([&]() {
+                        return "DirectShow stream event indicates completion/error: code=" + std::to_string(eventCode);
+                    });
                     return true;
                 }
             }
@@ -4028,7 +6641,7 @@ bool RadioEngine::isTrackCompleteLocked()
         OAFilterState filterState = State_Stopped;
         const HRESULT stateHr = dsState_->control->GetState(0, &filterState);
         if (FAILED(stateHr) && stateHr != VFW_S_STATE_INTERMEDIATE) {
-            logger_.warn("DirectShow GetState failed while playing: " + formatHresult(stateHr));
+            logger_.warn([&]() { return "DirectShow GetState failed while playing: " + formatHresult(stateHr); });
             return true;
         }
         if (stateHr == VFW_S_STATE_INTERMEDIATE) {
@@ -4133,37 +6746,375 @@ std::optional<std::filesystem::path> RadioEngine::advanceAndChooseNextTrackLocke
             return next;
         }
 
-        if (!channel.transitions.empty()) {
-            const std::filesystem::path next = channel.transitions[transitionIndex_ % channel.transitions.size()];
-            ++transitionIndex_;
-            previousWasSong_ = false;
-            return next;
-        }
+        if (!channel.transitions.empty()) {
+            const std::filesystem::path next = channel.transitions[transitionIndex_ % channel.transitions.size()];
+            ++transitionIndex_;
+            previousWasSong_ = false;
+            return next;
+        }
+
+        if (trackOrderMode_ == TrackOrderMode::Shuffle) {
+            const auto nextSong = advanceShuffleSongLocked(channel);
+            if (!nextSong.has_value()) {
+                return std::nullopt;
+            }
+            songIndex_ = *nextSong;
+        } else {
+            songIndex_ = (songIndex_ + 1) % channel.songs.size();
+        }
+        previousWasSong_ = true;
+        return channel.songs[songIndex_];
+    }
+
+    if (trackOrderMode_ == TrackOrderMode::Shuffle) {
+        const auto nextSong = advanceShuffleSongLocked(channel);
+        if (!nextSong.has_value()) {
+            return std::nullopt;
+        }
+        songIndex_ = *nextSong;
+    } else {
+        songIndex_ = (songIndex_ + 1) % channel.songs.size();
+    }
+    previousWasSong_ = true;
+    return channel.songs[songIndex_];
+}
+
+RadioEngine::TrackSequenceState RadioEngine::captureTrackSequenceLocked() const
+{
+    TrackSequenceState sequence;
+    sequence.songIndex = songIndex_;
+    sequence.transitionIndex = transitionIndex_;
+    sequence.adIndex = adIndex_;
+    sequence.songsSinceAd = songsSinceAd_;
+    sequence.previousWasSong = previousWasSong_;
+    sequence.shuffle = shuffle_;
+    return sequence;
+}
+
+void RadioEngine::restoreTrackSequenceLocked(const TrackSequenceState& sequence)
+{
+    songIndex_ = sequence.songIndex;
+    transitionIndex_ = sequence.transitionIndex;
+    adIndex_ = sequence.adIndex;
+    songsSinceAd_ = sequence.songsSinceAd;
+    previousWasSong_ = sequence.previousWasSong;
+    shuffle_ = sequence.shuffle;
+}
+
+bool RadioEngine::liveStationActiveLocked(const ChannelEntry& channel) const
+{
+    return config_.liveStations && mode_ == PlaybackMode::Station && channel.type == ChannelType::Station &&
+           !channel.isStream && !channel.songs.empty();
+}
+
+const RadioEngine::LiveTimeline& RadioEngine::liveTimelineLocked(const ChannelEntry& channel)
+{
+    const auto cachedIt = liveTimelines_.find(channel.key);
+    if (cachedIt != liveTimelines_.end()) {
+        return cachedIt->second;
+    }
+
+    const auto indexIt = libraryIndex_.find(channel.key);
+    const auto durationMs = [&indexIt, this](const TrackList& tracks, std::size_t index, std::uint64_t fallbackMs) {
+        if (indexIt != libraryIndex_.end()) {
+            const auto analysisIt = indexIt->second.analysis.find(wideToUtf8(std::wstring(tracks.fileName(index))));
+            if (analysisIt != indexIt->second.analysis.end() && analysisIt->second.durationMs > 0) {
+                return analysisIt->second.durationMs;
+            }
+        }
+        return fallbackMs;
+    };
+
+    LiveTimeline timeline;
+    const std::uint64_t seed = splitMix64(stableHash(channel.key));
+    const std::size_t songCount = channel.songs.size();
+    std::size_t nextTransition = 0;
+    std::size_t nextAd = 0;
+    timeline.slots.reserve(songCount * 2);
+    for (std::size_t position = 0; position < songCount; ++position) {
+        const std::size_t songIndex = shufflePermute(seed, 0, songCount, position, false);
+        timeline.slots.push_back({ TrackKind::Song, songIndex, timeline.cycleMs });
+        timeline.cycleMs += durationMs(channel.songs, songIndex, kLiveFallbackSongMs);
+
+        const bool playAd = !channel.ads.empty() && config_.adIntervalSongs > 0 &&
+                            (position + 1) % config_.adIntervalSongs == 0;
+        if (playAd) {
+            const std::size_t adIndex = nextAd++ % channel.ads.size();
+            timeline.slots.push_back({ TrackKind::Ad, adIndex, timeline.cycleMs });
+            timeline.cycleMs += durationMs(channel.ads, adIndex, kLiveFallbackClipMs);
+        } else if (!channel.transitions.empty()) {
+            const std::size_t transitionIndex = nextTransition++ % channel.transitions.size();
+            timeline.slots.push_back({ TrackKind::Transition, transitionIndex, timeline.cycleMs });
+            timeline.cycleMs += durationMs(channel.transitions, transitionIndex, kLiveFallbackClipMs);
+        }
+    }
+    timeline.phaseMs = timeline.cycleMs > 0 ? splitMix64(seed) % timeline.cycleMs : 0;
+
+    logger_.info([&]() {
+        return "Live timeline for '" + channel.displayName + "': " + std::to_string(timeline.slots.size()) +
+               " slot(s), cycle " + std::to_string(timeline.cycleMs / 1000) + " s.";
+    });
+    return liveTimelines_[channel.key] = std::move(timeline);
+}
+
+std::optional<RadioEngine::LiveCue> RadioEngine::liveCueLocked(const ChannelEntry& channel, bool skipCurrentTrack)
+{
+    const LiveTimeline& timeline = liveTimelineLocked(channel);
+    if (timeline.slots.empty() || timeline.cycleMs == 0) {
+        return std::nullopt;
+    }
+
+    // The wall clock, not steady_clock, so a station carries on from where it was across sessions.
+    const auto sinceEpoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    const std::uint64_t nowMs = static_cast<std::uint64_t>(std::max<long long>(0, sinceEpoch.count()));
+    const std::uint64_t cycleOffset = (nowMs + timeline.phaseMs) % timeline.cycleMs;
+
+    const auto slotIt = std::upper_bound(
+        timeline.slots.begin(), timeline.slots.end(), cycleOffset, [](std::uint64_t offset, const LiveTimeline::Slot& slot) {
+            return offset < slot.startMs;
+        });
+    std::size_t slotIndex = static_cast<std::size_t>(std::distance(timeline.slots.begin(), slotIt)) - 1;
+
+    const auto slotPath = [&channel](const LiveTimeline::Slot& slot) {
+        switch (slot.kind) {
+        case TrackKind::Transition:
+            return channel.transitions[slot.index];
+        case TrackKind::Ad:
+            return channel.ads[slot.index];
+        default:
+            return channel.songs[slot.index];
+        }
+    };
+
+    const std::uint64_t slotEndMs =
+        slotIndex + 1 < timeline.slots.size() ? timeline.slots[slotIndex + 1].startMs : timeline.cycleMs;
+    LiveCue cue;
+    cue.path = slotPath(timeline.slots[slotIndex]);
+    cue.offsetMs = cycleOffset - timeline.slots[slotIndex].startMs;
+
+    // Estimated durations can leave the clock inside the slot that just finished playing.
+    const bool nearEnd = slotEndMs - cycleOffset < kLiveMinimumTailMs;
+    if (nearEnd || (skipCurrentTrack && cue.path == currentTrackPath_)) {
+        slotIndex = (slotIndex + 1) % timeline.slots.size();
+        cue.path = slotPath(timeline.slots[slotIndex]);
+        cue.offsetMs = 0;
+    }
+    return cue;
+}
+
+bool RadioEngine::startLiveStationLocked(const ChannelEntry& channel)
+{
+    const auto cue = liveCueLocked(channel, false);
+    if (!cue.has_value()) {
+        logger_.warn([&]() { return "Live station has no timeline: " + channel.displayName; });
+        return false;
+    }
+
+    logger_.info([&]() {
+        return "Tuning in live: " + pathToUtf8(cue->path) + " at " + std::to_string(cue->offsetMs / 1000) + " s.";
+    });
+    resumePositionMs_ = cue->offsetMs;
+    return playPathLocked(cue->path);
+}
+
+std::optional<int> RadioEngine::remainingTrackMsLocked()
+{
+    if (backend_ != PlaybackBackend::MCI) {
+        return std::nullopt;
+    }
+
+    // Polled every tick, so query silently instead of logging through mciCommandLocked.
+    const auto statusNumber = [this](const wchar_t* statusName) -> std::optional<int> {
+        std::array<wchar_t, 64> buffer{};
+        const MCIERROR err = mciSend(
+            L"status " + activeAlias_ + L" " + statusName,
+            buffer.data(),
+            static_cast<UINT>(buffer.size()));
+        if (err != 0) {
+            return std::nullopt;
+        }
+        try {
+            return std::stoi(std::wstring(buffer.data()));
+        } catch (...) {
+            return std::nullopt;
+        }
+    };
+
+    // A decoded length is exact; MCI's is an estimate for VBR files without a Xing header. Either
+    // is fixed for the open track, so MCI is asked once per track and alias.
+    const TrackAnalysis* analysis = currentTrackAnalysisLocked();
+    std::optional<int> lengthMs;
+    if (analysis != nullptr && analysis->durationMs > 0) {
+        lengthMs = static_cast<int>(std::min<std::uint64_t>(analysis->durationMs, std::numeric_limits<int>::max()));
+    } else if (trackLength_.lengthMs > 0 && trackLength_.alias == activeAlias_ && trackLength_.path == currentTrackPath_) {
+        lengthMs = trackLength_.lengthMs;
+    } else {
+        lengthMs = statusNumber(L"length");
+        if (lengthMs.has_value() && *lengthMs > 0) {
+            trackLength_ = TrackLengthCache{ activeAlias_, currentTrackPath_, *lengthMs };
+        }
+    }
+    const auto positionMs = statusNumber(L"position");
+    if (!lengthMs.has_value() || *lengthMs <= 0 || !positionMs.has_value()) {
+        return std::nullopt;
+    }
+    return std::max(0, *lengthMs - *positionMs);
+}
+
+void RadioEngine::maybePreloadNextTrackLocked(int remainingMs)
+{
+    if (preload_.valid || state_ != PlaybackState::Playing || backend_ != PlaybackBackend::MCI) {
+        return;
+    }
+    if (remainingMs > kPreloadLeadTimeMs || preload_.attemptedTrack == currentTrackPath_) {
+        return;
+    }
+    preload_.attemptedTrack = currentTrackPath_;
+
+    const auto channelIt = channels_.find(selectedKey_);
+    if (channelIt == channels_.end() || channelIt->second.isStream) {
+        return;
+    }
+
+    // Resolve the next track exactly as a normal advance would (including the shuffle draw), keep
+    // the post-advance sequence for the handoff, and leave the live sequence untouched until then.
+    // A live station preloads its next slot only when that slot starts from the top.
+    const TrackSequenceState before = captureTrackSequenceLocked();
+    std::optional<std::filesystem::path> nextTrack;
+    if (liveStationActiveLocked(channelIt->second)) {
+        const auto cue = liveCueLocked(channelIt->second, true);
+        if (cue.has_value() && cue->offsetMs == 0) {
+            nextTrack = cue->path;
+        }
+    } else {
+        nextTrack = advanceAndChooseNextTrackLocked();
+    }
+    const TrackSequenceState after = captureTrackSequenceLocked();
+    restoreTrackSequenceLocked(before);
+    if (!nextTrack.has_value()) {
+        return;
+    }
+
+    const std::wstring standbyAlias = standbyAliasLocked();
+    (void)mciSend(L"close " + standbyAlias);
+    standbyDraining_ = false;
+
+    const std::wstring quotedPath = quoteForMCI(*nextTrack);
+    bool opened = mciSend(L"open " + quotedPath + L" alias " + standbyAlias) == 0;
+    if (!opened) {
+        opened = mciSend(L"open " + quotedPath + L" type mpegvideo alias " + standbyAlias) == 0;
+    }
+    if (!opened) {
+        // Not fatal: the handoff falls back to the cold open path and its Media Foundation fallback.
+        logger_.warn([&]() { return "Preload open failed, next track will start cold: " + pathToUtf8(*nextTrack); });
+        return;
+    }
+
+    (void)mciSend(L"set " + standbyAlias + L" time format milliseconds");
+
+    preload_.valid = true;
+    preload_.path = *nextTrack;
+    preload_.deviceId = currentDeviceId_;
+    preload_.selectedKey = selectedKey_;
+    preload_.trackOrderMode = trackOrderMode_;
+    preload_.sequenceAfter = after;
+    if (config_.logFadeChanges) {
+        logger_.info([&]() { return "Preloaded next track: " + pathToUtf8(*nextTrack); });
+    }
+}
+
+bool RadioEngine::handoffPreloadedTrackLocked()
+{
+    if (!preload_.valid) {
+        return false;
+    }
+
+    if (preload_.deviceId != currentDeviceId_ ||
+        preload_.selectedKey != selectedKey_ ||
+        preload_.trackOrderMode != trackOrderMode_ ||
+        backend_ != PlaybackBackend::MCI) {
+        discardPreloadLocked();
+        return false;
+    }
+
+    const std::wstring previousAlias = activeAlias_;
+    const std::filesystem::path nextPath = preload_.path;
+    const TrackSequenceState sequence = preload_.sequenceAfter;
+    preload_ = PreloadedTrack{};
+
+    // Swap first so volume/pan for the new track are written before it becomes audible.
+    activeAlias_ = standbyAliasLocked();
+    lastVolume_ = -1;
+    lastLeftVolume_ = -1;
+    lastRightVolume_ = -1;
+    updateFadeVolumeLocked();
+
+    if (!mciPlayLocked(L"play " + activeAlias_)) {
+        (void)mciSend(L"close " + activeAlias_);
+        activeAlias_ = previousAlias;
+        logger_.warn([&]() { return "Gapless handoff failed, reopening next track: " + pathToUtf8(nextPath); });
+        restoreTrackSequenceLocked(sequence);
+        resumePositionMs_ = 0;
+        return playPathLocked(nextPath);
+    }
+
+    // The handoff starts ahead of the end, so the previous track keeps playing out what is left;
+    // its alias, now the standby, is closed once MCI reports it finished.
+    standbyDraining_ = true;
+
+    restoreTrackSequenceLocked(sequence);
+    resumePositionMs_ = 0;
+    currentTrackPath_ = nextPath;
+    state_ = PlaybackState::Playing;
+    trackStartTime_ = std::chrono::steady_clock::now();
+    trackStartValid_ = true;
+    nextPlaybackPollTime_ = trackStartTime_ + kStandbyDrainPoll;
+    stopFxLocked();
+
+    logger_.info([&]() { return "Now playing (gapless): " + pathToUtf8(nextPath); });
+    return true;
+}
+
+void RadioEngine::discardPreloadLocked()
+{
+    if (preload_.valid) {
+        (void)mciSend(L"close " + standbyAliasLocked());
+    }
+    preload_ = PreloadedTrack{};
+}
 
-        if (trackOrderMode_ == TrackOrderMode::Shuffle) {
-            const auto nextSong = advanceShuffleSongLocked(channel);
-            if (!nextSong.has_value()) {
-                return std::nullopt;
-            }
-            songIndex_ = *nextSong;
-        } else {
-            songIndex_ = (songIndex_ + 1) % channel.songs.size();
-        }
-        previousWasSong_ = true;
-        return channel.songs[songIndex_];
+// force closes the previous track even if it is still playing its last few milliseconds.
+void RadioEngine::closeDrainedStandbyLocked(const std::vector<unsigned int>& notifiedMciDevices, bool force)
+{
+    if (!standbyDraining_) {
+        return;
     }
 
-    if (trackOrderMode_ == TrackOrderMode::Shuffle) {
-        const auto nextSong = advanceShuffleSongLocked(channel);
-        if (!nextSong.has_value()) {
-            return std::nullopt;
-        }
-        songIndex_ = *nextSong;
-    } else {
-        songIndex_ = (songIndex_ + 1) % channel.songs.size();
+    const std::wstring standbyAlias = standbyAliasLocked();
+    bool finished = force;
+    if (!finished) {
+        const unsigned int standbyDevice = playbackHooks_.mciDeviceId(standbyAlias.c_str());
+        finished = standbyDevice == 0 ||
+                   std::find(notifiedMciDevices.begin(), notifiedMciDevices.end(), standbyDevice) != notifiedMciDevices.end();
     }
-    previousWasSong_ = true;
-    return channel.songs[songIndex_];
+    if (!finished) {
+        std::array<wchar_t, 128> mode{};
+        finished = mciSend(L"status " + standbyAlias + L" mode", mode.data(), static_cast<UINT>(mode.size())) != 0 ||
+                   std::wstring(mode.data()) != L"playing";
+    }
+    if (!finished) {
+        return;
+    }
+
+    (void)mciSend(L"stop " + standbyAlias);
+    (void)mciSend(L"close " + standbyAlias);
+    standbyDraining_ = false;
+}
+
+std::wstring RadioEngine::standbyAliasLocked() const
+{
+    return activeAlias_ == primaryAlias_ ? secondaryAlias_ : primaryAlias_;
 }
 
 void RadioEngine::updateFadeVolumeLocked()
@@ -4173,7 +7124,25 @@ void RadioEngine::updateFadeVolumeLocked()
     }
 
     DeviceState& device = ensureDeviceStateLocked(currentDeviceId_);
-    const double distance = distanceLocked();
+    const auto now = std::chrono::steady_clock::now();
+    const bool engineRamp = config_.fadeUpdateHz > 0.0F;
+
+    // Between sparse Papyrus samples the engine extrapolates motion and eases toward each new target.
+    Position emitter = emitterPosition_;
+    Position player = playerPosition_;
+    float playerYawDeg = playerYawDeg_;
+    bool extrapolating = false;
+    if (engineRamp) {
+        extrapolating = predictMotion(
+            device.fadeMotion,
+            now,
+            std::chrono::milliseconds(static_cast<long long>(config_.fadeMaxExtrapolationMs)),
+            emitter,
+            player,
+            playerYawDeg);
+    }
+
+    const double distance = distanceBetween(emitter, player);
     const float minDist = device.fadeOverride.enabled ? device.fadeOverride.minDistance : config_.minFadeDistance;
     const float maxDist = device.fadeOverride.enabled ? device.fadeOverride.maxDistance : config_.maxFadeDistance;
     const float panDist = device.fadeOverride.enabled ? device.fadeOverride.panDistance : config_.panDistance;
@@ -4190,21 +7159,45 @@ void RadioEngine::updateFadeVolumeLocked()
     }
 
     const double gain = std::clamp(static_cast<double>(device.volumeGain), 0.0, 2.0);
-    const int volume = static_cast<int>(std::lround(std::clamp(factor * gain, 0.0, 1.0) * 1000.0));
-
-    double pan = 0.0;
-    int leftVolume = volume;
-    int rightVolume = volume;
-    if (config_.enableSpatialPan && panDist > kMinimumFadeGap) {
-        const double dx = static_cast<double>(emitterPosition_.x) - static_cast<double>(playerPosition_.x);
-        const double dy = static_cast<double>(emitterPosition_.y) - static_cast<double>(playerPosition_.y);
+    const bool spatialPan = config_.enableSpatialPan && panDist > kMinimumFadeGap;
+    const double targetLevel = std::clamp(factor * gain * trackNormalizationGainLocked(), 0.0, 1.0);
+    double targetPan = 0.0;
+    if (spatialPan) {
+        const double dx = static_cast<double>(emitter.x) - static_cast<double>(player.x);
+        const double dy = static_cast<double>(emitter.y) - static_cast<double>(player.y);
         const double yawRadians =
-            static_cast<double>(playerYawDeg_) * (std::acos(-1.0) / 180.0);
+            static_cast<double>(playerYawDeg) * (std::acos(-1.0) / 180.0);
         const double rightX = std::cos(yawRadians);
         const double rightY = -std::sin(yawRadians);
         const double localRight = (dx * rightX) + (dy * rightY);
-        pan = std::clamp(localRight / static_cast<double>(panDist), -1.0, 1.0);
-
+        targetPan = std::clamp(localRight / static_cast<double>(panDist), -1.0, 1.0);
+    }
+
+    FadeMotion& motion = device.fadeMotion;
+    double level = targetLevel;
+    double pan = targetPan;
+    if (engineRamp && config_.fadeSmoothingMs > 0.0F && motion.smoothedValid) {
+        // Exponential ease; a long gap (first sample after a stop) collapses to a snap on its own.
+        const double elapsedMs = std::max(0.0, std::chrono::duration<double, std::milli>(now - motion.lastRampTime).count());
+        const double alpha = 1.0 - std::exp(-elapsedMs / static_cast<double>(config_.fadeSmoothingMs));
+        level = motion.level + ((targetLevel - motion.level) * alpha);
+        pan = motion.pan + ((targetPan - motion.pan) * alpha);
+    }
+    const bool converged = std::abs(level - targetLevel) < kFadeSettleEpsilon && std::abs(pan - targetPan) < kFadeSettleEpsilon;
+    if (converged) {
+        level = targetLevel;
+        pan = targetPan;
+    }
+    motion.level = level;
+    motion.pan = pan;
+    motion.smoothedValid = true;
+    motion.lastRampTime = now;
+    motion.settled = converged && !extrapolating;
+
+    const int volume = static_cast<int>(std::lround(level * 1000.0));
+    int leftVolume = volume;
+    int rightVolume = volume;
+    if (spatialPan) {
         // Equal-power stereo pan curve for smoother perceived loudness.
         const double angle = (pan + 1.0) * (std::acos(-1.0) / 4.0);
         leftVolume = static_cast<int>(std::lround(static_cast<double>(volume) * std::cos(angle)));
@@ -4218,22 +7211,30 @@ void RadioEngine::updateFadeVolumeLocked()
     }
 
     bool ok = true;
-    if (backend_ == PlaybackBackend::MediaFoundationStream) {
+    if (backend_ == PlaybackBackend::NativeMixer) {
+        if (!mixer_ || !mixer_->setLevelPan(mixerVoice_, static_cast<float>(level), static_cast<float>(pan))) {
+            return;
+        }
+    } else if (backend_ == PlaybackBackend::MediaFoundationStream) {
         if (!mfState_ || !mfState_->player) {
-            logger_.warn("Media Foundation player missing while applying volume.");
+            // A reconnect owns the device until its new player plays; markStreamPlayingLocked
+            // applies the volume then.
+            if (!streamReconnect_) {
+                logger_.warn("Media Foundation player missing while applying volume.");
+            }
             return;
         }
 
-        const float streamVolume = static_cast<float>(std::clamp(factor * gain, 0.0, 1.0));
+        const float streamVolume = static_cast<float>(level);
         const HRESULT hr = mfState_->player->SetVolume(streamVolume);
         if (FAILED(hr)) {
-            logger_.warn("Media Foundation SetVolume failed: " + formatHresult(hr));
+            logger_.warn([&]() { return "Media Foundation SetVolume failed: " + formatHresult(hr); });
             return;
         }
         const float streamBalance = static_cast<float>(std::clamp(pan, -1.0, 1.0));
         const HRESULT balanceHr = mfState_->player->SetBalance(streamBalance);
         if (FAILED(balanceHr)) {
-            logger_.warn("Media Foundation SetBalance failed: " + formatHresult(balanceHr));
+            logger_.warn([&]() { return "Media Foundation SetBalance failed: " + formatHresult(balanceHr); });
             return;
         }
     } else if (backend_ == PlaybackBackend::DirectShowStream) {
@@ -4242,7 +7243,7 @@ void RadioEngine::updateFadeVolumeLocked()
             rightVolume = volume;
         } else {
             long dsVolume = -10000;
-            const double scalar = std::clamp(factor * gain, 0.0, 1.0);
+            const double scalar = level;
             if (scalar > 0.0001) {
                 dsVolume = static_cast<long>(std::lround(2000.0 * std::log10(scalar)));
                 dsVolume = std::clamp(dsVolume, static_cast<long>(-10000), static_cast<long>(0));
@@ -4250,7 +7251,7 @@ void RadioEngine::updateFadeVolumeLocked()
 
             const HRESULT hr = dsState_->audio->put_Volume(dsVolume);
             if (FAILED(hr)) {
-                logger_.warn("DirectShow put_Volume failed: " + formatHresult(hr));
+                logger_.warn([&]() { return "DirectShow put_Volume failed: " + formatHresult(hr); });
                 return;
             }
 
@@ -4258,27 +7259,27 @@ void RadioEngine::updateFadeVolumeLocked()
                 static_cast<long>(std::lround(std::clamp(pan, -1.0, 1.0) * 10000.0));
             const HRESULT balanceHr = dsState_->audio->put_Balance(dsBalance);
             if (FAILED(balanceHr)) {
-                logger_.warn("DirectShow put_Balance failed: " + formatHresult(balanceHr));
+                logger_.warn([&]() { return "DirectShow put_Balance failed: " + formatHresult(balanceHr); });
                 return;
             }
         }
     } else if (config_.enableSpatialPan && panControlsAvailable_) {
         const bool leftOk =
-            mciCommandLocked(L"setaudio " + std::wstring(kAlias) + L" left volume to " + std::to_wstring(leftVolume));
+            mciCommandLocked(L"setaudio " + activeAlias_ + L" left volume to " + std::to_wstring(leftVolume));
         const bool rightOk =
-            mciCommandLocked(L"setaudio " + std::wstring(kAlias) + L" right volume to " + std::to_wstring(rightVolume));
+            mciCommandLocked(L"setaudio " + activeAlias_ + L" right volume to " + std::to_wstring(rightVolume));
         if (!leftOk || !rightOk) {
             panControlsAvailable_ = false;
             if (!panUnavailableLogged_) {
                 panUnavailableLogged_ = true;
                 logger_.warn("Stereo pan controls unavailable on this playback device. Falling back to scalar volume fade.");
             }
-            ok = mciCommandLocked(L"setaudio " + std::wstring(kAlias) + L" volume to " + std::to_wstring(volume));
+            ok = mciCommandLocked(L"setaudio " + activeAlias_ + L" volume to " + std::to_wstring(volume));
             leftVolume = volume;
             rightVolume = volume;
         }
     } else {
-        ok = mciCommandLocked(L"setaudio " + std::wstring(kAlias) + L" volume to " + std::to_wstring(volume));
+        ok = mciCommandLocked(L"setaudio " + activeAlias_ + L" volume to " + std::to_wstring(volume));
         leftVolume = volume;
         rightVolume = volume;
     }
@@ -4292,22 +7293,74 @@ void RadioEngine::updateFadeVolumeLocked()
     lastRightVolume_ = rightVolume;
 
     if (config_.logFadeChanges) {
-        logger_.info(
-            "Fade update: distance=" + std::to_string(distance) +
-            " baseVol=" + std::to_string(volume) +
-            " leftVol=" + std::to_string(leftVolume) +
-            " rightVol=" + std::to_string(rightVolume) +
-            " pan=" + std::to_string(pan) +
-            " gain=" + std::to_string(device.volumeGain));
+        logger_.info([&]() {
+            return "Fade update: distance=" + std::to_string(distance) +
+                   " baseVol=" + std::to_string(volume) +
+                   " leftVol=" + std::to_string(leftVolume) +
+                   " rightVol=" + std::to_string(rightVolume) +
+                   " pan=" + std::to_string(pan) +
+                   " gain=" + std::to_string(device.volumeGain);
+        });
     }
 }
 
-double RadioEngine::distanceLocked() const
+void RadioEngine::recordMotionSample(FadeMotion& motion, const PendingPositionSample& sample)
 {
-    const double dx = static_cast<double>(playerPosition_.x) - static_cast<double>(emitterPosition_.x);
-    const double dy = static_cast<double>(playerPosition_.y) - static_cast<double>(emitterPosition_.y);
-    const double dz = static_cast<double>(playerPosition_.z) - static_cast<double>(emitterPosition_.z);
-    return std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    MotionSample& slot = motion.history[motion.nextSlot];
+    slot.time = std::chrono::steady_clock::now();
+    slot.emitter = sample.emitter;
+    slot.player = sample.player;
+    slot.playerYawDeg = sample.playerYawDeg;
+    motion.nextSlot = (motion.nextSlot + 1) % motion.history.size();
+    motion.sampleCount = std::min(motion.sampleCount + 1, motion.history.size());
+    motion.settled = false;
+}
+
+bool RadioEngine::predictMotion(
+    const FadeMotion& motion,
+    std::chrono::steady_clock::time_point now,
+    std::chrono::milliseconds maxExtrapolation,
+    Position& emitter,
+    Position& player,
+    float& playerYawDeg)
+{
+    if (motion.sampleCount < 2 || maxExtrapolation.count() <= 0) {
+        return false;
+    }
+
+    // Velocity across the whole window damps jitter between individual Papyrus samples.
+    const std::size_t size = motion.history.size();
+    const MotionSample& newest = motion.history[(motion.nextSlot + size - 1) % size];
+    const MotionSample& oldest = motion.history[(motion.nextSlot + size - motion.sampleCount) % size];
+    const double spanSeconds = std::chrono::duration<double>(newest.time - oldest.time).count();
+    if (spanSeconds <= 0.0) {
+        return false;
+    }
+
+    const auto sinceNewest = now - newest.time;
+    if (sinceNewest >= maxExtrapolation) {
+        return false;
+    }
+    const double horizon = std::max(0.0, std::chrono::duration<double>(sinceNewest).count());
+    const double scale = horizon / spanSeconds;
+    auto extrapolate = [scale](const Position& from, const Position& to) {
+        return Position{
+            static_cast<float>(to.x + ((to.x - from.x) * scale)),
+            static_cast<float>(to.y + ((to.y - from.y) * scale)),
+            static_cast<float>(to.z + ((to.z - from.z) * scale))
+        };
+    };
+    emitter = extrapolate(oldest.emitter, newest.emitter);
+    player = extrapolate(oldest.player, newest.player);
+
+    const double yawDelta = std::fmod(static_cast<double>(newest.playerYawDeg - oldest.playerYawDeg) + 540.0, 360.0) - 180.0;
+    playerYawDeg = static_cast<float>(newest.playerYawDeg + (yawDelta * scale));
+
+    const bool moving =
+        distanceBetween(oldest.emitter, newest.emitter) > 0.001 ||
+        distanceBetween(oldest.player, newest.player) > 0.001 ||
+        std::abs(yawDelta) > 0.01;
+    return moving;
 }
 
 std::filesystem::path RadioEngine::sessionStatePathLocked() const
@@ -4317,6 +7370,11 @@ std::filesystem::path RadioEngine::sessionStatePathLocked() const
 
 bool RadioEngine::loadPersistentSessionLocked()
 {
+    // Whatever gets loaded replaces the device set the writer last saw.
+    sessionFullRebuildPending_ = true;
+    sessionDirtyDevices_.clear();
+    statusFullRebuildPending_ = true;
+
     const auto path = sessionStatePathLocked();
     if (!std::filesystem::exists(path)) {
         return false;
@@ -4324,7 +7382,7 @@ bool RadioEngine::loadPersistentSessionLocked()
 
     std::ifstream in(path);
     if (!in.is_open()) {
-        logger_.warn("Could not open session file: " + pathToUtf8(path));
+        logger_.warn([&]() { return "Could not open session file: " + pathToUtf8(path); });
         return false;
     }
 
@@ -4386,9 +7444,25 @@ bool RadioEngine::loadPersistentSessionLocked()
         if (const auto volume = jsonFieldDouble(object, "volume_percent"); volume.has_value()) {
             state.volumeGain = std::clamp(static_cast<float>(*volume / 100.0), 0.0F, 2.0F);
         }
-        state.shuffleHistory = jsonFieldIndexArray(object, "shuffle_history");
-        if (const auto cursor = jsonFieldInt(object, "shuffle_cursor"); cursor.has_value() && *cursor >= 0) {
-            state.shuffleCursor = static_cast<std::size_t>(*cursor);
+        // Sessions from before seeded shuffle only carry shuffle_history; those re-anchor on song_index.
+        if (const auto seed = jsonFieldString(object, "shuffle_seed"); seed.has_value() && !seed->empty()) {
+            try {
+                state.shuffle.seed = std::stoull(*seed, nullptr, 0);
+                const auto epoch = jsonFieldInt(object, "shuffle_epoch").value_or(0);
+                const auto cursor = jsonFieldInt(object, "shuffle_cursor").value_or(0);
+                const auto offset = jsonFieldInt(object, "shuffle_offset").value_or(0);
+                const auto songCount = jsonFieldInt(object, "shuffle_song_count").value_or(0);
+                if (epoch >= 0 && cursor >= 0 && offset >= 0 && songCount > 0 && offset < songCount) {
+                    state.shuffle.epoch = static_cast<std::uint64_t>(epoch);
+                    state.shuffle.cursor = static_cast<std::size_t>(cursor);
+                    state.shuffle.offset = static_cast<std::size_t>(offset);
+                    state.shuffle.songCount = static_cast<std::size_t>(songCount);
+                } else {
+                    state.shuffle = {};
+                }
+            } catch (...) {
+                state.shuffle = {};
+            }
         }
         state.fadeOverride.enabled = false;
         state.panControlsAvailable = true;
@@ -4402,17 +7476,13 @@ bool RadioEngine::loadPersistentSessionLocked()
 
             const std::string trackName = jsonFieldString(object, "current_track_name").value_or(std::string{});
             const std::string trackKind = jsonFieldString(object, "current_track_kind").value_or(std::string{});
-            auto resolveTrack = [&channel, &trackName](const std::vector<std::filesystem::path>& paths) -> std::filesystem::path {
-                if (trackName.empty()) {
+            const std::string trackNeedle = toLower(trackName);
+            auto resolveTrack = [&trackNeedle](const TrackList& tracks) -> std::filesystem::path {
+                if (trackNeedle.empty()) {
                     return {};
                 }
-                const std::string needle = toLower(trackName);
-                for (const auto& pathEntry : paths) {
-                    if (toLower(pathToUtf8(pathEntry.filename())) == needle) {
-                        return pathEntry;
-                    }
-                }
-                return {};
+                const auto found = tracks.findByFileName(trackNeedle);
+                return found.has_value() ? tracks[*found] : std::filesystem::path{};
             };
 
             if (!channel.isStream) {
@@ -4434,27 +7504,15 @@ bool RadioEngine::loadPersistentSessionLocked()
                     state.songIndex = channel.songs.empty() ? 0 : (channel.songs.size() - 1);
                 }
 
-                std::vector<std::size_t> filteredHistory;
-                filteredHistory.reserve(state.shuffleHistory.size());
-                for (const auto index : state.shuffleHistory) {
-                    if (index < channel.songs.size()) {
-                        filteredHistory.push_back(index);
-                    }
-                }
-                state.shuffleHistory = std::move(filteredHistory);
-                if (state.trackOrderMode == TrackOrderMode::Shuffle && state.shuffleHistory.empty() && !channel.songs.empty()) {
-                    state.shuffleHistory.push_back(state.songIndex);
-                }
-                if (state.shuffleCursor >= state.shuffleHistory.size()) {
-                    state.shuffleCursor = state.shuffleHistory.empty() ? 0 : (state.shuffleHistory.size() - 1);
+                if (!shuffleOrderMatches(state.shuffle, state.songIndex, channel.songs.size())) {
+                    state.shuffle = {};
                 }
             }
         } else {
             state.selectedKey.clear();
             state.currentTrackPath.clear();
             state.resumePositionMs = 0;
-            state.shuffleHistory.clear();
-            state.shuffleCursor = 0;
+            state.shuffle = {};
         }
 
         deviceStates_[deviceId] = std::move(state);
@@ -4462,131 +7520,498 @@ bool RadioEngine::loadPersistentSessionLocked()
     }
 
     if (restoredCount > 0) {
-        logger_.info("Loaded radio session state for " + std::to_string(restoredCount) + " device(s).");
+        logger_.info([&]() {
+            return "Loaded radio session state for " + std::to_string(restoredCount) + " device(s).";
+        });
     }
     return restoredCount > 0;
 }
 
-bool RadioEngine::savePersistentSessionLocked()
+std::optional<RadioEngine::SessionDeviceRecord> RadioEngine::makeSessionRecordLocked(const DeviceState& state) const
 {
-    syncResumePositionFromBackendLocked();
-    syncCurrentDeviceStateLocked();
+    const bool hasMeaningfulState =
+        !state.selectedKey.empty() ||
+        !state.currentTrackPath.empty() ||
+        state.resumePositionMs > 0 ||
+        state.mediaType != 1 ||
+        state.trackOrderMode != TrackOrderMode::Alphabetical ||
+        std::abs(state.volumeGain - 1.0F) > 0.001F;
+    if (!hasMeaningfulState) {
+        return std::nullopt;
+    }
+
+    const auto channelIt = channels_.find(state.selectedKey);
+    std::string trackKind = "song";
+    if (channelIt != channels_.end() && !state.currentTrackPath.empty()) {
+        const auto& channel = channelIt->second;
+        const auto fileName = toLower(pathToUtf8(state.currentTrackPath.filename()));
+        if (channel.transitions.findByFileName(fileName).has_value()) {
+            trackKind = "transition";
+        } else if (channel.ads.findByFileName(fileName).has_value()) {
+            trackKind = "ad";
+        }
+    }
+
+    SessionDeviceRecord record;
+    record.mediaType = std::clamp(state.mediaType, 1, 3);
+    record.playMode = static_cast<std::int32_t>(state.trackOrderMode);
+    record.selectedKey = state.selectedKey;
+    record.currentTrackName = pathToUtf8(state.currentTrackPath.filename());
+    record.currentTrackKind = std::move(trackKind);
+    record.resumePositionMs = state.resumePositionMs;
+    record.songIndex = state.songIndex;
+    record.transitionIndex = state.transitionIndex;
+    record.adIndex = state.adIndex;
+    record.songsSinceAd = state.songsSinceAd;
+    record.previousWasSong = state.previousWasSong;
+    record.volumePercent = std::clamp(state.volumeGain * 100.0F, 0.0F, 200.0F);
+    record.shuffle = state.shuffle;
+    return record;
+}
+
+RadioEngine::DeviceStatus RadioEngine::makeDeviceStatusLocked(const DeviceState& state) const
+{
+    DeviceStatus status;
+    status.playing = state.state == PlaybackState::Playing;
+    status.mediaType = std::clamp(state.mediaType, 1, 3);
+    status.playMode = state.trackOrderMode == TrackOrderMode::Shuffle
+        ? static_cast<std::int32_t>(TrackOrderMode::Shuffle)
+        : static_cast<std::int32_t>(TrackOrderMode::Alphabetical);
+    status.volumePercent = std::clamp(state.volumeGain * kDefaultVolumePercent, 0.0F, kMaximumVolumePercent);
+    status.selectedKey = state.selectedKey;
+
+    const bool active = state.state == PlaybackState::Playing || state.state == PlaybackState::Paused;
+    if (active && !state.currentTrackPath.empty()) {
+        status.trackBasename = pathToUtf8(state.currentTrackPath.filename());
+    }
+
+    if (state.selectedKey.empty()) {
+        return status;
+    }
+    const auto channelIt = channels_.find(state.selectedKey);
+    if (channelIt == channels_.end()) {
+        return status;
+    }
+
+    status.sourceName = channelIt->second.displayName;
+    if (channelIt->second.isStream) {
+        status.track = "na";
+    } else if (!state.currentTrackPath.empty()) {
+        status.track = pathToUtf8(state.currentTrackPath.filename());
+    } else if (state.songIndex < channelIt->second.songs.size()) {
+        status.track = pathToUtf8(std::filesystem::path(std::wstring(channelIt->second.songs.fileName(state.songIndex))));
+    }
+    return status;
+}
+
+void RadioEngine::publishStatusSnapshotLocked()
+{
+    const auto previous = statusSnapshot_.load(std::memory_order_acquire);
+    const bool rebuild = statusFullRebuildPending_ || !previous;
+    const auto statusFor = [this, &previous](std::uint64_t deviceId, const DeviceState& state) {
+        DeviceStatus status = makeDeviceStatusLocked(state);
+        const DeviceStatus* before = findDeviceStatus(previous.get(), deviceId);
+        status.trackSequence = before != nullptr ? before->trackSequence : 0;
+        const bool newTrack = before == nullptr || status.trackBasename != before->trackBasename;
+        if (!status.trackBasename.empty() && newTrack) {
+            ++status.trackSequence;
+        }
+        return status;
+    };
+
+    StatusSnapshot next;
+    next.channelCount = channels_.size();
+    next.volumeStepPercent = std::clamp(config_.volumeStepPercent, 0.1F, kMaximumVolumePercent);
+    next.debugVerbosity = std::clamp<std::int32_t>(config_.debugVerbosity, 0, 2);
+    next.dialogDuckEnabled = config_.dialogDuckEnabled;
+    next.dialogDuckVolume = std::clamp(config_.dialogDuckVolume, 0.0F, 200.0F);
+
+    if (!rebuild) {
+        // Ticks sync every playing device; most passes change nothing a getter can see.
+        bool changed = next.channelCount != previous->channelCount ||
+                       next.volumeStepPercent != previous->volumeStepPercent ||
+                       next.debugVerbosity != previous->debugVerbosity ||
+                       next.dialogDuckEnabled != previous->dialogDuckEnabled ||
+                       next.dialogDuckVolume != previous->dialogDuckVolume;
+        for (auto it = statusDirtyDevices_.begin(); !changed && it != statusDirtyDevices_.end(); ++it) {
+            const auto stateIt = deviceStates_.find(*it);
+            const auto previousIt = previous->devices.find(*it);
+            if (stateIt == deviceStates_.end()) {
+                changed = previousIt != previous->devices.end();
+            } else {
+                changed = previousIt == previous->devices.end() ||
+                          !(previousIt->second == statusFor(*it, stateIt->second));
+            }
+        }
+        if (!changed) {
+            statusDirtyDevices_.clear();
+            return;
+        }
+    }
+
+    if (rebuild) {
+        for (const auto& [deviceId, state] : deviceStates_) {
+            next.devices.emplace(deviceId, statusFor(deviceId, state));
+        }
+    } else {
+        next.devices = previous->devices;
+        for (const std::uint64_t deviceId : statusDirtyDevices_) {
+            const auto stateIt = deviceStates_.find(deviceId);
+            if (stateIt == deviceStates_.end()) {
+                next.devices.erase(deviceId);
+            } else {
+                next.devices[deviceId] = statusFor(deviceId, stateIt->second);
+            }
+        }
+    }
+    statusDirtyDevices_.clear();
+    statusFullRebuildPending_ = false;
+    statusSnapshot_.store(std::make_shared<const StatusSnapshot>(std::move(next)), std::memory_order_release);
+}
+
+const RadioEngine::DeviceStatus* RadioEngine::findDeviceStatus(const StatusSnapshot* snapshot, std::uint64_t deviceId)
+{
+    if (snapshot == nullptr) {
+        return nullptr;
+    }
+    const auto it = snapshot->devices.find(deviceId);
+    return it != snapshot->devices.end() ? &it->second : nullptr;
+}
+
+std::string RadioEngine::encodeSessionDevice(std::uint64_t deviceId, const SessionDeviceRecord& record)
+{
+    std::ostringstream out;
+    out << "    {\n";
+    out << "      \"device_id\": \"" << deviceId << "\",\n";
+    out << "      \"media_type\": " << record.mediaType << ",\n";
+    out << "      \"play_mode\": " << record.playMode << ",\n";
+    out << "      \"selected_key\": \"" << jsonEscape(record.selectedKey) << "\",\n";
+    out << "      \"current_track_name\": \"" << jsonEscape(record.currentTrackName) << "\",\n";
+    out << "      \"current_track_kind\": \"" << record.currentTrackKind << "\",\n";
+    out << "      \"resume_position_ms\": " << record.resumePositionMs << ",\n";
+    out << "      \"song_index\": " << record.songIndex << ",\n";
+    out << "      \"transition_index\": " << record.transitionIndex << ",\n";
+    out << "      \"ad_index\": " << record.adIndex << ",\n";
+    out << "      \"songs_since_ad\": " << record.songsSinceAd << ",\n";
+    out << "      \"previous_was_song\": " << (record.previousWasSong ? "true" : "false") << ",\n";
+    out << "      \"volume_percent\": " << record.volumePercent << ",\n";
+    out << "      \"shuffle_seed\": \"" << record.shuffle.seed << "\",\n";
+    out << "      \"shuffle_epoch\": " << record.shuffle.epoch << ",\n";
+    out << "      \"shuffle_cursor\": " << record.shuffle.cursor << ",\n";
+    out << "      \"shuffle_offset\": " << record.shuffle.offset << ",\n";
+    out << "      \"shuffle_song_count\": " << record.shuffle.songCount << "\n";
+    out << "    }";
+    return out.str();
+}
+
+bool RadioEngine::writeSessionJob(
+    const SessionWriteJob& job,
+    std::map<std::uint64_t, std::string>& encodedDevices,
+    std::string& lastPayload,
+    Logger& logger)
+{
+    if (job.replaceAll) {
+        encodedDevices.clear();
+        lastPayload.clear();
+    }
+    for (const auto& [deviceId, record] : job.devices) {
+        if (record.has_value()) {
+            encodedDevices[deviceId] = encodeSessionDevice(deviceId, *record);
+        } else {
+            encodedDevices.erase(deviceId);
+        }
+    }
+
+    std::string payload = "{\n  \"version\": 1,\n  \"devices\": [";
+    bool wroteAny = false;
+    for (const auto& [deviceId, encoded] : encodedDevices) {
+        payload += wroteAny ? ",\n" : "\n";
+        payload += encoded;
+        wroteAny = true;
+    }
+    if (wroteAny) {
+        payload += "\n";
+    }
+    payload += "  ]\n}\n";
+
+    // Synced folders upload on every rename, so an unchanged file is never rewritten.
+    if (payload == lastPayload) {
+        return true;
+    }
 
     std::error_code ec;
-    std::filesystem::create_directories(config_.radioRootPath, ec);
+    std::filesystem::create_directories(job.path.parent_path(), ec);
     if (ec) {
-        logger_.warn("Could not create radio session directory: " + pathToUtf8(config_.radioRootPath));
+        logger.warn("Could not create radio session directory: " + pathToUtf8(job.path.parent_path()));
+        lastPayload.clear();
         return false;
     }
 
-    std::map<std::uint64_t, DeviceState> orderedStates(deviceStates_.begin(), deviceStates_.end());
-    std::ostringstream out;
-    out << "{\n  \"version\": 1,\n  \"devices\": [";
+    if (!writeTextFileAtomically(job.path, payload, logger)) {
+        lastPayload.clear();
+        return false;
+    }
 
-    bool wroteAny = false;
-    for (const auto& [deviceId, state] : orderedStates) {
-        const bool hasMeaningfulState =
-            !state.selectedKey.empty() ||
-            !state.currentTrackPath.empty() ||
-            state.resumePositionMs > 0 ||
-            state.mediaType != 1 ||
-            state.trackOrderMode != TrackOrderMode::Alphabetical ||
-            std::abs(state.volumeGain - 1.0F) > 0.001F;
-        if (!hasMeaningfulState) {
-            continue;
-        }
+    lastPayload = std::move(payload);
+    logger.info("Saved radio session state: " + pathToUtf8(job.path));
+    return true;
+}
 
-        const auto channelIt = channels_.find(state.selectedKey);
-        std::string trackKind = "song";
-        if (channelIt != channels_.end() && !state.currentTrackPath.empty()) {
-            const auto fileName = toLower(pathToUtf8(state.currentTrackPath.filename()));
-            auto matchesPath = [&fileName](const std::vector<std::filesystem::path>& paths) {
-                for (const auto& pathEntry : paths) {
-                    if (toLower(pathToUtf8(pathEntry.filename())) == fileName) {
-                        return true;
-                    }
+bool RadioEngine::savePersistentSessionLocked(const bool force)
+{
+    syncResumePositionFromBackendLocked();
+    syncCurrentDeviceStateLocked();
+
+    // A failed background write leaves the writer's view unknown; hand it the whole session again.
+    if (sessionWriteFailed_.exchange(false, std::memory_order_acq_rel)) {
+        sessionFullRebuildPending_ = true;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    SessionWriteJob job;
+    job.path = sessionStatePathLocked();
+    job.replaceAll = sessionFullRebuildPending_;
+
+    bool contentChanged = job.replaceAll;
+    bool positionChanged = false;
+    if (job.replaceAll) {
+        for (const auto& [deviceId, state] : deviceStates_) {
+            if (auto record = makeSessionRecordLocked(state); record.has_value()) {
+                job.devices.emplace(deviceId, std::move(record));
+            }
+        }
+    } else {
+        for (const std::uint64_t deviceId : sessionDirtyDevices_) {
+            const auto stateIt = deviceStates_.find(deviceId);
+            std::optional<SessionDeviceRecord> record =
+                stateIt != deviceStates_.end() ? makeSessionRecordLocked(stateIt->second) : std::nullopt;
+            const auto previousIt = sessionRecords_.find(deviceId);
+            if (previousIt == sessionRecords_.end()) {
+                if (record.has_value()) {
+                    contentChanged = true;
+                    job.devices.emplace(deviceId, std::move(record));
                 }
-                return false;
-            };
-            if (matchesPath(channelIt->second.transitions)) {
-                trackKind = "transition";
-            } else if (matchesPath(channelIt->second.ads)) {
-                trackKind = "ad";
+                continue;
+            }
+            if (!record.has_value()) {
+                contentChanged = true;
+                job.devices.emplace(deviceId, std::nullopt);
+                continue;
+            }
+            if (*record == previousIt->second) {
+                continue;
+            }
+
+            SessionDeviceRecord samePosition = *record;
+            samePosition.resumePositionMs = previousIt->second.resumePositionMs;
+            if (samePosition == previousIt->second) {
+                positionChanged = true;
+            } else {
+                contentChanged = true;
             }
+            job.devices.emplace(deviceId, std::move(record));
         }
+    }
+
+    lastSessionSaveTime_ = now;
+    if (!contentChanged && !positionChanged) {
+        sessionDirtyDevices_.clear();
+        sessionStateDirty_ = false;
+        return true;
+    }
+    if (!contentChanged && !force && (now - lastSessionPositionSaveTime_) < kSessionPositionFlushInterval) {
+        // The resume position moves on every tick while playing; persist it at a slower cadence.
+        return false;
+    }
 
-        if (!wroteAny) {
-            out << "\n";
+    if (job.replaceAll) {
+        sessionRecords_.clear();
+    }
+    for (const auto& [deviceId, record] : job.devices) {
+        if (record.has_value()) {
+            sessionRecords_[deviceId] = *record;
         } else {
-            out << ",\n";
+            sessionRecords_.erase(deviceId);
         }
-        wroteAny = true;
+    }
+    sessionDirtyDevices_.clear();
+    sessionFullRebuildPending_ = false;
+    sessionStateDirty_ = false;
+    lastSessionPositionSaveTime_ = now;
 
-        out << "    {\n";
-        out << "      \"device_id\": \"" << deviceId << "\",\n";
-        out << "      \"media_type\": " << std::clamp(state.mediaType, 1, 3) << ",\n";
-        out << "      \"play_mode\": " << static_cast<std::int32_t>(state.trackOrderMode) << ",\n";
-        out << "      \"selected_key\": \"" << jsonEscape(state.selectedKey) << "\",\n";
-        out << "      \"current_track_name\": \"" << jsonEscape(pathToUtf8(state.currentTrackPath.filename())) << "\",\n";
-        out << "      \"current_track_kind\": \"" << trackKind << "\",\n";
-        out << "      \"resume_position_ms\": " << state.resumePositionMs << ",\n";
-        out << "      \"song_index\": " << state.songIndex << ",\n";
-        out << "      \"transition_index\": " << state.transitionIndex << ",\n";
-        out << "      \"ad_index\": " << state.adIndex << ",\n";
-        out << "      \"songs_since_ad\": " << state.songsSinceAd << ",\n";
-        out << "      \"previous_was_song\": " << (state.previousWasSong ? "true" : "false") << ",\n";
-        out << "      \"volume_percent\": " << std::clamp(state.volumeGain * 100.0F, 0.0F, 200.0F) << ",\n";
-        out << "      \"shuffle_cursor\": " << state.shuffleCursor << ",\n";
-        out << "      \"shuffle_history\": [";
-        for (std::size_t i = 0; i < state.shuffleHistory.size(); ++i) {
-            if (i > 0) {
-                out << ", ";
+    if (!sessionWriterRunning_) {
+        const auto saveStartedAt = std::chrono::steady_clock::now();
+        const bool written = writeSessionJob(job, sessionEncodedDevices_, sessionLastPayload_, logger_);
+        stats_.sessionSave.record(std::chrono::steady_clock::now() - saveStartedAt);
+        if (!written) {
+            sessionFullRebuildPending_ = true;
+        }
+        return written;
+    }
+
+    {
+        std::lock_guard<std::mutex> writerLock(sessionWriterMutex_);
+        job.generation = ++sessionWriteGeneration_;
+        if (pendingSessionWrite_.has_value() && !job.replaceAll) {
+            // The writer has not picked up the previous job yet; fold this one into it.
+            for (auto& [deviceId, record] : job.devices) {
+                pendingSessionWrite_->devices[deviceId] = std::move(record);
             }
-            out << state.shuffleHistory[i];
+            pendingSessionWrite_->path = std::move(job.path);
+            pendingSessionWrite_->generation = job.generation;
+        } else {
+            pendingSessionWrite_ = std::move(job);
         }
-        out << "]\n";
-        out << "    }";
     }
+    sessionWriterCv_.notify_all();
+    return true;
+}
 
-    if (wroteAny) {
-        out << "\n";
+void RadioEngine::startSessionWriterLocked()
+{
+    if (sessionWriterRunning_) {
+        return;
     }
-    out << "  ]\n}\n";
 
-    const auto path = sessionStatePathLocked();
-    const auto tempPath = path.parent_path() / (path.filename().string() + ".tmp");
-    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
-    if (!file.is_open()) {
-        logger_.warn("Could not open session temp file for writing: " + pathToUtf8(tempPath));
-        return false;
+    {
+        std::lock_guard<std::mutex> writerLock(sessionWriterMutex_);
+        sessionWriterStop_ = false;
     }
+    sessionWriterThread_ = std::thread(&RadioEngine::sessionWriterMain, this);
+    sessionWriterRunning_ = true;
+}
 
-    const std::string payload = out.str();
-    file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
-    file.flush();
-    if (!file.good()) {
-        logger_.warn("Could not write radio session file: " + pathToUtf8(tempPath));
-        return false;
+void RadioEngine::stopSessionWriter()
+{
+    // The writer never takes the engine mutex, so joining under it keeps inline saves from racing the final job.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!sessionWriterRunning_) {
+        return;
     }
-    file.close();
 
-    std::filesystem::rename(tempPath, path, ec);
-    if (ec) {
-        std::filesystem::remove(path, ec);
-        ec.clear();
-        std::filesystem::rename(tempPath, path, ec);
+    sessionWriterRunning_ = false;
+    {
+        std::lock_guard<std::mutex> writerLock(sessionWriterMutex_);
+        sessionWriterStop_ = true;
     }
-    if (ec) {
-        logger_.warn("Could not finalize session file: " + pathToUtf8(path));
+    sessionWriterCv_.notify_all();
+    if (sessionWriterThread_.joinable()) {
+        sessionWriterThread_.join();
+    }
+}
+
+void RadioEngine::sessionWriterMain()
+{
+    std::unique_lock<std::mutex> writerLock(sessionWriterMutex_);
+    for (;;) {
+        sessionWriterCv_.wait(writerLock, [this]() {
+            return sessionWriterStop_ || pendingSessionWrite_.has_value() || pendingStreamCacheWrite_.has_value();
+        });
+        if (pendingStreamCacheWrite_.has_value()) {
+            const StreamCacheWriteJob cacheJob = std::move(*pendingStreamCacheWrite_);
+            pendingStreamCacheWrite_.reset();
+            writerLock.unlock();
+            (void)writeStreamCacheJob(cacheJob, logger_);
+            writerLock.lock();
+            continue;
+        }
+        if (!pendingSessionWrite_.has_value()) {
+            break;
+        }
+
+        SessionWriteJob job = std::move(*pendingSessionWrite_);
+        pendingSessionWrite_.reset();
+        writerLock.unlock();
+        const auto saveStartedAt = std::chrono::steady_clock::now();
+        const bool written = writeSessionJob(job, sessionEncodedDevices_, sessionLastPayload_, logger_);
+        stats_.sessionSave.record(std::chrono::steady_clock::now() - saveStartedAt);
+        if (!written) {
+            sessionWriteFailed_.store(true, std::memory_order_release);
+        }
+        writerLock.lock();
+
+        sessionWriteCompleted_ = job.generation;
+        sessionLastWriteOk_ = written;
+        sessionWriterCv_.notify_all();
+    }
+}
+
+bool RadioEngine::postStreamProbeLocked(std::function<void()> probe)
+{
+    std::lock_guard<std::mutex> probeLock(streamProbeMutex_);
+    if (streamProbeStop_) {
         return false;
     }
 
-    sessionStateDirty_ = false;
-    lastSessionSaveTime_ = std::chrono::steady_clock::now();
-    logger_.info("Saved radio session state: " + pathToUtf8(path));
+    streamProbeJobs_.push_back(std::move(probe));
+    if (streamProbeThreads_.size() < kMaxParallelStreamProbes) {
+        try {
+            streamProbeThreads_.emplace_back(&RadioEngine::streamProbeMain, this);
+        } catch (const std::system_error& error) {
+            // The threads already running still drain the queue; with none, the caller ranks nothing.
+            logger_.warn([&]() { return std::string("Stream probe thread could not start: ") + error.what(); });
+            if (streamProbeThreads_.empty()) {
+                streamProbeJobs_.clear();
+                return false;
+            }
+        }
+    }
+    streamProbeCv_.notify_one();
     return true;
 }
 
+void RadioEngine::stopStreamProbes()
+{
+    // Probes still running belong to batches whose callers have returned and cancelled them, so
+    // each finishes within one wait slice; queued ones are dropped unrun.
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> probeLock(streamProbeMutex_);
+        streamProbeStop_ = true;
+        streamProbeJobs_.clear();
+        threads = std::move(streamProbeThreads_);
+        streamProbeThreads_.clear();
+    }
+    streamProbeCv_.notify_all();
+    for (auto& thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    // Inline commands after shutdown may probe again; the destructor's shutdown() joins those.
+    std::lock_guard<std::mutex> probeLock(streamProbeMutex_);
+    streamProbeStop_ = false;
+}
+
+void RadioEngine::streamProbeMain()
+{
+    std::unique_lock<std::mutex> probeLock(streamProbeMutex_);
+    for (;;) {
+        streamProbeCv_.wait(probeLock, [this]() {
+            return streamProbeStop_ || !streamProbeJobs_.empty();
+        });
+        if (streamProbeStop_) {
+            break;
+        }
+
+        std::function<void()> probe = std::move(streamProbeJobs_.front());
+        streamProbeJobs_.pop_front();
+        probeLock.unlock();
+        probe();
+        probeLock.lock();
+    }
+}
+
+bool RadioEngine::waitForSessionWrite(std::uint64_t generation)
+{
+    std::unique_lock<std::mutex> writerLock(sessionWriterMutex_);
+    const bool done = sessionWriterCv_.wait_for(writerLock, std::chrono::seconds(5), [this, generation]() {
+        return sessionWriteCompleted_ >= generation || sessionWriterStop_;
+    });
+    return done && sessionLastWriteOk_;
+}
+
 bool RadioEngine::maybeFlushPersistentSessionLocked(const bool force)
 {
     if (!sessionStateDirty_) {
@@ -4599,22 +8024,32 @@ bool RadioEngine::maybeFlushPersistentSessionLocked(const bool force)
         return false;
     }
 
-    return savePersistentSessionLocked();
+    return savePersistentSessionLocked(force);
+}
+
+std::uint32_t RadioEngine::mciSend(
+    const std::wstring& command,
+    wchar_t* output,
+    std::uint32_t outputSize,
+    void* callbackWindow) const
+{
+    return playbackHooks_.mciSendString(command.c_str(), output, outputSize, callbackWindow);
 }
 
 bool RadioEngine::mciCommandLocked(const std::wstring& command, std::wstring* output)
 {
     std::array<wchar_t, 512> buffer{};
-    MCIERROR err = mciSendStringW(
-        command.c_str(),
+    MCIERROR err = mciSend(
+        command,
         output != nullptr ? buffer.data() : nullptr,
-        output != nullptr ? static_cast<UINT>(buffer.size()) : 0U,
-        nullptr);
+        output != nullptr ? static_cast<UINT>(buffer.size()) : 0U);
 
     if (err != 0) {
         std::array<wchar_t, 256> errText{};
         mciGetErrorStringW(err, errText.data(), static_cast<UINT>(errText.size()));
-        logger_.warn("MCI command failed: " + wideToUtf8(command) + " | " + wideToUtf8(errText.data()));
+        logger_.warn([&]() {
+            return "MCI command failed: " + wideToUtf8(command) + " | " + wideToUtf8(errText.data());
+        });
         return false;
     }
 
@@ -4624,10 +8059,29 @@ bool RadioEngine::mciCommandLocked(const std::wstring& command, std::wstring* ou
     return true;
 }
 
+bool RadioEngine::mciPlayLocked(const std::wstring& command)
+{
+    const HWND callbackWindow = notifyState_ ? notifyState_->window : nullptr;
+    const std::wstring fullCommand = callbackWindow != nullptr ? command + L" notify" : command;
+    const MCIERROR err = mciSend(fullCommand, nullptr, 0, callbackWindow);
+    if (err != 0) {
+        std::array<wchar_t, 256> errText{};
+        mciGetErrorStringW(err, errText.data(), static_cast<UINT>(errText.size()));
+        logger_.warn([&]() {
+            return "MCI command failed: " + wideToUtf8(fullCommand) + " | " + wideToUtf8(errText.data());
+        });
+        return false;
+    }
+
+    // The end-of-track estimate is re-read from the device on the next worker tick.
+    trackEndValid_ = false;
+    return true;
+}
+
 bool RadioEngine::mciStatusNumberLocked(const std::wstring& statusName, int& outValue)
 {
     std::wstring out;
-    if (!mciCommandLocked(L"status " + std::wstring(kAlias) + L" " + statusName, &out)) {
+    if (!mciCommandLocked(L"status " + activeAlias_ + L" " + statusName, &out)) {
         return false;
     }
 
@@ -4641,14 +8095,14 @@ bool RadioEngine::mciStatusNumberLocked(const std::wstring& statusName, int& out
 
 bool RadioEngine::mciStatusModeLocked(std::wstring& outMode)
 {
-    return mciCommandLocked(L"status " + std::wstring(kAlias) + L" mode", &outMode);
+    return mciCommandLocked(L"status " + activeAlias_ + L" mode", &outMode);
 }
 
 bool RadioEngine::mciStatusModeSilentLocked(std::wstring& outMode)
 {
     std::array<wchar_t, 128> buffer{};
     const MCIERROR err =
-        mciSendStringW((L"status " + std::wstring(kAlias) + L" mode").c_str(), buffer.data(), static_cast<UINT>(buffer.size()), nullptr);
+        mciSend(L"status " + activeAlias_ + L" mode", buffer.data(), static_cast<UINT>(buffer.size()));
     if (err != 0) {
         outMode.clear();
         return false;
@@ -4682,7 +8136,9 @@ void RadioEngine::cleanupCurrentStreamTempFileLocked()
     std::error_code ec;
     const bool removed = std::filesystem::remove(streamWrapperTempPath_, ec);
     if (!removed && ec) {
-        logger_.warn("Failed to remove temp stream wrapper file: " + pathToUtf8(streamWrapperTempPath_));
+        logger_.warn([&]() {
+            return "Failed to remove temp stream wrapper file: " + pathToUtf8(streamWrapperTempPath_);
+        });
     }
 
     streamWrapperTempPath_.clear();
@@ -4695,6 +8151,7 @@ RadioEngine::DeviceState RadioEngine::makeCurrentDeviceStateLocked()
     if (it != deviceStates_.end()) {
         snapshot.fadeOverride = it->second.fadeOverride;
         snapshot.volumeGain = it->second.volumeGain;
+        snapshot.fadeMotion = it->second.fadeMotion;
     }
 
     snapshot.mediaType = mediaType_;
@@ -4709,8 +8166,7 @@ RadioEngine::DeviceState RadioEngine::makeCurrentDeviceStateLocked()
     snapshot.adIndex = adIndex_;
     snapshot.songsSinceAd = songsSinceAd_;
     snapshot.previousWasSong = previousWasSong_;
-    snapshot.shuffleHistory = shuffleHistory_;
-    snapshot.shuffleCursor = shuffleCursor_;
+    snapshot.shuffle = shuffle_;
     snapshot.emitterPosition = emitterPosition_;
     snapshot.playerPosition = playerPosition_;
     snapshot.playerYawDeg = playerYawDeg_;
@@ -4724,253 +8180,822 @@ RadioEngine::DeviceState RadioEngine::makeCurrentDeviceStateLocked()
     return snapshot;
 }
 
-void RadioEngine::applyDeviceStateLocked(const DeviceState& state)
+void RadioEngine::applyDeviceStateLocked(const DeviceState& state)
+{
+    mediaType_ = std::clamp(state.mediaType, 1, 3);
+    selectedKey_ = state.selectedKey;
+    mode_ = state.mode;
+    state_ = state.state;
+    trackOrderMode_ = state.trackOrderMode == TrackOrderMode::Shuffle
+        ? TrackOrderMode::Shuffle
+        : TrackOrderMode::Alphabetical;
+    currentTrackPath_ = state.currentTrackPath;
+    resumePositionMs_ = state.resumePositionMs;
+    songIndex_ = state.songIndex;
+    transitionIndex_ = state.transitionIndex;
+    adIndex_ = state.adIndex;
+    songsSinceAd_ = state.songsSinceAd;
+    previousWasSong_ = state.previousWasSong;
+    shuffle_ = state.shuffle;
+    emitterPosition_ = state.emitterPosition;
+    playerPosition_ = state.playerPosition;
+    playerYawDeg_ = state.playerYawDeg;
+    lastVolume_ = state.lastVolume;
+    lastLeftVolume_ = state.lastLeftVolume;
+    lastRightVolume_ = state.lastRightVolume;
+    panControlsAvailable_ = state.panControlsAvailable;
+    panUnavailableLogged_ = state.panUnavailableLogged;
+    trackStartTime_ = state.trackStartTime;
+    trackStartValid_ = state.trackStartValid;
+}
+
+void RadioEngine::syncCurrentDeviceStateLocked()
+{
+    deviceStates_[currentDeviceId_] = makeCurrentDeviceStateLocked();
+    sessionDirtyDevices_.insert(currentDeviceId_);
+    sessionStateDirty_ = true;
+    statusDirtyDevices_.insert(currentDeviceId_);
+}
+
+RadioEngine::DeviceState& RadioEngine::ensureDeviceStateLocked(std::uint64_t deviceId)
+{
+    auto it = deviceStates_.find(deviceId);
+    if (it != deviceStates_.end()) {
+        return it->second;
+    }
+
+    DeviceState initial;
+    initial.mediaType = 1;
+    initial.trackOrderMode = TrackOrderMode::Alphabetical;
+    initial.fadeOverride.enabled = false;
+    initial.volumeGain = kDefaultVolumePercent / 100.0F;
+    auto [insertIt, inserted] = deviceStates_.emplace(deviceId, std::move(initial));
+    (void)inserted;
+    return insertIt->second;
+}
+
+void RadioEngine::switchToDeviceLocked(std::uint64_t deviceId)
+{
+    if (deviceId == currentDeviceId_) {
+        ensureDeviceStateLocked(deviceId);
+        return;
+    }
+
+    // Every device keeps its own backend, so switching only swaps mirrors; nothing is stopped.
+    syncCurrentDeviceStateLocked();
+    parkPlaybackSlotLocked(currentDeviceId_);
+
+    currentDeviceId_ = deviceId;
+    restorePlaybackSlotLocked(deviceId);
+    DeviceState& target = ensureDeviceStateLocked(deviceId);
+    applyDeviceStateLocked(target);
+
+    if (backend_ == PlaybackBackend::None) {
+        // Nothing is open for this device (fresh session or a failed start); require explicit play/start.
+        if (state_ != PlaybackState::Stopped) {
+            state_ = PlaybackState::Stopped;
+            trackStartValid_ = false;
+        }
+
+        // Force the first fade sample to write volume/pan to the fresh playback session.
+        lastVolume_ = -1;
+        lastLeftVolume_ = -1;
+        lastRightVolume_ = -1;
+    }
+}
+
+void RadioEngine::parkPlaybackSlotLocked(std::uint64_t deviceId)
+{
+    PlaybackSlot& slot = playbackSlots_[deviceId];
+    slot.backend = std::exchange(backend_, PlaybackBackend::None);
+    slot.primaryAlias = std::move(primaryAlias_);
+    slot.secondaryAlias = std::move(secondaryAlias_);
+    slot.activeAlias = std::move(activeAlias_);
+    slot.preload = std::exchange(preload_, PreloadedTrack{});
+    slot.standbyDraining = std::exchange(standbyDraining_, false);
+    slot.trackLength = std::exchange(trackLength_, TrackLengthCache{});
+    slot.mfState = std::move(mfState_);
+    slot.dsState = std::move(dsState_);
+    slot.streamReconnect = std::move(streamReconnect_);
+    slot.mixerVoice = std::exchange(mixerVoice_, 0);
+    slot.streamWrapperTempPath = std::exchange(streamWrapperTempPath_, std::filesystem::path{});
+    slot.nextPlaybackPollTime = nextPlaybackPollTime_;
+    slot.trackEndTime = trackEndTime_;
+    slot.trackEndValid = std::exchange(trackEndValid_, false);
+}
+
+void RadioEngine::restorePlaybackSlotLocked(std::uint64_t deviceId)
+{
+    auto it = playbackSlots_.find(deviceId);
+    if (it == playbackSlots_.end()) {
+        primaryAlias_ = deviceAliasName(kAlias, deviceId);
+        secondaryAlias_ = deviceAliasName(kStandbyAlias, deviceId);
+        activeAlias_ = primaryAlias_;
+        nextPlaybackPollTime_ = {};
+        trackEndTime_ = {};
+        return;
+    }
+
+    PlaybackSlot& slot = it->second;
+    backend_ = slot.backend;
+    primaryAlias_ = std::move(slot.primaryAlias);
+    secondaryAlias_ = std::move(slot.secondaryAlias);
+    activeAlias_ = std::move(slot.activeAlias);
+    preload_ = std::move(slot.preload);
+    standbyDraining_ = slot.standbyDraining;
+    trackLength_ = std::move(slot.trackLength);
+    mfState_ = std::move(slot.mfState);
+    dsState_ = std::move(slot.dsState);
+    streamReconnect_ = std::move(slot.streamReconnect);
+    mixerVoice_ = slot.mixerVoice;
+    streamWrapperTempPath_ = std::move(slot.streamWrapperTempPath);
+    nextPlaybackPollTime_ = slot.nextPlaybackPollTime;
+    trackEndTime_ = slot.trackEndTime;
+    trackEndValid_ = slot.trackEndValid;
+    playbackSlots_.erase(it);
+}
+
+std::vector<std::uint64_t> RadioEngine::playingDeviceIdsLocked() const
+{
+    std::vector<std::uint64_t> deviceIds;
+    if (state_ == PlaybackState::Playing) {
+        deviceIds.push_back(currentDeviceId_);
+    }
+    for (const auto& [deviceId, device] : deviceStates_) {
+        if (deviceId != currentDeviceId_ && device.state == PlaybackState::Playing) {
+            deviceIds.push_back(deviceId);
+        }
+    }
+    return deviceIds;
+}
+
+void RadioEngine::stopAllPlaybackDevicesLocked(bool releaseBackends)
+{
+    const std::uint64_t homeDeviceId = currentDeviceId_;
+    std::vector<std::uint64_t> deviceIds{ homeDeviceId };
+    for (const auto& [deviceId, slot] : playbackSlots_) {
+        deviceIds.push_back(deviceId);
+    }
+
+    for (const std::uint64_t deviceId : deviceIds) {
+        switchToDeviceLocked(deviceId);
+        if (state_ != PlaybackState::Stopped) {
+            syncResumePositionFromBackendLocked();
+            state_ = PlaybackState::Stopped;
+        }
+        stopPlaybackDeviceLocked(true);
+        if (releaseBackends) {
+            shutdownDirectShowLocked();
+            shutdownMediaFoundationLocked();
+        }
+        trackStartValid_ = false;
+        syncCurrentDeviceStateLocked();
+    }
+    switchToDeviceLocked(homeDeviceId);
+
+    if (releaseBackends) {
+        playbackSlots_.clear();
+    }
+}
+
+void RadioEngine::discardAllPreloadsLocked()
+{
+    discardPreloadLocked();
+    for (auto& [deviceId, slot] : playbackSlots_) {
+        if (slot.preload.valid) {
+            const std::wstring& standbyAlias =
+                slot.activeAlias == slot.primaryAlias ? slot.secondaryAlias : slot.primaryAlias;
+            (void)mciSend(L"close " + standbyAlias);
+        }
+        slot.preload = PreloadedTrack{};
+    }
+}
+
+void RadioEngine::applyPendingPositionSampleLocked(std::vector<std::uint64_t>& fadeUpdatedDevices)
+{
+    // Clear before scanning so a sample published mid-scan re-arms the flag for the next pass.
+    if (!pendingPositionDirty_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // Samples for parked devices are applied through their mirror; return home afterwards, as the
+    // tick loop does, so the rest of the pass acts on the device it expects.
+    const std::uint64_t homeDeviceId = currentDeviceId_;
+    bool retryPending = false;
+    for (std::size_t i = 0; i < positionMailbox_.size(); ++i) {
+        PositionMailboxSlot& slot = positionMailbox_[i];
+        const std::uint64_t deviceId = slot.deviceId.load(std::memory_order_acquire);
+        if (deviceId == kFreeMailboxSlot) {
+            continue;
+        }
+
+        const std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before == positionMailboxApplied_[i]) {
+            continue;
+        }
+        if ((before & 1U) != 0U) {
+            retryPending = true;
+            continue;
+        }
+
+        PendingPositionSample sample;
+        sample.deviceId = deviceId;
+        sample.emitter = Position{
+            slot.emitterX.load(std::memory_order_relaxed),
+            slot.emitterY.load(std::memory_order_relaxed),
+            slot.emitterZ.load(std::memory_order_relaxed)
+        };
+        sample.player = Position{
+            slot.playerX.load(std::memory_order_relaxed),
+            slot.playerY.load(std::memory_order_relaxed),
+            slot.playerZ.load(std::memory_order_relaxed)
+        };
+        sample.playerYawDeg = slot.playerYawDeg.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != before) {
+            retryPending = true;
+            continue;
+        }
+        // Each write advances the sequence by two; all but the newest were never applied.
+        const std::uint32_t writes = (before - positionMailboxApplied_[i]) / 2U;
+        if (writes > 1U) {
+            stats_.positionSamplesCoalesced.fetch_add(writes - 1U, std::memory_order_relaxed);
+        }
+        positionMailboxApplied_[i] = before;
+
+        if (applyPositionSampleLocked(sample)) {
+            fadeUpdatedDevices.push_back(deviceId);
+        }
+    }
+    switchToDeviceLocked(homeDeviceId);
+
+    if (retryPending) {
+        pendingPositionDirty_.store(true, std::memory_order_release);
+    }
+}
+
+bool RadioEngine::applyPositionSampleLocked(const PendingPositionSample& sample)
+{
+    DeviceState& device = ensureDeviceStateLocked(sample.deviceId);
+    device.emitterPosition = sample.emitter;
+    device.playerPosition = sample.player;
+    device.playerYawDeg = sample.playerYawDeg;
+    recordMotionSample(device.fadeMotion, sample);
+
+    if (sample.deviceId != currentDeviceId_) {
+        // Parked devices keep playing, so their fade has to follow the emitter too. The caller
+        // switches back to its home device.
+        if (device.state != PlaybackState::Playing) {
+            return false;
+        }
+        switchToDeviceLocked(sample.deviceId);
+    }
+
+    emitterPosition_ = sample.emitter;
+    playerPosition_ = sample.player;
+    playerYawDeg_ = sample.playerYawDeg;
+    if (state_ != PlaybackState::Playing) {
+        return false;
+    }
+    updateFadeVolumeLocked();
+    return true;
+}
+
+bool RadioEngine::runAsyncCommandForDevice(
+    std::uint64_t deviceId,
+    CommandFunction command,
+    const std::function<void(bool result)>& completion,
+    CommandKind kind)
+{
+    QueuedCommand queued;
+    queued.kind = kind;
+    queued.deviceId = deviceId;
+    queued.command = std::move(command);
+    return dispatchCommand(std::move(queued), completion, false);
+}
+
+bool RadioEngine::runBoolCommandForDevice(
+    std::uint64_t deviceId,
+    CommandFunction command,
+    CommandKind kind)
+{
+    QueuedCommand queued;
+    queued.kind = kind;
+    queued.deviceId = deviceId;
+    queued.command = std::move(command);
+    return dispatchCommand(std::move(queued), {}, true);
+}
+
+bool RadioEngine::dispatchCommand(
+    QueuedCommand command,
+    const std::function<void(bool result)>& completion,
+    bool waitForResult)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!workerRunning_ || std::this_thread::get_id() == workerThreadId_) {
+        const bool result = executeCommandLocked(command);
+        lock.unlock();
+        if (completion) {
+            completion(result);
+        }
+        return waitForResult ? result : true;
+    }
+
+    CommandWaiter* waiter = nullptr;
+    if (waitForResult || completion) {
+        waiter = acquireCommandWaiterLocked();
+        waiter->completion = waitForResult ? std::function<void(bool result)>{} : completion;
+        command.waiters = waiter;
+    }
+
+    const std::uint64_t deviceId = command.deviceId;
+    CommandWaiter* superseded = settleCommandWaitersLocked(enqueueCommandLocked(std::move(command)), false);
+    lock.unlock();
+    cv_.notify_all();
+    runCommandCompletions(superseded, false);
+
+    if (!waitForResult) {
+        return true;
+    }
+
+    lock.lock();
+    const bool completed = waiter->wake.wait_for(lock, kCommandWaitTimeout, [this, waiter]() {
+        return waiter->done || !workerRunning_;
+    });
+    if (!completed) {
+        // The command is still queued or running; whoever settles it recycles the waiter.
+        waiter->abandoned = true;
+        logger_.error("Radio command timed out waiting for worker completion (deviceId=" +
+                      std::to_string(deviceId) + ").");
+        return false;
+    }
+
+    const bool result = waiter->done ? waiter->result : false;
+    if (waiter->done) {
+        releaseCommandWaiterLocked(waiter);
+    } else {
+        waiter->abandoned = true;
+    }
+    return result;
+}
+
+RadioEngine::CommandWaiter* RadioEngine::acquireCommandWaiterLocked()
+{
+    CommandWaiter* waiter = commandWaiterFree_;
+    if (waiter != nullptr) {
+        commandWaiterFree_ = waiter->next;
+    } else {
+        commandWaiterStorage_.push_back(std::make_unique<CommandWaiter>());
+        waiter = commandWaiterStorage_.back().get();
+    }
+    waiter->next = nullptr;
+    waiter->done = false;
+    waiter->result = false;
+    waiter->abandoned = false;
+    return waiter;
+}
+
+void RadioEngine::releaseCommandWaiterLocked(CommandWaiter* waiter)
+{
+    waiter->completion = nullptr;
+    waiter->next = commandWaiterFree_;
+    commandWaiterFree_ = waiter;
+}
+
+RadioEngine::CommandWaiter* RadioEngine::settleCommandWaitersLocked(CommandWaiter* waiters, bool result)
+{
+    // Sync waiters are woken individually; async completions are returned as a chain so they can run
+    // after the mutex is released.
+    CommandWaiter* callbacks = nullptr;
+    while (waiters != nullptr) {
+        CommandWaiter* waiter = std::exchange(waiters, waiters->next);
+        waiter->next = nullptr;
+        if (waiter->completion) {
+            waiter->next = callbacks;
+            callbacks = waiter;
+        } else if (waiter->abandoned) {
+            releaseCommandWaiterLocked(waiter);
+        } else {
+            waiter->result = result;
+            waiter->done = true;
+            waiter->wake.notify_one();
+        }
+    }
+    return callbacks;
+}
+
+void RadioEngine::runCommandCompletions(CommandWaiter* waiters, bool result)
+{
+    if (waiters == nullptr) {
+        return;
+    }
+
+    for (CommandWaiter* waiter = waiters; waiter != nullptr; waiter = waiter->next) {
+        waiter->completion(result);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (waiters != nullptr) {
+        releaseCommandWaiterLocked(std::exchange(waiters, waiters->next));
+    }
+}
+
+RadioEngine::CommandWaiter* RadioEngine::enqueueCommandLocked(QueuedCommand command)
+{
+    command.enqueuedAt = std::chrono::steady_clock::now();
+    CommandWaiter* superseded = nullptr;
+    const auto appendWaiters = [](CommandWaiter*& chain, CommandWaiter* waiters) {
+        if (waiters == nullptr) {
+            return;
+        }
+        CommandWaiter* tail = waiters;
+        while (tail->next != nullptr) {
+            tail = tail->next;
+        }
+        tail->next = chain;
+        chain = waiters;
+    };
+
+    if (command.kind == CommandKind::Stop || command.kind == CommandKind::Pause) {
+        // The priority lane overtakes queued work, so a queued play/skip for the same device would
+        // otherwise run after the stop and undo it. Those entries are dropped and reported as failed.
+        // Selection changes (ChangePlaylist, SelectSource) stop the device themselves and are kept.
+        for (auto it = commandQueue_.begin(); it != commandQueue_.end();) {
+            const bool startsPlayback =
+                it->kind == CommandKind::Transport ||
+                it->kind == CommandKind::Forward ||
+                it->kind == CommandKind::Rewind ||
+                it->kind == CommandKind::Previous;
+            if (it->deviceId == command.deviceId && startsPlayback) {
+                appendWaiters(superseded, std::exchange(it->waiters, nullptr));
+                it = commandQueue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        priorityQueue_.push_back(std::move(command));
+        return superseded;
+    }
+
+    // Only the newest pending entry of this device is a merge candidate, so commands never reorder.
+    for (auto it = commandQueue_.rbegin(); it != commandQueue_.rend(); ++it) {
+        if (it->kind == CommandKind::Task) {
+            break;
+        }
+        if (it->deviceId != command.deviceId) {
+            continue;
+        }
+
+        QueuedCommand& pending = *it;
+        bool merged = false;
+        if (pending.kind == command.kind) {
+            switch (command.kind) {
+            case CommandKind::Volume:
+                // Same-direction steps only: clamping the sum then matches clamping each step.
+                if ((pending.volumeDelta >= 0.0F) == (command.volumeDelta >= 0.0F)) {
+                    pending.volumeDelta += command.volumeDelta;
+                    merged = true;
+                }
+                break;
+            case CommandKind::Forward:
+            case CommandKind::Rewind:
+            case CommandKind::Previous:
+                pending.repeat += command.repeat;
+                merged = true;
+                break;
+            case CommandKind::ChangePlaylist:
+                pending.command = std::move(command.command);
+                merged = true;
+                break;
+            default:
+                break;
+            }
+        }
+        if (merged) {
+            appendWaiters(pending.waiters, std::exchange(command.waiters, nullptr));
+            stats_.commandsMerged.fetch_add(1, std::memory_order_relaxed);
+            return superseded;
+        }
+        break;
+    }
+
+    commandQueue_.push_back(std::move(command));
+    return superseded;
+}
+
+bool RadioEngine::executeCommandLocked(QueuedCommand& command)
 {
-    mediaType_ = std::clamp(state.mediaType, 1, 3);
-    selectedKey_ = state.selectedKey;
-    mode_ = state.mode;
-    state_ = state.state;
-    trackOrderMode_ = state.trackOrderMode == TrackOrderMode::Shuffle
-        ? TrackOrderMode::Shuffle
-        : TrackOrderMode::Alphabetical;
-    currentTrackPath_ = state.currentTrackPath;
-    resumePositionMs_ = state.resumePositionMs;
-    songIndex_ = state.songIndex;
-    transitionIndex_ = state.transitionIndex;
-    adIndex_ = state.adIndex;
-    songsSinceAd_ = state.songsSinceAd;
-    previousWasSong_ = state.previousWasSong;
-    shuffleHistory_ = state.shuffleHistory;
-    shuffleCursor_ = state.shuffleCursor;
-    emitterPosition_ = state.emitterPosition;
-    playerPosition_ = state.playerPosition;
-    playerYawDeg_ = state.playerYawDeg;
-    lastVolume_ = state.lastVolume;
-    lastLeftVolume_ = state.lastLeftVolume;
-    lastRightVolume_ = state.lastRightVolume;
-    panControlsAvailable_ = state.panControlsAvailable;
-    panUnavailableLogged_ = state.panUnavailableLogged;
-    trackStartTime_ = state.trackStartTime;
-    trackStartValid_ = state.trackStartValid;
+    bool result = false;
+    try {
+        switchToDeviceLocked(command.deviceId);
+        clearPlayInterruptRequest();
+        if (command.repeat > 1) {
+            logger_.info([&]() {
+                return "Coalesced " + std::to_string(command.repeat) +
+                       " queued presses (deviceId=" + std::to_string(command.deviceId) + ").";
+            });
+        }
+        switch (command.kind) {
+        case CommandKind::Volume:
+            result = applyVolumeDeltaLocked(command.volumeDelta);
+            break;
+        case CommandKind::Forward:
+            result = forwardLocked(command.repeat);
+            break;
+        case CommandKind::Rewind:
+            result = rewindLocked(command.repeat);
+            break;
+        case CommandKind::Previous:
+            result = previousLocked(command.repeat);
+            break;
+        default:
+            result = command.command ? command.command() : false;
+            break;
+        }
+    } catch (const std::exception& ex) {
+        result = false;
+        logger_.error(std::string("Unhandled exception in queued command: ") + ex.what());
+    } catch (...) {
+        result = false;
+        logger_.error("Unhandled unknown exception in queued command.");
+    }
+    syncCurrentDeviceStateLocked();
+    (void)maybeFlushPersistentSessionLocked();
+    publishStatusSnapshotLocked();
+    return result;
 }
 
-void RadioEngine::syncCurrentDeviceStateLocked()
+void RadioEngine::runQueuedCommand(QueuedCommand& command)
 {
-    deviceStates_[currentDeviceId_] = makeCurrentDeviceStateLocked();
-    sessionStateDirty_ = true;
+    if (command.kind == CommandKind::Task) {
+        (void)command.command();
+        return;
+    }
+
+    bool result = false;
+    CommandWaiter* callbacks = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = executeCommandLocked(command);
+        callbacks = settleCommandWaitersLocked(std::exchange(command.waiters, nullptr), result);
+    }
+    runCommandCompletions(callbacks, result);
 }
 
-RadioEngine::DeviceState& RadioEngine::ensureDeviceStateLocked(std::uint64_t deviceId)
+std::chrono::steady_clock::time_point RadioEngine::trackDeadline(
+    PlaybackBackend backend,
+    bool trackEndValid,
+    std::chrono::steady_clock::time_point trackEndTime,
+    const PreloadedTrack& preload,
+    const std::filesystem::path& currentTrackPath)
 {
-    auto it = deviceStates_.find(deviceId);
-    if (it != deviceStates_.end()) {
-        return it->second;
+    if (!trackEndValid || backend != PlaybackBackend::MCI) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    if (preload.valid) {
+        return trackEndTime - std::chrono::milliseconds(kGaplessHandoffLeadMs);
     }
+    if (preload.attemptedTrack != currentTrackPath) {
+        return trackEndTime - std::chrono::milliseconds(kPreloadLeadTimeMs);
+    }
+    return std::chrono::steady_clock::time_point::max();
+}
 
-    DeviceState initial;
-    initial.mediaType = 1;
-    initial.trackOrderMode = TrackOrderMode::Alphabetical;
-    initial.fadeOverride.enabled = false;
-    initial.volumeGain = kDefaultVolumePercent / 100.0F;
-    auto [insertIt, inserted] = deviceStates_.emplace(deviceId, std::move(initial));
-    (void)inserted;
-    return insertIt->second;
+std::chrono::steady_clock::time_point RadioEngine::trackDeadlineLocked() const
+{
+    if (state_ != PlaybackState::Playing) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    return trackDeadline(backend_, trackEndValid_, trackEndTime_, preload_, currentTrackPath_);
 }
 
-void RadioEngine::switchToDeviceLocked(std::uint64_t deviceId)
+std::chrono::steady_clock::time_point RadioEngine::nextWorkerDeadlineLocked() const
 {
-    if (deviceId == currentDeviceId_) {
-        ensureDeviceStateLocked(deviceId);
-        return;
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    if (state_ == PlaybackState::Playing) {
+        // Completion is signalled; the safety poll only covers lost notifications and stream stalls.
+        deadline = std::min(deadline, nextPlaybackPollTime_);
+        deadline = std::min(deadline, trackDeadlineLocked());
+    }
+    for (const auto& [deviceId, slot] : playbackSlots_) {
+        const auto deviceIt = deviceStates_.find(deviceId);
+        if (deviceIt == deviceStates_.end() || deviceIt->second.state != PlaybackState::Playing) {
+            continue;
+        }
+        deadline = std::min(deadline, slot.nextPlaybackPollTime);
+        deadline = std::min(
+            deadline,
+            trackDeadline(slot.backend, slot.trackEndValid, slot.trackEndTime, slot.preload, deviceIt->second.currentTrackPath));
+    }
+    if (fadeRampPending_) {
+        deadline = std::min(deadline, nextFadeRampTime_);
+    }
+    if (sessionStateDirty_) {
+        deadline = std::min(deadline, lastSessionSaveTime_ + kSessionFlushInterval);
+    }
+    if (config_.statsLogMinutes > 0 && logger_.isEnabled(Logger::Level::Info)) {
+        deadline = std::min(deadline, nextStatsLogTime_);
+    }
+    if (config_.watchConfig) {
+        deadline = std::min(deadline, nextConfigCheckTime_);
+    }
+    if (standbyGraceUntil_ != std::chrono::steady_clock::time_point{}) {
+        deadline = std::min(deadline, standbyGraceUntil_);
     }
+    return deadline;
+}
 
-    syncCurrentDeviceStateLocked();
+void RadioEngine::startPlaybackNotifierLocked()
+{
+    if (notifyState_) {
+        return;
+    }
 
-    if (state_ == PlaybackState::Playing || state_ == PlaybackState::Paused) {
-        syncResumePositionFromBackendLocked();
-        stopPlaybackDeviceLocked(true);
-        state_ = PlaybackState::Stopped;
-        trackStartValid_ = false;
-        lastVolume_ = -1;
-        lastLeftVolume_ = -1;
-        lastRightVolume_ = -1;
-        syncCurrentDeviceStateLocked();
+    notifyState_ = std::make_unique<NotifyState>();
+    notifyState_->wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (notifyState_->wakeEvent == nullptr) {
+        logger_.warn("Playback notifier disabled: CreateEvent failed. Falling back to polling.");
+        notifyState_.reset();
+        return;
     }
 
-    currentDeviceId_ = deviceId;
-    DeviceState& target = ensureDeviceStateLocked(deviceId);
-    applyDeviceStateLocked(target);
+    std::promise<void*> windowReady;
+    auto windowFuture = windowReady.get_future();
+    notifyState_->thread = std::thread([this, ready = std::move(windowReady)]() mutable {
+        notifyThreadMain(ready);
+    });
 
-    // Audio device is global; after switching refs we keep session state but require explicit play/start.
-    if (state_ != PlaybackState::Stopped) {
-        state_ = PlaybackState::Stopped;
-        trackStartValid_ = false;
+    notifyState_->window = static_cast<HWND>(windowFuture.get());
+    if (notifyState_->window == nullptr) {
+        logger_.warn("Playback notifier window could not be created. Falling back to polling.");
+        notifyState_->thread.join();
+        CloseHandle(notifyState_->wakeEvent);
+        notifyState_.reset();
+        return;
     }
 
-    if (state_ == PlaybackState::Stopped) {
-        // Force the first post-switch fade sample to write volume/pan to the fresh playback session.
-        lastVolume_ = -1;
-        lastLeftVolume_ = -1;
-        lastRightVolume_ = -1;
-    }
+    logger_.info("Playback notifier started.");
 }
 
-bool RadioEngine::applyPendingPositionSampleLocked()
+void RadioEngine::stopPlaybackNotifier()
 {
-    if (!pendingPositionDirty_.load(std::memory_order_acquire)) {
-        return false;
-    }
-
-    PendingPositionSample sample;
     {
-        std::lock_guard<std::mutex> pendingLock(pendingPositionMutex_);
-        if (!pendingPositionDirty_.load(std::memory_order_relaxed)) {
-            return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!notifyState_) {
+            return;
         }
-
-        sample = pendingPositionSample_;
-        pendingPositionDirty_.store(false, std::memory_order_release);
+        notifyState_->stop = true;
+        SetEvent(notifyState_->wakeEvent);
     }
 
-    DeviceState& device = ensureDeviceStateLocked(sample.deviceId);
-    device.emitterPosition = sample.emitter;
-    device.playerPosition = sample.player;
-    device.playerYawDeg = sample.playerYawDeg;
-
-    if (sample.deviceId != currentDeviceId_) {
-        return false;
+    if (notifyState_->thread.joinable()) {
+        notifyState_->thread.join();
     }
 
-    emitterPosition_ = sample.emitter;
-    playerPosition_ = sample.player;
-    playerYawDeg_ = sample.playerYawDeg;
-    if (state_ == PlaybackState::Playing) {
-        updateFadeVolumeLocked();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const HANDLE handle : notifyState_->retiredHandles) {
+        CloseHandle(handle);
     }
-    return true;
+    for (const auto& [deviceId, watch] : notifyState_->directShowWatches) {
+        if (watch.event != nullptr) {
+            CloseHandle(watch.event);
+        }
+    }
+    CloseHandle(notifyState_->wakeEvent);
+    notifyState_.reset();
 }
 
-bool RadioEngine::runAsyncCommandForDevice(
-    std::uint64_t deviceId,
-    const std::function<bool()>& command,
-    const std::function<void(bool result)>& completion)
+void RadioEngine::notifyThreadMain(std::promise<void*>& windowReady)
 {
-    std::unique_lock<std::mutex> lock(mutex_);
+    HMODULE module = nullptr;
+    (void)GetModuleHandleExW(
+        GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+        reinterpret_cast<LPCWSTR>(&NotifyState::windowProc),
+        &module);
 
-    if (!workerRunning_ || std::this_thread::get_id() == workerThreadId_) {
-        switchToDeviceLocked(deviceId);
-        clearPlayInterruptRequest();
-        bool result = false;
-        try {
-            result = command();
-        } catch (const std::exception& ex) {
-            result = false;
-            logger_.error(std::string("Unhandled exception in async command: ") + ex.what());
-        } catch (...) {
-            result = false;
-            logger_.error("Unhandled unknown exception in async command.");
-        }
-        syncCurrentDeviceStateLocked();
-        (void)maybeFlushPersistentSessionLocked();
-        lock.unlock();
-        if (completion) {
-            completion(result);
-        }
-        return true;
+    WNDCLASSEXW windowClass{};
+    windowClass.cbSize = sizeof(windowClass);
+    windowClass.lpfnWndProc = &NotifyState::windowProc;
+    windowClass.hInstance = module;
+    windowClass.lpszClassName = kNotifyWindowClass;
+    if (RegisterClassExW(&windowClass) == 0 && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
+        windowReady.set_value(nullptr);
+        return;
+    }
+
+    const HWND window = CreateWindowExW(0, kNotifyWindowClass, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, module, nullptr);
+    if (window != nullptr) {
+        (void)SetWindowLongPtrW(window, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+    }
+    windowReady.set_value(window);
+    if (window == nullptr) {
+        return;
     }
 
-    commandQueue_.emplace_back([this, command, completion, deviceId]() {
-        bool result = false;
+    for (;;) {
+        std::vector<HANDLE> retired;
+        std::vector<HANDLE> handles{ notifyState_->wakeEvent };
+        std::vector<std::uint64_t> handleDevices{ 0 };
         {
-            std::unique_lock<std::mutex> lock(mutex_);
-            try {
-                switchToDeviceLocked(deviceId);
-                clearPlayInterruptRequest();
-                result = command();
-            } catch (const std::exception& ex) {
-                result = false;
-                logger_.error(std::string("Unhandled exception in queued async command: ") + ex.what());
-            } catch (...) {
-                result = false;
-                logger_.error("Unhandled unknown exception in queued async command.");
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (notifyState_->stop) {
+                break;
+            }
+            retired.swap(notifyState_->retiredHandles);
+            for (const auto& [deviceId, watch] : notifyState_->directShowWatches) {
+                if (watch.armed && watch.event != nullptr && handles.size() < MAXIMUM_WAIT_OBJECTS - 1) {
+                    handles.push_back(watch.event);
+                    handleDevices.push_back(deviceId);
+                }
             }
-            syncCurrentDeviceStateLocked();
-            (void)maybeFlushPersistentSessionLocked();
         }
-        if (completion) {
-            completion(result);
+
+        // Retired handles are only closed here, so an in-flight wait never sees a closed handle.
+        for (const HANDLE handle : retired) {
+            CloseHandle(handle);
         }
-        cv_.notify_all();
-    });
 
-    lock.unlock();
-    cv_.notify_all();
-    return true;
+        const DWORD waitResult = MsgWaitForMultipleObjectsEx(
+            static_cast<DWORD>(handles.size()), handles.data(), INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        if (waitResult > WAIT_OBJECT_0 && waitResult < WAIT_OBJECT_0 + handles.size()) {
+            const std::size_t index = waitResult - WAIT_OBJECT_0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                const auto watchIt = notifyState_->directShowWatches.find(handleDevices[index]);
+                if (watchIt != notifyState_->directShowWatches.end() && watchIt->second.event == handles[index]) {
+                    watchIt->second.armed = false;
+                }
+                playbackEventPending_ = true;
+            }
+            cv_.notify_all();
+        }
+
+        MSG message{};
+        while (PeekMessageW(&message, nullptr, 0, 0, PM_REMOVE)) {
+            TranslateMessage(&message);
+            DispatchMessageW(&message);
+        }
+    }
+
+    DestroyWindow(window);
 }
 
-bool RadioEngine::runBoolCommandForDevice(std::uint64_t deviceId, const std::function<bool()>& command)
+void RadioEngine::armDirectShowNotifyLocked()
 {
-    std::unique_lock<std::mutex> lock(mutex_);
-
-    if (!workerRunning_) {
-        switchToDeviceLocked(deviceId);
-        clearPlayInterruptRequest();
-        const bool result = command();
-        syncCurrentDeviceStateLocked();
-        (void)maybeFlushPersistentSessionLocked();
-        return result;
+    if (!notifyState_ || !dsState_ || !dsState_->events) {
+        return;
     }
 
-    if (std::this_thread::get_id() == workerThreadId_) {
-        switchToDeviceLocked(deviceId);
-        clearPlayInterruptRequest();
-        const bool result = command();
-        syncCurrentDeviceStateLocked();
-        (void)maybeFlushPersistentSessionLocked();
-        return result;
+    NotifyState::DirectShowWatch& watch = notifyState_->directShowWatches[currentDeviceId_];
+    if (watch.armed) {
+        return;
     }
 
-    struct PendingResult
-    {
-        bool done{ false };
-        bool result{ false };
-    };
+    OAEVENT source = 0;
+    if (FAILED(dsState_->events->GetEventHandle(&source)) || source == 0) {
+        return;
+    }
 
-    auto pending = std::make_shared<PendingResult>();
-    commandQueue_.emplace_back([this, command, pending, deviceId]() {
-        {
-            std::unique_lock<std::mutex> lock(mutex_);
-            try {
-                switchToDeviceLocked(deviceId);
-                clearPlayInterruptRequest();
-                pending->result = command();
-            } catch (const std::exception& ex) {
-                pending->result = false;
-                logger_.error(std::string("Unhandled exception in queued command: ") + ex.what());
-            } catch (...) {
-                pending->result = false;
-                logger_.error("Unhandled unknown exception in queued command.");
-            }
-            syncCurrentDeviceStateLocked();
-            (void)maybeFlushPersistentSessionLocked();
-            pending->done = true;
+    if (watch.event == nullptr || watch.source != source) {
+        HANDLE duplicate = nullptr;
+        if (!DuplicateHandle(
+                GetCurrentProcess(),
+                reinterpret_cast<HANDLE>(source),
+                GetCurrentProcess(),
+                &duplicate,
+                SYNCHRONIZE,
+                FALSE,
+                0)) {
+            return;
         }
-        cv_.notify_all();
-    });
+        if (watch.event != nullptr) {
+            notifyState_->retiredHandles.push_back(watch.event);
+        }
+        watch.event = duplicate;
+        watch.source = source;
+    }
 
-    lock.unlock();
-    cv_.notify_all();
-    lock.lock();
-    const bool completed = cv_.wait_for(lock, kCommandWaitTimeout, [this, pending]() {
-        return pending->done || !workerRunning_;
-    });
-    if (!completed) {
-        logger_.error("Radio command timed out waiting for worker completion (deviceId=" +
-                      std::to_string(deviceId) + ").");
-        return false;
+    watch.armed = true;
+    SetEvent(notifyState_->wakeEvent);
+}
+
+void RadioEngine::disarmDirectShowNotifyLocked()
+{
+    if (!notifyState_) {
+        return;
+    }
+
+    const auto watchIt = notifyState_->directShowWatches.find(currentDeviceId_);
+    if (watchIt == notifyState_->directShowWatches.end()) {
+        return;
     }
 
-    return pending->done ? pending->result : false;
+    if (watchIt->second.event != nullptr) {
+        notifyState_->retiredHandles.push_back(watchIt->second.event);
+    }
+    notifyState_->directShowWatches.erase(watchIt);
+    SetEvent(notifyState_->wakeEvent);
 }
 
 void RadioEngine::workerLoop()
@@ -4980,20 +9005,38 @@ void RadioEngine::workerLoop()
     std::unique_lock<std::mutex> lock(mutex_);
     workerThreadId_ = std::this_thread::get_id();
     while (!stopWorker_) {
-        cv_.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+        const auto wakeCondition = [this]() {
             return stopWorker_ ||
                    !commandQueue_.empty() ||
+                   !priorityQueue_.empty() ||
+                   playbackEventPending_ ||
                    pendingPositionDirty_.load(std::memory_order_acquire);
-        });
+        };
+        const auto deadline = nextWorkerDeadlineLocked();
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            cv_.wait(lock, wakeCondition);
+        } else {
+            cv_.wait_until(lock, deadline, wakeCondition);
+        }
+        stats_.workerWakeups.fetch_add(1, std::memory_order_relaxed);
         if (stopWorker_) {
             break;
         }
 
-        while (!commandQueue_.empty()) {
-            auto command = std::move(commandQueue_.front());
-            commandQueue_.pop_front();
+        while (!priorityQueue_.empty() || !commandQueue_.empty()) {
+            // Stop/pause are taken ahead of queued work; requestPlayInterrupt has already cut short
+            // whatever was running when they arrived.
+            std::vector<QueuedCommand>& lane = priorityQueue_.empty() ? commandQueue_ : priorityQueue_;
+            QueuedCommand command = std::move(lane.front());
+            lane.erase(lane.begin());
+            const std::size_t kindIndex = static_cast<std::size_t>(command.kind);
+            const auto startedAt = std::chrono::steady_clock::now();
+            if (command.enqueuedAt != std::chrono::steady_clock::time_point{}) {
+                stats_.commandWait[kindIndex].record(startedAt - command.enqueuedAt);
+            }
             lock.unlock();
-            command();
+            runQueuedCommand(command);
+            stats_.commandRun[kindIndex].record(std::chrono::steady_clock::now() - startedAt);
             lock.lock();
             if (stopWorker_) {
                 break;
@@ -5003,26 +9046,132 @@ void RadioEngine::workerLoop()
             break;
         }
 
-        const bool updatedCurrentPosition = applyPendingPositionSampleLocked();
-        if (state_ == PlaybackState::Playing) {
-            if (isTrackCompleteLocked()) {
-                (void)updateTrackLocked(true);
-            } else if (!updatedCurrentPosition) {
-                updateFadeVolumeLocked();
+        std::vector<std::uint64_t> fadeUpdatedDevices;
+        applyPendingPositionSampleLocked(fadeUpdatedDevices);
+        const bool playbackEvent = std::exchange(playbackEventPending_, false);
+        const std::vector<unsigned int> notifiedMciDevices = std::exchange(mciNotifiedDeviceIds_, {});
+        const std::vector<std::uint64_t> playingDevices = playingDeviceIdsLocked();
+        if (!playingDevices.empty()) {
+            // Every playing device owns its backend; tick each one through the mirror, then return home.
+            const std::uint64_t homeDeviceId = currentDeviceId_;
+            const auto now = std::chrono::steady_clock::now();
+            for (const std::uint64_t deviceId : playingDevices) {
+                switchToDeviceLocked(deviceId);
+                const bool fadeUpdated =
+                    std::find(fadeUpdatedDevices.begin(), fadeUpdatedDevices.end(), deviceId) != fadeUpdatedDevices.end();
+                tickCurrentDeviceLocked(now, playbackEvent, notifiedMciDevices, fadeUpdated);
+                syncCurrentDeviceStateLocked();
+            }
+            switchToDeviceLocked(homeDeviceId);
+
+            // Keep ticking at the fade rate until every audible device has reached its target.
+            fadeRampPending_ = false;
+            if (config_.fadeUpdateHz > 0.0F) {
+                for (const std::uint64_t deviceId : playingDevices) {
+                    const auto deviceIt = deviceStates_.find(deviceId);
+                    if (deviceIt != deviceStates_.end() && !deviceIt->second.fadeMotion.settled) {
+                        fadeRampPending_ = true;
+                        break;
+                    }
+                }
+                nextFadeRampTime_ = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(1.0 / static_cast<double>(config_.fadeUpdateHz)));
             }
-            syncCurrentDeviceStateLocked();
             (void)maybeFlushPersistentSessionLocked();
+        } else {
+            fadeRampPending_ = false;
+            if (sessionStateDirty_) {
+                (void)maybeFlushPersistentSessionLocked();
+            }
         }
+        maintainStreamStandbyLocked();
+        publishStatusSnapshotLocked();
+        maybeLogStatsLocked(std::chrono::steady_clock::now());
+        maybeQueueConfigReloadLocked(std::chrono::steady_clock::now());
     }
 
-    stopPlaybackDeviceLocked(true);
+    // Standby and reconnect players must be gone before the last MFShutdown; pending resolves
+    // (standby and reconnect alike land in retiredStandbyResolves_) hold logger_.
+    clearStreamStandbyLocked();
+    stopAllPlaybackDevicesLocked(true);
+    for (auto& resolve : retiredStandbyResolves_) {
+        resolve.wait();
+    }
+    retiredStandbyResolves_.clear();
     stopFxLocked();
-    state_ = PlaybackState::Stopped;
+    if (mixer_) {
+        mixer_->shutdown();
+        mixer_.reset();
+    }
     mode_ = PlaybackMode::None;
-    trackStartValid_ = false;
-    shutdownDirectShowLocked();
-    shutdownMediaFoundationLocked();
     syncCurrentDeviceStateLocked();
     (void)maybeFlushPersistentSessionLocked(true);
+    publishStatusSnapshotLocked();
+    maybeLogStatsLocked(std::chrono::steady_clock::now(), true);
     workerThreadId_ = {};
 }
+
+void RadioEngine::tickCurrentDeviceLocked(
+    std::chrono::steady_clock::time_point now,
+    bool playbackEvent,
+    const std::vector<unsigned int>& notifiedMciDevices,
+    bool fadeAlreadyUpdated)
+{
+    if (state_ != PlaybackState::Playing) {
+        return;
+    }
+
+    const bool pollDue = playbackEvent || now >= nextPlaybackPollTime_;
+    if (streamReconnect_) {
+        if (pollDue) {
+            serviceStreamReconnectLocked(now);
+        }
+        return;
+    }
+
+    // Re-read the remaining time only when the estimate is stale or a preload/handoff point is due.
+    std::optional<int> remainingMs;
+    if (backend_ == PlaybackBackend::MCI && (!trackEndValid_ || now >= trackDeadlineLocked())) {
+        remainingMs = remainingTrackMsLocked();
+        trackEndValid_ = remainingMs.has_value();
+        if (remainingMs.has_value()) {
+            trackEndTime_ = now + std::chrono::milliseconds(*remainingMs);
+            maybePreloadNextTrackLocked(*remainingMs);
+        }
+    }
+
+    bool endNotified = false;
+    if (backend_ == PlaybackBackend::MCI && !notifiedMciDevices.empty()) {
+        const unsigned int activeDevice = playbackHooks_.mciDeviceId(activeAlias_.c_str());
+        endNotified = activeDevice != 0 &&
+                      std::find(notifiedMciDevices.begin(), notifiedMciDevices.end(), activeDevice) != notifiedMciDevices.end();
+    }
+    if (backend_ == PlaybackBackend::MCI && (pollDue || !notifiedMciDevices.empty())) {
+        closeDrainedStandbyLocked(notifiedMciDevices, false);
+    }
+    const bool handoffDue = preload_.valid && remainingMs.has_value() && *remainingMs <= kGaplessHandoffLeadMs;
+    if (endNotified || handoffDue || (pollDue && isTrackCompleteLocked())) {
+        (void)updateTrackLocked(true);
+    } else if (!fadeAlreadyUpdated) {
+        updateFadeVolumeLocked();
+    }
+    if (pollDue) {
+        nextPlaybackPollTime_ = now + kPlaybackSafetyPoll;
+        // With an exact length the end is already scheduled off trackEndTime_, and MCI notifies on
+        // aborts, so the "status mode" safety poll can wait until the track is nearly done.
+        const TrackAnalysis* analysis = backend_ == PlaybackBackend::MCI ? currentTrackAnalysisLocked() : nullptr;
+        if (analysis != nullptr && analysis->durationMs > 0 && trackEndValid_) {
+            nextPlaybackPollTime_ = std::max(nextPlaybackPollTime_, trackEndTime_ - kPlaybackSafetyPoll);
+        }
+        if (standbyDraining_) {
+            nextPlaybackPollTime_ = now + kStandbyDrainPoll;
+        }
+    }
+
+    // The DirectShow event is manual-reset and only clears once the queue is drained, which
+    // isTrackCompleteLocked() skips during the start-up probe window.
+    if (backend_ == PlaybackBackend::DirectShowStream && trackStartValid_ &&
+        now - trackStartTime_ >= kStreamCompletionProbeDelay) {
+        armDirectShowNotifyLocked();
+    }
+}
@@ -1,29 +1,70 @@
 #pragma once
 
+#include "fx_cache.h"
+#include "inplace_function.h"
+#include "latency_histogram.h"
+#include "library_analyzer.h"
+#include "library_watcher.h"
 #include "logger.h"
+#include "track_list.h"
 
+#include <array>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <deque>
 #include <filesystem>
 #include <functional>
+#include <future>
 #include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <set>
 #include <utility>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+class AudioMixer;
+class InternetSession;
+
 class RadioEngine
 {
 public:
+    // Read-only view of one device, rebuilt by the worker whenever the device state is synced.
+    // trackSequence increments each time the device starts a different track.
+    struct DeviceStatus
+    {
+        bool playing{ false };
+        std::int32_t mediaType{ 1 };
+        std::int32_t playMode{ 0 };
+        float volumePercent{ 100.0F };
+        std::uint32_t trackSequence{ 0 };
+        std::string selectedKey;
+        std::string sourceName;
+        std::string track;
+        std::string trackBasename;
+
+        bool operator==(const DeviceStatus&) const = default;
+    };
+
+    // Calls that reach MCI devices. The defaults go straight to winmm; the headless benchmark swaps
+    // in stubs so the engine can run without sound hardware. Install before initialize().
+    struct PlaybackHooks
+    {
+        std::uint32_t (*mciSendString)(const wchar_t* command, wchar_t* output, std::uint32_t outputSize, void* callbackWindow){ nullptr };
+        std::uint32_t (*mciDeviceId)(const wchar_t* alias){ nullptr };
+    };
+
     explicit RadioEngine(Logger& logger);
     ~RadioEngine();
 
+    void setPlaybackHooks(const PlaybackHooks& hooks);
+
     bool initialize();
     void shutdown();
     void savePersistentSession();
@@ -57,6 +98,8 @@ public:
         std::uint64_t deviceId = 0,
         const std::function<void(bool result)>& completion = {});
     bool rescanLibrary(std::uint64_t deviceId = 0);
+    // Re-reads RadioSFSE.ini and applies only the settings that changed; playback keeps running.
+    bool reloadConfig();
     bool isPlaying(std::uint64_t deviceId = 0) const;
     bool changeToNextSource(int category, std::uint64_t deviceId = 0);
     bool selectNextSource(int category, std::uint64_t deviceId = 0);
@@ -106,8 +149,13 @@ public:
     std::string currentSourceName(std::uint64_t deviceId = 0) const;
     std::string currentTrackBasename(std::uint64_t deviceId = 0) const;
     std::size_t channelCount() const;
+    DeviceStatus deviceStatus(std::uint64_t deviceId = 0) const;
+    // One line per metric with samples, e.g. "cmd.ChangePlaylist.wait n=3 mean=...". Lock-free.
+    std::vector<std::string> statsLines() const;
 
 private:
+    friend class RadioEngineBench;
+
     enum class ChannelType
     {
         Playlist,
@@ -139,9 +187,13 @@ private:
         None,
         MCI,
         MediaFoundationStream,
-        DirectShowStream
+        DirectShowStream,
+        NativeMixer
     };
 
+    // Backends with an open-to-playing histogram: every value after None.
+    static constexpr std::size_t kBackendStatCount = static_cast<std::size_t>(PlaybackBackend::NativeMixer);
+
     struct Position
     {
         float x{ 0.0F };
@@ -157,20 +209,54 @@ private:
         float playerYawDeg{ 0.0F };
     };
 
+    // One seqlock-protected slot per device id. Papyrus threads publish here without taking any
+    // lock; the worker drains every changed slot in applyPendingPositionSampleLocked().
+    struct PositionMailboxSlot
+    {
+        std::atomic<std::uint64_t> deviceId{ ~0ULL };
+        std::atomic<std::uint32_t> sequence{ 0 };
+        std::atomic<float> emitterX{ 0.0F };
+        std::atomic<float> emitterY{ 0.0F };
+        std::atomic<float> emitterZ{ 0.0F };
+        std::atomic<float> playerX{ 0.0F };
+        std::atomic<float> playerY{ 0.0F };
+        std::atomic<float> playerZ{ 0.0F };
+        std::atomic<float> playerYawDeg{ 0.0F };
+    };
+
+    static constexpr std::size_t kPositionMailboxSlots = 32;
+    static constexpr std::uint64_t kFreeMailboxSlot = ~0ULL;
+
     struct Config
     {
         std::filesystem::path radioRootPath;
         std::string transitionPrefix{ "transition_" };
         std::string adPrefix{ "ad_" };
         std::size_t adIntervalSongs{ 3 };
+        bool liveStations{ false };
         float minFadeDistance{ 0.1F };
         float maxFadeDistance{ 35.0F };
         bool enableSpatialPan{ true };
         float panDistance{ 40.0F };
+        float fadeUpdateHz{ 25.0F };
+        float fadeSmoothingMs{ 120.0F };
+        float fadeMaxExtrapolationMs{ 1000.0F };
         bool logFadeChanges{ false };
         bool autoRescanOnChangePlaylist{ true };
+        bool watchLibrary{ true };
+        std::int32_t libraryWatchDebounceMs{ 750 };
+        bool watchConfig{ false };
         bool loopPlaylist{ true };
         bool verboseStreamDiagnostics{ false };
+        std::int32_t streamStandbyCount{ 0 };
+        bool streamReconnect{ true };
+        std::int32_t libraryAnalysisThreads{ 1 };
+        bool loudnessNormalization{ false };
+        float loudnessTargetLufs{ -18.0F };
+        std::int32_t fxCacheMegabytes{ 16 };
+        std::int32_t statsLogMinutes{ 15 };
+        bool nativeAudioBackend{ false };
+        std::int32_t streamCacheTtlMinutes{ 720 };
         float volumeStepPercent{ 20.0F };
         std::int32_t debugVerbosity{ 0 };
         bool dialogDuckEnabled{ false };
@@ -186,9 +272,280 @@ private:
         ChannelType type{ ChannelType::Playlist };
         bool isStream{ false };
         std::string streamUrl;
-        std::vector<std::filesystem::path> songs;
-        std::vector<std::filesystem::path> transitions;
-        std::vector<std::filesystem::path> ads;
+        TrackList songs;
+        TrackList transitions;
+        TrackList ads;
+    };
+
+    // Dense index into channelTable_; valid until the channel set is next rebuilt.
+    using ChannelHandle = std::uint32_t;
+    static constexpr ChannelHandle kAmbiguousChannelHandle = 0xFFFF'FFFFU;
+
+    struct LibraryIndexEntry
+    {
+        std::string key;
+        std::string name;
+        long long directoryWriteTime{ 0 };
+        std::vector<std::string> songs;
+        std::vector<std::string> transitions;
+        std::vector<std::string> ads;
+        // Keyed by file name; entries only for files the background analyzer has measured.
+        std::map<std::string, TrackAnalysis> analysis;
+    };
+
+    struct LibraryScanSettings
+    {
+        std::filesystem::path radioRootPath;
+        std::string transitionPrefix;
+        std::string adPrefix;
+    };
+
+    struct LibrarySnapshot
+    {
+        std::map<std::string, ChannelEntry> channels;
+        std::map<std::string, std::filesystem::path> fxFiles;
+        std::map<std::string, LibraryIndexEntry> index;
+        bool indexDirty{ false };
+        std::size_t reusedCount{ 0 };
+        std::size_t relistedCount{ 0 };
+    };
+
+    // The re-listed part of the library after the watcher reported some source folders. A key in
+    // changedKeys but not in channels lost its folder or its last song; a null index entry is erased.
+    struct LibraryUpdate
+    {
+        std::set<std::string> changedKeys;
+        std::map<std::string, ChannelEntry> channels;
+        std::optional<std::map<std::string, std::filesystem::path>> fxFiles;
+        std::map<std::string, std::optional<LibraryIndexEntry>> index;
+    };
+
+    struct StreamResolutionEntry
+    {
+        std::string resolvedUrl;
+        std::string candidate;
+        PlaybackBackend backend{ PlaybackBackend::None };
+        long long confirmedAtUnix{ 0 };
+    };
+
+    // Shuffle order as a seeded permutation of the channel's songs rather than a play history.
+    // Play position p of cycle `epoch` is permutation(seed, epoch)[(p + offset) % songCount], so
+    // advancing, retreating and persisting are O(1) whatever the playlist length. songCount == 0
+    // means no order has been anchored yet.
+    struct ShuffleOrder
+    {
+        std::uint64_t seed{ 0 };
+        std::uint64_t epoch{ 0 };
+        std::size_t cursor{ 0 };
+        std::size_t offset{ 0 };
+        std::size_t songCount{ 0 };
+
+        bool operator==(const ShuffleOrder&) const = default;
+    };
+
+    // One pass through a live station's programme: every song once in a station-seeded order, each
+    // followed by an ad (after every adIntervalSongs songs) or a transition. Slot times come from the
+    // analyzed durations, so every device derives the same track and offset from the wall clock.
+    struct LiveTimeline
+    {
+        struct Slot
+        {
+            TrackKind kind{ TrackKind::Song };
+            std::size_t index{ 0 };
+            std::uint64_t startMs{ 0 };
+        };
+
+        std::vector<Slot> slots;
+        std::uint64_t cycleMs{ 0 };
+        // Per-station shift so stations with similar libraries are not in lockstep.
+        std::uint64_t phaseMs{ 0 };
+    };
+
+    struct LiveCue
+    {
+        std::filesystem::path path;
+        std::uint64_t offsetMs{ 0 };
+    };
+
+    struct TrackSequenceState
+    {
+        std::size_t songIndex{ 0 };
+        std::size_t transitionIndex{ 0 };
+        std::size_t adIndex{ 0 };
+        std::size_t songsSinceAd{ 0 };
+        bool previousWasSong{ false };
+        ShuffleOrder shuffle{};
+    };
+
+    struct PreloadedTrack
+    {
+        bool valid{ false };
+        std::filesystem::path path;
+        std::uint64_t deviceId{ 0 };
+        std::string selectedKey;
+        TrackOrderMode trackOrderMode{ TrackOrderMode::Alphabetical };
+        TrackSequenceState sequenceAfter{};
+        std::filesystem::path attemptedTrack;
+    };
+
+    // MCI's length for the file open on one alias; it never changes while the track plays.
+    struct TrackLengthCache
+    {
+        std::wstring alias;
+        std::filesystem::path path;
+        int lengthMs{ 0 };
+    };
+
+    // Persisted subset of a DeviceState, compared field-wise to find devices that need re-encoding.
+    struct SessionDeviceRecord
+    {
+        std::int32_t mediaType{ 1 };
+        std::int32_t playMode{ 0 };
+        std::string selectedKey;
+        std::string currentTrackName;
+        std::string currentTrackKind;
+        std::uint64_t resumePositionMs{ 0 };
+        std::size_t songIndex{ 0 };
+        std::size_t transitionIndex{ 0 };
+        std::size_t adIndex{ 0 };
+        std::size_t songsSinceAd{ 0 };
+        bool previousWasSong{ false };
+        float volumePercent{ 100.0F };
+        ShuffleOrder shuffle{};
+
+        bool operator==(const SessionDeviceRecord&) const = default;
+    };
+
+    // Handed to the session writer; a nullopt record drops that device from the file.
+    struct SessionWriteJob
+    {
+        std::filesystem::path path;
+        bool replaceAll{ false };
+        std::map<std::uint64_t, std::optional<SessionDeviceRecord>> devices;
+        std::uint64_t generation{ 0 };
+    };
+
+    // Stream cache file contents, also handed to the session writer; a newer job replaces a pending one.
+    struct StreamCacheWriteJob
+    {
+        std::filesystem::path path;
+        std::string payload;
+    };
+
+    // Published through statusSnapshot_ after each command and worker pass. The const getters read it
+    // without taking mutex_, so they never wait behind a stream open or a library install.
+    struct StatusSnapshot
+    {
+        std::unordered_map<std::uint64_t, DeviceStatus> devices;
+        std::size_t channelCount{ 0 };
+        float volumeStepPercent{ 0.0F };
+        std::int32_t debugVerbosity{ 0 };
+        bool dialogDuckEnabled{ false };
+        float dialogDuckVolume{ 0.0F };
+
+        bool operator==(const StatusSnapshot&) const = default;
+    };
+
+    struct MfState;
+    struct DsState;
+    struct MutedStreamPlayer;
+    struct StreamStandby;
+    struct StreamReconnect;
+    struct NotifyState;
+
+    // Worker queue entries. Repeated presses (Volume, Forward, Rewind, Previous) fold into the pending
+    // entry of the same kind for their device and a new ChangePlaylist replaces a pending one. Stop and
+    // Pause go to the priority lane. Task entries are internal work that takes the mutex itself.
+    enum class CommandKind
+    {
+        Task,
+        Generic,
+        Transport,
+        Volume,
+        Forward,
+        Rewind,
+        Previous,
+        ChangePlaylist,
+        // Source cycling: changes the selection and leaves the device stopped.
+        SelectSource,
+        Stop,
+        Pause,
+        Count
+    };
+
+    static constexpr std::size_t kCommandKindCount = static_cast<std::size_t>(CommandKind::Count);
+    static const char* commandKindName(CommandKind kind);
+
+    // Counters behind statsLines(). The worker, the session writer and Papyrus threads record into
+    // these without taking mutex_.
+    struct EngineStats
+    {
+        std::chrono::steady_clock::time_point startedAt{ std::chrono::steady_clock::now() };
+        std::array<LatencyHistogram, kCommandKindCount> commandWait{};
+        std::array<LatencyHistogram, kCommandKindCount> commandRun{};
+        std::array<LatencyHistogram, kBackendStatCount> backendOpen{};
+        LatencyHistogram streamResolve;
+        LatencyHistogram sessionSave;
+        std::atomic<std::uint64_t> commandsMerged{ 0 };
+        std::atomic<std::uint64_t> workerWakeups{ 0 };
+        // Dropped: skipped while another thread wrote the same slot, or during start-up/shutdown.
+        // Coalesced: overwritten in the mailbox before the worker applied them.
+        std::atomic<std::uint64_t> positionSamplesDropped{ 0 };
+        std::atomic<std::uint64_t> positionSamplesCoalesced{ 0 };
+        std::atomic<std::uint64_t> streamReconnects{ 0 };
+        std::atomic<std::uint64_t> streamReconnectFailures{ 0 };
+    };
+
+    using CommandFunction = InplaceFunction<bool(), 64>;
+
+    // Per-call completion record, recycled through commandWaiterFree_. A sync caller sleeps on its own
+    // condition variable; an async caller leaves its completion here. Merged commands chain theirs.
+    struct CommandWaiter
+    {
+        std::condition_variable wake;
+        std::function<void(bool result)> completion{};
+        CommandWaiter* next{ nullptr };
+        bool done{ false };
+        bool result{ false };
+        bool abandoned{ false };
+    };
+
+    struct QueuedCommand
+    {
+        CommandKind kind{ CommandKind::Generic };
+        std::uint64_t deviceId{ 0 };
+        std::size_t repeat{ 1 };
+        float volumeDelta{ 0.0F };
+        CommandFunction command{};
+        CommandWaiter* waiters{ nullptr };
+        std::chrono::steady_clock::time_point enqueuedAt{};
+    };
+
+    // Stall detection for a playing stream: the last position its player reported and when it last moved.
+    struct StreamStallWatch
+    {
+        std::uint64_t lastPositionMs{ 0 };
+        std::chrono::steady_clock::time_point lastProgressAt{};
+    };
+
+    // Backend objects of a device that is not the current mirror; swapped in by switchToDeviceLocked.
+    struct PlaybackSlot
+    {
+        PlaybackBackend backend{ PlaybackBackend::None };
+        std::wstring primaryAlias;
+        std::wstring secondaryAlias;
+        std::wstring activeAlias;
+        PreloadedTrack preload{};
+        bool standbyDraining{ false };
+        TrackLengthCache trackLength{};
+        std::unique_ptr<MfState> mfState{};
+        std::unique_ptr<DsState> dsState{};
+        std::unique_ptr<StreamReconnect> streamReconnect{};
+        std::uint64_t mixerVoice{ 0 };
+        std::filesystem::path streamWrapperTempPath;
+        std::chrono::steady_clock::time_point nextPlaybackPollTime{};
+        std::chrono::steady_clock::time_point trackEndTime{};
+        bool trackEndValid{ false };
     };
 
     struct DeviceFadeOverride
@@ -199,6 +556,29 @@ private:
         float panDistance{ 0.0F };
     };
 
+    struct MotionSample
+    {
+        std::chrono::steady_clock::time_point time{};
+        Position emitter{};
+        Position player{};
+        float playerYawDeg{ 0.0F };
+    };
+
+    static constexpr std::size_t kMotionHistorySize = 4;
+
+    // Engine-owned fade state: recent position samples for extrapolation plus the smoothed output.
+    struct FadeMotion
+    {
+        std::array<MotionSample, kMotionHistorySize> history{};
+        std::size_t sampleCount{ 0 };
+        std::size_t nextSlot{ 0 };
+        double level{ 0.0 };
+        double pan{ 0.0 };
+        bool smoothedValid{ false };
+        std::chrono::steady_clock::time_point lastRampTime{};
+        bool settled{ true };
+    };
+
     struct DeviceState
     {
         std::int32_t mediaType{ 1 };
@@ -214,8 +594,7 @@ private:
         std::size_t adIndex{ 0 };
         std::size_t songsSinceAd{ 0 };
         bool previousWasSong{ false };
-        std::vector<std::size_t> shuffleHistory{};
-        std::size_t shuffleCursor{ 0 };
+        ShuffleOrder shuffle{};
 
         Position emitterPosition{};
         Position playerPosition{};
@@ -230,9 +609,13 @@ private:
 
         DeviceFadeOverride fadeOverride{};
         float volumeGain{ 1.0F };
+        FadeMotion fadeMotion{};
     };
 
-    bool loadConfig();
+    bool loadConfig(Config& config);
+    std::unique_ptr<LibraryWatcher> applyConfigLocked(Config next);
+    void reloadConfiguredStreamsLocked();
+    void maybeQueueConfigReloadLocked(std::chrono::steady_clock::time_point now);
     static std::filesystem::path configPath();
     static std::string trim(const std::string& text);
     static std::string toLower(std::string text);
@@ -243,13 +626,106 @@ private:
     static std::wstring quoteForMCI(const std::wstring& text);
 
     bool scanLibraryLocked();
+    LibraryScanSettings libraryScanSettingsLocked() const;
+    static LibrarySnapshot buildLibrarySnapshot(
+        const LibraryScanSettings& settings,
+        const std::map<std::string, LibraryIndexEntry>& previousIndex,
+        Logger& logger,
+        const std::atomic<bool>& stopRequested);
+    static LibraryIndexEntry listLibraryDirectory(
+        const LibraryScanSettings& settings,
+        const std::filesystem::path& directoryPath,
+        ChannelType channelType,
+        bool splitByPrefix);
+    static LibraryUpdate buildLibraryUpdate(
+        const LibraryScanSettings& settings,
+        const std::set<std::filesystem::path>& sources,
+        const std::map<std::string, LibraryIndexEntry>& previousIndex);
+    void installLibrarySnapshotLocked(LibrarySnapshot&& snapshot);
+    void installLibraryUpdateLocked(LibraryUpdate&& update);
+    void remapDevicesAfterLibraryChangeLocked(
+        const std::map<std::string, ChannelEntry>& previousChannels,
+        const std::set<std::string>* changedKeys);
+    bool requestLibraryRescanLocked();
+    void requestLibraryUpdateLocked(std::set<std::filesystem::path> sources);
+    void continueLibraryScansLocked();
+    bool rescanOnDemandLocked() const;
+    void libraryScanThreadMain(LibraryScanSettings settings, std::map<std::string, LibraryIndexEntry> previousIndex);
+    void libraryUpdateThreadMain(
+        LibraryScanSettings settings,
+        std::set<std::filesystem::path> sources,
+        std::map<std::string, LibraryIndexEntry> previousIndex);
+    void libraryIndexWriteThreadMain(LibraryScanSettings settings, std::map<std::string, LibraryIndexEntry> index);
+    void startLibraryWatcherLocked();
+    void onLibraryChanges(LibraryWatcher::Changes changes);
+    std::filesystem::path libraryIndexPathLocked() const;
+    static std::filesystem::path libraryIndexPath(const std::filesystem::path& radioRootPath);
+    bool loadLibraryIndexLocked();
+    static bool writeLibraryIndexFile(
+        const LibraryScanSettings& settings,
+        const std::map<std::string, LibraryIndexEntry>& index,
+        Logger& logger);
+    bool loadLibraryFromIndexLocked();
+    static ChannelEntry channelFromIndexEntry(
+        const LibraryIndexEntry& indexEntry,
+        const std::filesystem::path& directoryPath,
+        ChannelType channelType);
+    static void addFxFilesFromIndexEntry(
+        std::map<std::string, std::filesystem::path>& fxFiles,
+        const LibraryIndexEntry& indexEntry,
+        const std::filesystem::path& fxRoot);
     void addConfiguredStreamsLocked();
-    std::optional<ChannelEntry> lookupChannelLocked(const std::string& channelName) const;
+    void rebuildChannelIndexLocked();
+    static void carryTrackAnalysis(LibraryIndexEntry& target, const LibraryIndexEntry& source);
+    void scheduleLibraryAnalysisLocked(const std::set<std::string>* keys);
+    void onLibraryAnalysisReady();
+    void mergeLibraryAnalysisLocked();
+    void flushLibraryAnalysisLocked();
+    const TrackAnalysis* currentTrackAnalysisLocked();
+    double trackNormalizationGainLocked();
+    const ChannelEntry* lookupChannelLocked(const std::string& channelName) const;
+    const std::vector<ChannelHandle>* channelsInCategoryLocked(int category) const;
     bool startCurrentLocked(PlaybackMode mode, bool resetPosition);
     bool playPathLocked(const std::filesystem::path& filePath);
+    bool ensureAudioMixerLocked();
+    bool playNativeLocked(const std::filesystem::path& filePath);
     bool playStreamLocked(const std::string& streamUrl);
+    bool startStreamBackendLocked(const std::string& candidate, PlaybackBackend backend);
+    void markStreamPlayingLocked(PlaybackBackend backend, const std::string& directUrl, const std::string& candidate);
+    void maintainStreamStandbyLocked();
+    std::optional<StreamResolutionEntry> promoteStreamStandbyLocked(const std::string& directUrl);
+    void retireStreamStandbyLocked(StreamStandby& standby);
+    void clearStreamStandbyLocked();
+    void beginStreamReconnectLocked(const std::string& streamUrl);
+    void serviceStreamReconnectLocked(std::chrono::steady_clock::time_point now);
+    void failStreamReconnectAttemptLocked(std::chrono::steady_clock::time_point now);
+    void cancelStreamReconnectLocked();
+    bool openMutedStreamPlayerLocked(MutedStreamPlayer& muted, const std::string& candidate, const char* purpose);
+    bool startMutedStreamPlayerLocked(MutedStreamPlayer& muted);
+    void adoptMutedStreamPlayerLocked(MutedStreamPlayer& muted);
+    void shutdownMutedStreamPlayerLocked(MutedStreamPlayer& muted);
+    bool mfStreamStalledLocked();
+    std::optional<std::uint64_t> mfPlayerPositionMsLocked() const;
+    // True once positionMs has not moved for kStreamStallTimeout, counted from no earlier than notBefore.
+    static bool streamStalled(
+        StreamStallWatch& watch,
+        std::uint64_t positionMs,
+        std::chrono::steady_clock::time_point now,
+        std::chrono::steady_clock::time_point notBefore);
+    bool isStreamCacheEntryFreshLocked(const StreamResolutionEntry& entry) const;
+    void recordStreamWinnerLocked(
+        const std::string& directUrl,
+        const std::string& resolvedUrl,
+        const std::string& candidate,
+        PlaybackBackend backend);
+    std::filesystem::path streamCachePathLocked() const;
+    bool loadStreamCacheLocked();
+    bool saveStreamCacheLocked();
     bool playFxLocked(const std::filesystem::path& filePath);
     void stopFxLocked();
+    void refreshFxCacheLocked();
+    void recordBackendOpen(PlaybackBackend backend, std::chrono::steady_clock::time_point startedAt);
+    void maybeLogStatsLocked(std::chrono::steady_clock::time_point now, bool force = false);
     std::optional<std::filesystem::path> findFxPathLocked(const std::string& fxBasename);
     bool isPlayInterruptRequested() const;
     void clearPlayInterruptRequest();
@@ -261,13 +737,18 @@ private:
     void stopPlaybackDeviceLocked(bool closeDevice);
     bool resumeLocked();
     bool pauseLocked();
-    bool forwardLocked();
-    bool rewindLocked();
-    bool previousLocked();
+    bool forwardLocked(std::size_t steps = 1);
+    bool rewindLocked(std::size_t steps = 1);
+    bool previousLocked(std::size_t steps = 1);
+    bool applyVolumeDeltaLocked(float deltaGain);
     void syncResumePositionFromBackendLocked();
     std::uint64_t currentPlaybackPositionMsLocked();
     bool seekCurrentPlaybackLocked(std::uint64_t positionMs);
-    void resetShuffleHistoryLocked();
+    void resetShuffleOrderLocked();
+    void anchorShuffleOrderLocked(std::size_t songIndex, std::size_t songCount);
+    static std::size_t shuffleSongAt(const ShuffleOrder& order, std::uint64_t epoch, std::size_t position);
+    static bool shuffleSkipsEpochLead(const ShuffleOrder& order, std::uint64_t epoch);
+    static bool shuffleOrderMatches(const ShuffleOrder& order, std::size_t songIndex, std::size_t songCount);
     std::optional<std::size_t> ensureShuffleCurrentSongLocked(const ChannelEntry& channel);
     std::optional<std::size_t> advanceShuffleSongLocked(const ChannelEntry& channel);
     std::optional<std::size_t> retreatShuffleSongLocked(const ChannelEntry& channel);
@@ -275,13 +756,56 @@ private:
     bool isTrackCompleteLocked();
     std::optional<std::filesystem::path> chooseCurrentTrackLocked() const;
     std::optional<std::filesystem::path> advanceAndChooseNextTrackLocked();
+    TrackSequenceState captureTrackSequenceLocked() const;
+    void restoreTrackSequenceLocked(const TrackSequenceState& sequence);
+    bool liveStationActiveLocked(const ChannelEntry& channel) const;
+    const LiveTimeline& liveTimelineLocked(const ChannelEntry& channel);
+    std::optional<LiveCue> liveCueLocked(const ChannelEntry& channel, bool skipCurrentTrack);
+    bool startLiveStationLocked(const ChannelEntry& channel);
+    std::optional<int> remainingTrackMsLocked();
+    void maybePreloadNextTrackLocked(int remainingMs);
+    bool handoffPreloadedTrackLocked();
+    void discardPreloadLocked();
+    void closeDrainedStandbyLocked(const std::vector<unsigned int>& notifiedMciDevices, bool force);
+    std::wstring standbyAliasLocked() const;
     void updateFadeVolumeLocked();
-    double distanceLocked() const;
+    static void recordMotionSample(FadeMotion& motion, const PendingPositionSample& sample);
+    static bool predictMotion(
+        const FadeMotion& motion,
+        std::chrono::steady_clock::time_point now,
+        std::chrono::milliseconds maxExtrapolation,
+        Position& emitter,
+        Position& player,
+        float& playerYawDeg);
     std::filesystem::path sessionStatePathLocked() const;
     bool loadPersistentSessionLocked();
-    bool savePersistentSessionLocked();
+    bool savePersistentSessionLocked(bool force = false);
+    std::optional<SessionDeviceRecord> makeSessionRecordLocked(const DeviceState& state) const;
+    DeviceStatus makeDeviceStatusLocked(const DeviceState& state) const;
+    void publishStatusSnapshotLocked();
+    static const DeviceStatus* findDeviceStatus(const StatusSnapshot* snapshot, std::uint64_t deviceId);
+    static std::string encodeSessionDevice(std::uint64_t deviceId, const SessionDeviceRecord& record);
+    static bool writeSessionJob(
+        const SessionWriteJob& job,
+        std::map<std::uint64_t, std::string>& encodedDevices,
+        std::string& lastPayload,
+        Logger& logger);
+    static bool writeStreamCacheJob(const StreamCacheWriteJob& job, Logger& logger);
+    void startSessionWriterLocked();
+    void stopSessionWriter();
+    void sessionWriterMain();
+    bool postStreamProbeLocked(std::function<void()> probe);
+    void stopStreamProbes();
+    void streamProbeMain();
+    bool waitForSessionWrite(std::uint64_t generation);
 
+    std::uint32_t mciSend(
+        const std::wstring& command,
+        wchar_t* output = nullptr,
+        std::uint32_t outputSize = 0,
+        void* callbackWindow = nullptr) const;
     bool mciCommandLocked(const std::wstring& command, std::wstring* output = nullptr);
+    bool mciPlayLocked(const std::wstring& command);
     bool mciStatusNumberLocked(const std::wstring& statusName, int& outValue);
     bool mciStatusModeLocked(std::wstring& outMode);
     bool mciStatusModeSilentLocked(std::wstring& outMode);
@@ -290,15 +814,56 @@ private:
     bool maybeFlushPersistentSessionLocked(bool force = false);
     bool runAsyncCommandForDevice(
         std::uint64_t deviceId,
-        const std::function<bool()>& command,
-        const std::function<void(bool result)>& completion = {});
-    bool runBoolCommandForDevice(std::uint64_t deviceId, const std::function<bool()>& command);
+        CommandFunction command,
+        const std::function<void(bool result)>& completion = {},
+        CommandKind kind = CommandKind::Generic);
+    bool runBoolCommandForDevice(
+        std::uint64_t deviceId,
+        CommandFunction command,
+        CommandKind kind = CommandKind::Generic);
+    bool dispatchCommand(
+        QueuedCommand command,
+        const std::function<void(bool result)>& completion,
+        bool waitForResult);
+    CommandWaiter* enqueueCommandLocked(QueuedCommand command);
+    bool executeCommandLocked(QueuedCommand& command);
+    void runQueuedCommand(QueuedCommand& command);
+    CommandWaiter* acquireCommandWaiterLocked();
+    void releaseCommandWaiterLocked(CommandWaiter* waiter);
+    CommandWaiter* settleCommandWaitersLocked(CommandWaiter* waiters, bool result);
+    void runCommandCompletions(CommandWaiter* waiters, bool result);
     DeviceState makeCurrentDeviceStateLocked();
     void applyDeviceStateLocked(const DeviceState& state);
     void syncCurrentDeviceStateLocked();
     DeviceState& ensureDeviceStateLocked(std::uint64_t deviceId);
     void switchToDeviceLocked(std::uint64_t deviceId);
-    bool applyPendingPositionSampleLocked();
+    void parkPlaybackSlotLocked(std::uint64_t deviceId);
+    void restorePlaybackSlotLocked(std::uint64_t deviceId);
+    std::vector<std::uint64_t> playingDeviceIdsLocked() const;
+    void stopAllPlaybackDevicesLocked(bool releaseBackends);
+    void discardAllPreloadsLocked();
+    PositionMailboxSlot* claimPositionMailboxSlot(std::uint64_t deviceId);
+    void applyPendingPositionSampleLocked(std::vector<std::uint64_t>& fadeUpdatedDevices);
+    bool applyPositionSampleLocked(const PendingPositionSample& sample);
+
+    void tickCurrentDeviceLocked(
+        std::chrono::steady_clock::time_point now,
+        bool playbackEvent,
+        const std::vector<unsigned int>& notifiedMciDevices,
+        bool fadeAlreadyUpdated);
+    static std::chrono::steady_clock::time_point trackDeadline(
+        PlaybackBackend backend,
+        bool trackEndValid,
+        std::chrono::steady_clock::time_point trackEndTime,
+        const PreloadedTrack& preload,
+        const std::filesystem::path& currentTrackPath);
+    std::chrono::steady_clock::time_point trackDeadlineLocked() const;
+    std::chrono::steady_clock::time_point nextWorkerDeadlineLocked() const;
+    void startPlaybackNotifierLocked();
+    void stopPlaybackNotifier();
+    void notifyThreadMain(std::promise<void*>& windowReady);
+    void armDirectShowNotifyLocked();
+    void disarmDirectShowNotifyLocked();
 
     void workerLoop();
 
@@ -309,19 +874,86 @@ private:
     bool workerRunning_{ false };
     bool stopWorker_{ false };
     std::thread::id workerThreadId_{};
-    std::deque<std::function<void()>> commandQueue_{};
-    struct MfState;
-    struct DsState;
+    // Plain vectors reserved once at startup; after coalescing the queues stay short, so popping the
+    // front is cheaper than a deque's per-node allocations.
+    std::vector<QueuedCommand> commandQueue_{};
+    std::vector<QueuedCommand> priorityQueue_{};
+    std::vector<std::unique_ptr<CommandWaiter>> commandWaiterStorage_{};
+    CommandWaiter* commandWaiterFree_{ nullptr };
     std::unique_ptr<MfState> mfState_{};
+    // Set while the current device's stream is being reopened in the background; the device stays
+    // Playing with no backend until the new player is actually playing.
+    std::unique_ptr<StreamReconnect> streamReconnect_{};
     std::unique_ptr<DsState> dsState_{};
+    // Muted Media Foundation players kept warm on the stream stations next to the one playing;
+    // shared by all devices and keyed by the configured station URL.
+    std::vector<std::unique_ptr<StreamStandby>> streamStandbys_{};
+    // Device whose stream the standbys surround, and how long they outlive its stop.
+    std::uint64_t standbyDeviceId_{ 0 };
+    std::chrono::steady_clock::time_point standbyGraceUntil_{};
+    std::vector<std::future<std::string>> retiredStandbyResolves_{};
+    std::unique_ptr<NotifyState> notifyState_{};
+    // Shared by stream resolves and probes so per-host connections are reused across requests.
+    std::shared_ptr<InternetSession> internet_{};
+    std::unique_ptr<AudioMixer> mixer_{};
+    bool mixerUnavailable_{ false };
+    std::uint64_t mixerVoice_{ 0 };
+    std::uint64_t fxMixerVoice_{ 0 };
+    std::unique_ptr<FxCache> fxCache_{};
+    // Held while PlaySound reads from it; PlaySound does not copy SND_MEMORY images.
+    FxCache::Clip fxClipPlaying_{};
+    bool playbackEventPending_{ false };
+    bool fadeRampPending_{ false };
+    std::chrono::steady_clock::time_point nextFadeRampTime_{};
+    std::vector<unsigned int> mciNotifiedDeviceIds_{};
+    std::chrono::steady_clock::time_point nextPlaybackPollTime_{};
+    std::chrono::steady_clock::time_point trackEndTime_{};
+    bool trackEndValid_{ false };
+    // The standby alias still plays the end of the track a gapless handoff moved off.
+    bool standbyDraining_{ false };
+    TrackLengthCache trackLength_{};
 
     Config config_{};
     std::map<std::string, ChannelEntry> channels_;
+    // Derived from channels_ by rebuildChannelIndexLocked(). channelTable_ points into the map's
+    // nodes; channelAliases_ maps every lowercase name a source answers to (key, "playlists/x",
+    // bare name, display name) to its handle; channelsByCategory_ holds media types 1..3 in
+    // source-cycling order, with channelCategoryPosition_ giving each handle's slot in its list.
+    std::vector<const ChannelEntry*> channelTable_;
+    std::unordered_map<std::string, ChannelHandle> channelAliases_;
+    std::array<std::vector<ChannelHandle>, 3> channelsByCategory_{};
+    std::vector<std::size_t> channelCategoryPosition_;
     std::map<std::string, std::filesystem::path> fxFiles_;
+    std::map<std::string, LibraryIndexEntry> libraryIndex_;
+    std::thread libraryScanThread_;
+    bool libraryScanRunning_{ false };
+    bool libraryScanQueued_{ false };
+    // Set when the split prefixes or the root changed: the next scan ignores the index's listings.
+    bool libraryRelistPending_{ false };
+    // Source folders the watcher reported while a scan or update was running.
+    std::set<std::filesystem::path> pendingLibraryChanges_;
+    std::unique_ptr<LibraryWatcher> libraryWatcher_{};
+    std::unique_ptr<LibraryAnalyzer> analyzer_{};
+    bool analysisMergeQueued_{ false };
+    bool libraryAnalysisDirty_{ false };
+    bool libraryAnalysisFullPassPending_{ false };
+    // Analysis of currentTrackPath_, looked up once per track rather than on every fade tick.
+    std::filesystem::path analysisLookupPath_;
+    std::optional<TrackAnalysis> analysisLookup_;
+    // Built on first tune-in and dropped whenever the library or its analysis changes.
+    std::unordered_map<std::string, LiveTimeline> liveTimelines_;
+    std::atomic<bool> libraryScanStop_{ false };
     std::vector<std::string> streamOrderKeys_;
+    std::map<std::string, StreamResolutionEntry> streamCache_;
     std::unordered_map<std::uint64_t, DeviceState> deviceStates_;
     std::uint64_t currentDeviceId_{ 0 };
     PlaybackBackend backend_{ PlaybackBackend::None };
+    std::wstring primaryAlias_{};
+    std::wstring secondaryAlias_{};
+    std::wstring activeAlias_{};
+    PlaybackHooks playbackHooks_{};
+    std::unordered_map<std::uint64_t, PlaybackSlot> playbackSlots_;
+    PreloadedTrack preload_{};
     std::int32_t mediaType_{ 1 };
     std::string selectedKey_;
     PlaybackMode mode_{ PlaybackMode::None };
@@ -335,8 +967,7 @@ private:
     std::size_t adIndex_{ 0 };
     std::size_t songsSinceAd_{ 0 };
     bool previousWasSong_{ false };
-    std::vector<std::size_t> shuffleHistory_{};
-    std::size_t shuffleCursor_{ 0 };
+    ShuffleOrder shuffle_{};
 
     Position emitterPosition_{};
     Position playerPosition_{};
@@ -350,9 +981,44 @@ private:
     bool trackStartValid_{ false };
     std::filesystem::path streamWrapperTempPath_;
     std::atomic<bool> playInterruptRequested_{ false };
-    mutable std::mutex pendingPositionMutex_{};
-    PendingPositionSample pendingPositionSample_{};
+    std::array<PositionMailboxSlot, kPositionMailboxSlots> positionMailbox_{};
+    std::array<std::uint32_t, kPositionMailboxSlots> positionMailboxApplied_{};
+    std::atomic<bool> positionMailboxActive_{ false };
+    EngineStats stats_{};
+    std::chrono::steady_clock::time_point nextStatsLogTime_{};
+    // watch_config: the INI's write time as last loaded, and when the worker next looks at it.
+    long long configWriteTime_{ 0 };
+    std::chrono::steady_clock::time_point nextConfigCheckTime_{};
     std::atomic<bool> pendingPositionDirty_{ false };
     bool sessionStateDirty_{ false };
     std::chrono::steady_clock::time_point lastSessionSaveTime_{};
+    std::chrono::steady_clock::time_point lastSessionPositionSaveTime_{};
+    std::unordered_set<std::uint64_t> sessionDirtyDevices_{};
+    bool sessionFullRebuildPending_{ true };
+    std::atomic<std::shared_ptr<const StatusSnapshot>> statusSnapshot_{};
+    std::unordered_set<std::uint64_t> statusDirtyDevices_{};
+    bool statusFullRebuildPending_{ true };
+    std::map<std::uint64_t, SessionDeviceRecord> sessionRecords_{};
+
+    std::mutex sessionWriterMutex_;
+    std::condition_variable sessionWriterCv_;
+    std::thread sessionWriterThread_;
+    bool sessionWriterRunning_{ false };
+    bool sessionWriterStop_{ false };
+    std::optional<SessionWriteJob> pendingSessionWrite_{};
+    std::optional<StreamCacheWriteJob> pendingStreamCacheWrite_{};
+    std::map<std::uint64_t, std::string> sessionEncodedDevices_{};
+    std::string sessionLastPayload_{};
+    std::uint64_t sessionWriteGeneration_{ 0 };
+    std::uint64_t sessionWriteCompleted_{ 0 };
+    bool sessionLastWriteOk_{ true };
+    std::atomic<bool> sessionWriteFailed_{ false };
+
+    // Stream probe pool: up to kMaxParallelStreamProbes threads, started by the first probe and
+    // joined in shutdown(). Probe threads never take the engine mutex.
+    std::mutex streamProbeMutex_;
+    std::condition_variable streamProbeCv_;
+    std::deque<std::function<void()>> streamProbeJobs_;
+    std::vector<std::thread> streamProbeThreads_;
+    bool streamProbeStop_{ false };
 };
@@ -0,0 +1,109 @@
+#include "track_list.h"
+
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+TrackList::TrackList(std::filesystem::path directory, TrackKind kind) :
+    directory_(std::move(directory)),
+    kind_(kind)
+{
+}
+
+void TrackList::reserve(std::size_t count, std::size_t nameChars)
+{
+    records_.reserve(count);
+    names_.reserve(nameChars);
+    lowerNames_.reserve(nameChars);
+}
+
+void TrackList::append(std::wstring_view fileName, std::string_view fileNameUtf8)
+{
+    Record record;
+    record.nameOffset = static_cast<std::uint32_t>(names_.size());
+    record.nameLength = static_cast<std::uint32_t>(fileName.size());
+    names_.append(fileName);
+
+    record.lowerOffset = static_cast<std::uint32_t>(lowerNames_.size());
+    record.lowerLength = static_cast<std::uint32_t>(fileNameUtf8.size());
+    for (const char c : fileNameUtf8) {
+        lowerNames_.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+
+    // Same rule as std::filesystem::path::stem(): a leading dot is part of the name.
+    const std::size_t dot = fileNameUtf8.rfind('.');
+    record.stemLength = (dot == std::string_view::npos || dot == 0) ? record.lowerLength : static_cast<std::uint32_t>(dot);
+    records_.push_back(record);
+}
+
+void TrackList::finalize()
+{
+    byLowerName_.resize(records_.size());
+    for (std::uint32_t i = 0; i < byLowerName_.size(); ++i) {
+        byLowerName_[i] = i;
+    }
+    byLowerStem_ = byLowerName_;
+
+    // Stable sorts keep equal names in list order, so lower_bound finds the lowest matching index.
+    std::stable_sort(byLowerName_.begin(), byLowerName_.end(), [this](std::uint32_t a, std::uint32_t b) {
+        return lowerFileName(a) < lowerFileName(b);
+    });
+    std::stable_sort(byLowerStem_.begin(), byLowerStem_.end(), [this](std::uint32_t a, std::uint32_t b) {
+        return lowerStem(a) < lowerStem(b);
+    });
+}
+
+std::filesystem::path TrackList::operator[](std::size_t index) const
+{
+    return directory_ / std::filesystem::path(std::wstring(fileName(index)));
+}
+
+std::wstring_view TrackList::fileName(std::size_t index) const
+{
+    const Record& record = records_[index];
+    return std::wstring_view(names_).substr(record.nameOffset, record.nameLength);
+}
+
+std::string_view TrackList::lowerFileName(std::size_t index) const
+{
+    const Record& record = records_[index];
+    return std::string_view(lowerNames_).substr(record.lowerOffset, record.lowerLength);
+}
+
+std::string_view TrackList::lowerStem(std::size_t index) const
+{
+    const Record& record = records_[index];
+    return std::string_view(lowerNames_).substr(record.lowerOffset, record.stemLength);
+}
+
+std::optional<std::size_t> TrackList::findByFileName(std::string_view lowerName) const
+{
+    return findIn(byLowerName_, lowerName, false);
+}
+
+std::optional<std::size_t> TrackList::findByFileNameOrStem(std::string_view lowerName) const
+{
+    const auto byName = findIn(byLowerName_, lowerName, false);
+    const auto byStem = findIn(byLowerStem_, lowerName, true);
+    if (byName.has_value() && byStem.has_value()) {
+        return std::min(*byName, *byStem);
+    }
+    return byName.has_value() ? byName : byStem;
+}
+
+std::optional<std::size_t> TrackList::findIn(
+    const std::vector<std::uint32_t>& sortedIndex,
+    std::string_view lowerName,
+    bool byStem) const
+{
+    const auto keyOf = [this, byStem](std::uint32_t index) {
+        return byStem ? lowerStem(index) : lowerFileName(index);
+    };
+    const auto it = std::lower_bound(sortedIndex.begin(), sortedIndex.end(), lowerName, [&keyOf](std::uint32_t index, std::string_view needle) {
+        return keyOf(index) < needle;
+    });
+    if (it == sortedIndex.end() || keyOf(*it) != lowerName) {
+        return std::nullopt;
+    }
+    return *it;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class TrackKind : std::uint8_t
+{
+    Song,
+    Transition,
+    Ad
+};
+
+// One channel's songs, transitions or ads. File names are packed into a single UTF-16 arena and
+// stored relative to the channel directory, so a large library holds each root prefix once and
+// costs a handful of allocations per list. Lowercase names and stems are computed once at build
+// time and kept in sorted indexes for name lookups.
+class TrackList
+{
+public:
+    TrackList() = default;
+    TrackList(std::filesystem::path directory, TrackKind kind);
+
+    void reserve(std::size_t count, std::size_t nameChars);
+    // Appends in list order; call finalize() once every name has been added.
+    void append(std::wstring_view fileName, std::string_view fileNameUtf8);
+    void finalize();
+
+    std::size_t size() const { return records_.size(); }
+    bool empty() const { return records_.empty(); }
+    TrackKind kind() const { return kind_; }
+    const std::filesystem::path& directory() const { return directory_; }
+
+    // Full path of the track; built on demand, so only call it for tracks about to be opened.
+    std::filesystem::path operator[](std::size_t index) const;
+    std::wstring_view fileName(std::size_t index) const;
+    std::string_view lowerFileName(std::size_t index) const;
+    std::string_view lowerStem(std::size_t index) const;
+
+    // Lowest index whose lowercase file name (or stem) equals the lowercase needle.
+    std::optional<std::size_t> findByFileName(std::string_view lowerName) const;
+    std::optional<std::size_t> findByFileNameOrStem(std::string_view lowerName) const;
+
+private:
+    struct Record
+    {
+        std::uint32_t nameOffset{ 0 };
+        std::uint32_t nameLength{ 0 };
+        std::uint32_t lowerOffset{ 0 };
+        std::uint32_t lowerLength{ 0 };
+        std::uint32_t stemLength{ 0 };
+    };
+
+    std::optional<std::size_t> findIn(
+        const std::vector<std::uint32_t>& sortedIndex,
+        std::string_view lowerName,
+        bool byStem) const;
+
+    std::filesystem::path directory_;
+    TrackKind kind_{ TrackKind::Song };
+    std::wstring names_;
+    std::string lowerNames_;
+    std::vector<Record> records_;
+    std::vector<std::uint32_t> byLowerName_;
+    std::vector<std::uint32_t> byLowerStem_;
+};